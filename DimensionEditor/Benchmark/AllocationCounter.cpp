@@ -0,0 +1,65 @@
+﻿#include "AllocationCounter.hpp"
+#include <cstdlib>
+#include <new>
+
+#ifdef DIMENSION_EDITOR_COUNT_ALLOCATIONS
+
+namespace
+{
+	// スレッドごとに数えるので、確保のたびの同期は要らない
+	thread_local uint64 t_allocationCount = 0;
+}
+
+namespace Benchmark
+{
+	uint64 GetAllocationCount() noexcept
+	{
+		return t_allocationCount;
+	}
+}
+
+// 配列版と nothrow 版の既定の実装は、これらを呼ぶ
+void* operator new(const std::size_t size)
+{
+	++t_allocationCount;
+
+	for (;;)
+	{
+		if (void* p = std::malloc(size ? size : 1))
+		{
+			return p;
+		}
+
+		if (const std::new_handler handler = std::get_new_handler())
+		{
+			handler();
+		}
+		else
+		{
+			throw std::bad_alloc{};
+		}
+	}
+}
+
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+	std::free(p);
+}
+
+#else
+
+// 通常の構成では operator new を置き換えない（出荷する実行ファイルの確保に手を加えない）
+namespace Benchmark
+{
+	uint64 GetAllocationCount() noexcept
+	{
+		return 0;
+	}
+}
+
+#endif
@@ -0,0 +1,31 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+
+namespace Benchmark
+{
+	// 確保の回数を数えるか（Instrument 構成で DIMENSION_EDITOR_COUNT_ALLOCATIONS を定義したときだけ）
+#ifdef DIMENSION_EDITOR_COUNT_ALLOCATIONS
+	inline constexpr bool CountsAllocations = true;
+#else
+	inline constexpr bool CountsAllocations = false;
+#endif
+
+	// 呼び出したスレッドで、これまでに operator new が呼ばれた回数（CountsAllocations が false なら常に 0）
+	// （AllocationCounter.cpp がグローバルな operator new を置き換えて数える。アラインメントを指定する版は数えない）
+	[[nodiscard]]
+	uint64 GetAllocationCount() noexcept;
+
+	// 生成してからの、このスレッドでの確保の回数を数える（1フレームの描画などを囲んで使う）
+	class AllocationScope
+	{
+	public:
+		AllocationScope() noexcept
+			: m_start{ GetAllocationCount() } {}
+
+		[[nodiscard]]
+		uint64 count() const noexcept { return (GetAllocationCount() - m_start); }
+
+	private:
+		uint64 m_start;
+	};
+}
@@ -0,0 +1,76 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include "SyntheticDimension.hpp"
+
+namespace Benchmark
+{
+	// 1つの計測結果
+	struct BenchmarkResult
+	{
+		String name;
+		size_t workerCount = 1;
+		double medianMs = 0.0;
+		double minMs = 0.0;
+		double maxMs = 0.0;
+
+		// 1回の計測で行った処理の数（1件あたりの時間 = medianMs / operationCount）
+		size_t operationCount = 1;
+	};
+
+	// 計測した所要時間（ミリ秒）から結果を作る
+	inline BenchmarkResult MakeResult(const String& name, Array<double> samples, const size_t operationCount = 1)
+	{
+		if (samples.isEmpty())
+		{
+			return{ .name = name, .operationCount = operationCount };
+		}
+
+		samples.sort();
+
+		return{
+			.name = name,
+			.workerCount = 1,
+			.medianMs = samples[samples.size() / 2],
+			.minMs = samples.front(),
+			.maxMs = samples.back(),
+			.operationCount = operationCount,
+		};
+	}
+
+	// fn を iterations 回実行し、所要時間の中央値・最小値・最大値を返す
+	template <class Fn>
+	BenchmarkResult Measure(const String& name, const size_t iterations, Fn&& fn, const size_t operationCount = 1)
+	{
+		Array<double> samples;
+
+		for (size_t i = 0; i < iterations; ++i)
+		{
+			const Stopwatch stopwatch{ StartImmediately::Yes };
+			fn();
+			samples.push_back(stopwatch.msF());
+		}
+
+		return MakeResult(name, std::move(samples), operationCount);
+	}
+
+	// DimensionLoader::LoadRooms をワーカー数 1, 2, 4, ... , 論理コア数 で計測し、結果をログに出力する
+	Array<BenchmarkResult> RunLoaderScaling(const FilePath& dimensionPath, size_t iterations = 5);
+
+	// 全オブジェクトの概要の取得を、JSON::Load による完全なパースと JsonHeaderScanner で比較し、結果をログに出力する
+	Array<BenchmarkResult> RunMetadataScan(const FilePath& dimensionPath, size_t iterations = 5);
+
+	// json の保存を JSON::save と JsonStreamWriter で比較し（出力が一致するかも確認する）、結果をログに出力する
+	Array<BenchmarkResult> RunJsonWriter(const JSON& json, size_t iterations = 5);
+
+	// 文書の読み込み・書き出し・フィールドの読み出しを、JSON と型付きの構造体（TypedObjects）で比較し、メモリの見積もりをログに出力する
+	// （paths はファイル名から文書の型を決めるために使う）
+	Array<BenchmarkResult> RunTypedModel(const Array<FilePath>& paths, const Array<JSON>& documents, size_t iterations = 5);
+
+	// workDirectory に合成した次元を生成し、次元の読み込み・テンプレート生成・アクションの変換・保存を計測する
+	// （バージョン間の比較用。結果は ToJSON で機械可読な形にして保存する）
+	Array<BenchmarkResult> RunSuite(const FilePath& workDirectory, const SyntheticDimension::Options& options, size_t iterations = 5);
+
+	// 計測結果と生成条件を JSON にする
+	[[nodiscard]]
+	JSON ToJSON(const Array<BenchmarkResult>& results, const SyntheticDimension::Options& options, size_t iterations);
+}
@@ -0,0 +1,76 @@
+﻿#include "Benchmark.hpp"
+#include "../Model/DimensionLoader.hpp"
+
+namespace
+{
+	Array<size_t> MakeWorkerCounts()
+	{
+		const size_t concurrency = Max<size_t>(Threading::GetConcurrency(), 1);
+
+		Array<size_t> counts;
+		for (size_t n = 1; n < concurrency; n *= 2)
+		{
+			counts.push_back(n);
+		}
+		counts.push_back(concurrency);
+
+		return counts;
+	}
+}
+
+namespace Benchmark
+{
+	Array<BenchmarkResult> RunLoaderScaling(const FilePath& dimensionPath, size_t iterations)
+	{
+		Array<BenchmarkResult> results;
+
+		if (not FileSystem::IsDirectory(dimensionPath) || iterations == 0)
+		{
+			return results;
+		}
+
+		// ウォームアップ（OSのファイルキャッシュを温める）
+		const Array<RoomModel> warmup = DimensionLoader::LoadRooms(dimensionPath, 1);
+
+		size_t objectCount = 0;
+		for (const auto& room : warmup)
+		{
+			objectCount += room.objects.size();
+		}
+
+		Logger << U"[Benchmark] LoadRooms: {} rooms, {} objects"_fmt(warmup.size(), objectCount);
+
+		for (const size_t workerCount : MakeWorkerCounts())
+		{
+			Array<double> samples;
+
+			for (size_t i = 0; i < iterations; ++i)
+			{
+				const Stopwatch stopwatch{ StartImmediately::Yes };
+				const Array<RoomModel> rooms = DimensionLoader::LoadRooms(dimensionPath, workerCount);
+				samples.push_back(stopwatch.msF());
+			}
+
+			samples.sort();
+
+			results.push_back({
+				.name = U"LoadRooms",
+				.workerCount = workerCount,
+				.medianMs = samples[samples.size() / 2],
+				.minMs = samples.front(),
+				.maxMs = samples.back(),
+			});
+		}
+
+		const double baselineMs = results.front().medianMs;
+
+		for (const auto& result : results)
+		{
+			const double speedup = (0.0 < result.medianMs) ? (baselineMs / result.medianMs) : 0.0;
+			Logger << U"[Benchmark] workers={:>2}  median={:.2f}ms  min={:.2f}ms  max={:.2f}ms  speedup=x{:.2f}"_fmt(
+				result.workerCount, result.medianMs, result.minMs, result.maxMs, speedup);
+		}
+
+		return results;
+	}
+}
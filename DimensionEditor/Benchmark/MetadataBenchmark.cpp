@@ -0,0 +1,71 @@
+﻿#include "Benchmark.hpp"
+#include "../Model/DimensionLoader.hpp"
+#include "../Model/JsonHeaderScanner.hpp"
+
+namespace Benchmark
+{
+	Array<BenchmarkResult> RunMetadataScan(const FilePath& dimensionPath, size_t iterations)
+	{
+		Array<BenchmarkResult> results;
+
+		if (not FileSystem::IsDirectory(dimensionPath) || iterations == 0)
+		{
+			return results;
+		}
+
+		Array<FilePath> paths;
+		for (const auto& room : DimensionLoader::LoadRooms(dimensionPath))
+		{
+			for (const auto& object : room.objects)
+			{
+				paths.push_back(FileSystem::PathAppend(FileSystem::PathAppend(dimensionPath, room.name), object.fileName));
+			}
+		}
+
+		Logger << U"[Benchmark] Metadata: {} objects"_fmt(paths.size());
+
+		// ウォームアップ（OSのファイルキャッシュを温める）
+		for (const auto& path : paths)
+		{
+			(void)JsonHeaderScanner::ScanFile(path);
+		}
+
+		// 比較のため、どちらも同じ3つの値を取り出す
+		size_t found = 0;
+
+		results.push_back(Measure(U"JSON::Load", iterations, [&]()
+			{
+				for (const auto& path : paths)
+				{
+					const JSON json = JSON::Load(path);
+
+					if (json && json[U"name"].isString() && (json[U"type"].isString() || json[U"hotspots"].isArray()))
+					{
+						++found;
+					}
+				}
+			}));
+
+		results.push_back(Measure(U"JsonHeaderScanner", iterations, [&]()
+			{
+				for (const auto& path : paths)
+				{
+					if (const auto metadata = JsonHeaderScanner::ScanFile(path); metadata && (not metadata->name.isEmpty()))
+					{
+						++found;
+					}
+				}
+			}));
+
+		const double baselineMs = results.front().medianMs;
+
+		for (const auto& result : results)
+		{
+			const double speedup = (0.0 < result.medianMs) ? (baselineMs / result.medianMs) : 0.0;
+			Logger << U"[Benchmark] {:<18}  median={:.2f}ms  min={:.2f}ms  max={:.2f}ms  speedup=x{:.2f}"_fmt(
+				result.name, result.medianMs, result.minMs, result.maxMs, speedup);
+		}
+
+		return results;
+	}
+}
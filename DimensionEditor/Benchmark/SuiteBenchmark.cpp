@@ -0,0 +1,261 @@
+﻿#include "Benchmark.hpp"
+#include "../Model/DimensionModel.hpp"
+#include "../Model/DimensionIndex.hpp"
+#include "../Controller/EditorDrafts.hpp"
+#include "../Model/SchemaRegistry.hpp"
+#include "../Model/PersistentJson.hpp"
+#include "../Model/TemplateService.hpp"
+
+namespace
+{
+	// テンプレート生成は1回が短いので、全スキーマをこの回数だけ繰り返したものを1回の計測とする
+	constexpr size_t TemplateRepeatCount = 100;
+
+	// 次元内の全オブジェクトのファイルパス
+	Array<FilePath> GetObjectPaths(const DimensionModel& model)
+	{
+		Array<FilePath> paths;
+
+		for (const auto& room : model.getRooms())
+		{
+			for (const auto& object : room.objects)
+			{
+				paths.push_back(model.getCurrentDimensionPath() + room.name + U"/" + object.fileName);
+			}
+		}
+
+		return paths;
+	}
+
+	// オブジェクトの "hotspot" / "hotspots" が持つアクション
+	void CollectActions(const JSON& object, Array<JSON>& actions)
+	{
+		if (object.hasElement(U"hotspot") && object[U"hotspot"].hasElement(U"action"))
+		{
+			actions.push_back(object[U"hotspot"][U"action"]);
+		}
+
+		if (object.hasElement(U"hotspots") && object[U"hotspots"].isArray())
+		{
+			for (const auto& hotspot : object[U"hotspots"].arrayView())
+			{
+				if (hotspot.hasElement(U"action"))
+				{
+					actions.push_back(hotspot[U"action"]);
+				}
+			}
+		}
+	}
+}
+
+namespace Benchmark
+{
+	Array<BenchmarkResult> RunSuite(const FilePath& workDirectory, const SyntheticDimension::Options& options, size_t iterations)
+	{
+		Array<BenchmarkResult> results;
+
+		if (iterations == 0)
+		{
+			return results;
+		}
+
+		const FilePath dimensionPath = FileSystem::PathAppend(workDirectory, U"SyntheticDimension");
+		const size_t fileCount = SyntheticDimension::CountFiles(options);
+
+		{
+			const Stopwatch stopwatch{ StartImmediately::Yes };
+
+			if (not SyntheticDimension::Generate(dimensionPath, options))
+			{
+				Logger << U"🚨 [Benchmark] Failed to generate a synthetic dimension in " << dimensionPath;
+				return results;
+			}
+
+			results.push_back(MakeResult(U"SyntheticDimension::Generate", { stopwatch.msF() }, fileCount));
+		}
+
+		// DimensionModel::Load（索引なし → 索引あり）
+		{
+			const FilePath indexPath = DimensionIndex::GetIndexPath(dimensionPath + U"/");
+			Array<double> coldSamples;
+			Array<double> indexedSamples;
+
+			for (size_t i = 0; i < iterations; ++i)
+			{
+				FileSystem::Remove(indexPath);
+				{
+					DimensionModel model;
+					const Stopwatch stopwatch{ StartImmediately::Yes };
+					model.Load(dimensionPath + U"/");
+					coldSamples.push_back(stopwatch.msF());
+				}
+				{
+					DimensionModel model;
+					const Stopwatch stopwatch{ StartImmediately::Yes };
+					model.Load(dimensionPath + U"/");
+					indexedSamples.push_back(stopwatch.msF());
+				}
+			}
+
+			results.push_back(MakeResult(U"DimensionModel::Load (no index)", std::move(coldSamples), fileCount));
+			results.push_back(MakeResult(U"DimensionModel::Load (indexed)", std::move(indexedSamples), fileCount));
+		}
+
+		// テンプレート生成（登録されている全スキーマ）。スキーマの走査と、キャッシュした雛形のコピー・共有を比べる
+		results.push_back(Measure(U"TemplateService::BuildPrototype", iterations, [&]()
+			{
+				for (size_t repeat = 0; repeat < TemplateRepeatCount; ++repeat)
+				{
+					for (const auto& schema : SchemaRegistry::DocumentSchemas())
+					{
+						const JSON json = TemplateService::BuildPrototype(schema);
+					}
+				}
+			}, (TemplateRepeatCount * SchemaRegistry::DocumentSchemas().size())));
+
+		results.push_back(Measure(U"TemplateService::Create", iterations, [&]()
+			{
+				for (size_t repeat = 0; repeat < TemplateRepeatCount; ++repeat)
+				{
+					for (const auto& schema : SchemaRegistry::DocumentSchemas())
+					{
+						const JSON json = TemplateService::Create(schema.handle);
+					}
+				}
+			}, (TemplateRepeatCount * SchemaRegistry::DocumentSchemas().size())));
+
+		results.push_back(Measure(U"TemplateService::PrototypeNode", iterations, [&]()
+			{
+				for (size_t repeat = 0; repeat < TemplateRepeatCount; ++repeat)
+				{
+					for (const auto& schema : SchemaRegistry::DocumentSchemas())
+					{
+						// 名前だけを変えた複製（変更した経路のノードだけを作り直す）
+						const PersistentJson::NodePtr node = PersistentJson::Assign(TemplateService::PrototypeNode(schema.handle),
+							{ String{ U"name" } }, PersistentJson::FromJSON(JSON(U"Object")));
+					}
+				}
+			}, (TemplateRepeatCount * SchemaRegistry::DocumentSchemas().size())));
+
+		DimensionModel model;
+		model.Load(dimensionPath + U"/");
+
+		const Array<FilePath> objectPaths = GetObjectPaths(model);
+		Array<JSON> documents;
+		Array<JSON> actions;
+
+		for (const auto& path : objectPaths)
+		{
+			documents.push_back(JSON::Load(path));
+			CollectActions(documents.back(), actions);
+		}
+
+		// JSON → 下書き（エディタでアクションを開くとき）
+		results.push_back(Measure(U"BuildDraftFromActionJson", iterations, [&]()
+			{
+				for (const auto& action : actions)
+				{
+					ActionDraft draft;
+					EditorDrafts::BuildDraftFromActionJson(draft, action);
+				}
+			}, actions.size()));
+
+		// 下書き → JSON（エディタでアクションを確定するとき）
+		Array<ActionDraft> drafts(actions.size());
+		for (size_t i = 0; i < actions.size(); ++i)
+		{
+			EditorDrafts::BuildDraftFromActionJson(drafts[i], actions[i]);
+		}
+
+		results.push_back(Measure(U"BuildActionJson", iterations, [&]()
+			{
+				for (const auto& draft : drafts)
+				{
+					const JSON json = EditorDrafts::BuildActionJson(draft);
+				}
+			}, drafts.size()));
+
+		// 編集履歴の木（キーと識別子は Atom で持つ）
+		results.push_back(Measure(U"PersistentJson::FromJSON", iterations, [&]()
+			{
+				for (const auto& document : documents)
+				{
+					const PersistentJson::NodePtr root = PersistentJson::FromJSON(document);
+				}
+			}, documents.size()));
+
+		{
+			PersistentJson::Footprint total;
+
+			for (const auto& document : documents)
+			{
+				const PersistentJson::Footprint footprint = PersistentJson::MeasureFootprint(PersistentJson::FromJSON(document));
+				total.nodeCount += footprint.nodeCount;
+				total.memberCount += footprint.memberCount;
+				total.bytes += footprint.bytes;
+				total.stringKeyBytes += footprint.stringKeyBytes;
+			}
+
+			const Atom::Stats atomStats = Atom::GetStats();
+
+			Logger << U"[Benchmark] PersistentJson footprint: {} nodes, {} members, {:.1f} KiB (+{:.1f} KiB with String keys), atom table {} atoms / {:.1f} KiB"_fmt(
+				total.nodeCount, total.memberCount, (total.bytes / 1024.0), (total.stringKeyBytes / 1024.0), atomStats.atomCount, (atomStats.bytes / 1024.0));
+		}
+
+		// 型付きの構造体（TypedObjects）
+		results.append(RunTypedModel(objectPaths, documents, iterations));
+
+		// 保存（エディタと同じく SaveQueue で書き出し、すべて書き終わるまで）
+		results.push_back(Measure(U"DimensionModel::saveJsonForPath", iterations, [&]()
+			{
+				for (size_t i = 0; i < objectPaths.size(); ++i)
+				{
+					model.saveJsonForPath(objectPaths[i], documents[i]);
+				}
+
+				model.flushSaves();
+			}, objectPaths.size()));
+
+		for (const auto& result : results)
+		{
+			const double perOperationUs = (0 < result.operationCount) ? (result.medianMs * 1000.0 / result.operationCount) : 0.0;
+			Logger << U"[Benchmark] {:<34}  median={:.2f}ms  min={:.2f}ms  max={:.2f}ms  n={}  {:.2f}us/op"_fmt(
+				result.name, result.medianMs, result.minMs, result.maxMs, result.operationCount, perOperationUs);
+		}
+
+		return results;
+	}
+
+	JSON ToJSON(const Array<BenchmarkResult>& results, const SyntheticDimension::Options& options, const size_t iterations)
+	{
+		JSON json;
+		json[U"format"] = U"DimensionEditor.Benchmark";
+		json[U"version"] = 1;
+		json[U"timestamp"] = DateTime::Now().format();
+		json[U"concurrency"] = Threading::GetConcurrency();
+		json[U"iterations"] = iterations;
+
+		json[U"options"][U"rooms"] = options.roomCount;
+		json[U"options"][U"focusables_per_room"] = options.focusablesPerRoom;
+		json[U"options"][U"hotspots_per_object"] = options.hotspotsPerObject;
+		json[U"options"][U"action_depth"] = options.actionDepth;
+		json[U"options"][U"action_width"] = options.actionWidth;
+
+		Array<JSON> entries;
+
+		for (const auto& result : results)
+		{
+			JSON entry;
+			entry[U"name"] = result.name;
+			entry[U"workers"] = result.workerCount;
+			entry[U"operations"] = result.operationCount;
+			entry[U"median_ms"] = result.medianMs;
+			entry[U"min_ms"] = result.minMs;
+			entry[U"max_ms"] = result.maxMs;
+			entries.push_back(entry);
+		}
+
+		json[U"results"] = entries;
+		return json;
+	}
+}
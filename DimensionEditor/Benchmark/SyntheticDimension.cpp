@@ -0,0 +1,203 @@
+﻿#include "SyntheticDimension.hpp"
+#include "../Model/JsonStreamWriter.hpp"
+
+namespace
+{
+	String RoomName(const size_t index)
+	{
+		return U"Room{:0>3}"_fmt(index);
+	}
+
+	// 葉のアクション（種類は seed で巡回させる）
+	JSON MakeLeafAction(const size_t seed)
+	{
+		JSON action;
+
+		switch (seed % 4)
+		{
+		case 0:
+			action[U"type"] = U"ShowText";
+			action[U"file"] = U"text/message_{}.txt"_fmt(seed);
+			break;
+		case 1:
+			action[U"type"] = U"GiveItem";
+			action[U"item"] = U"item_{}"_fmt(seed);
+			break;
+		case 2:
+			action[U"type"] = U"SetFlag";
+			action[U"flag"] = U"flag_{}"_fmt(seed);
+			action[U"value"] = ((seed % 2) == 0);
+			break;
+		default:
+			action[U"type"] = U"ChangeDimension";
+			action[U"target"] = U"dimension_{}"_fmt(seed);
+			break;
+		}
+
+		return action;
+	}
+
+	JSON MakeHotspot(const SyntheticDimension::Options& options, const size_t seed)
+	{
+		JSON hotspot;
+		hotspot[U"grid_pos"] = U"{}{}-{}{}"_fmt(static_cast<char32>(U'A' + (seed % 8)), (seed % 6 + 1), static_cast<char32>(U'A' + (seed % 8)), (seed % 6 + 2));
+		hotspot[U"action"] = SyntheticDimension::MakeActionTree(options, options.actionDepth, seed);
+		return hotspot;
+	}
+
+	JSON MakeObject(const SyntheticDimension::Options& options, const String& name, const size_t seed)
+	{
+		JSON object;
+		object[U"name"] = name;
+		object[U"type"] = U"Whiteboard";
+		object[U"default_state"][U"asset"] = U"asset_{}"_fmt(seed);
+		object[U"default_state"][U"grid_pos"] = U"C3-D4";
+
+		Array<JSON> states;
+		states.push_back(JSON{ { U"condition_flag", U"flag_{}"_fmt(seed) }, { U"asset", U"asset_{}_on"_fmt(seed) } });
+		object[U"states"] = states;
+
+		if (0 < options.hotspotsPerObject)
+		{
+			object[U"hotspot"] = MakeHotspot(options, seed);
+		}
+
+		Array<JSON> hotspots;
+		for (size_t i = 0; i < options.hotspotsPerObject; ++i)
+		{
+			hotspots.push_back(MakeHotspot(options, (seed * 31 + i)));
+		}
+		object[U"hotspots"] = hotspots;
+
+		return object;
+	}
+
+	JSON MakeRoom(const SyntheticDimension::Options& options, const size_t roomIndex)
+	{
+		JSON room;
+		room[U"background"] = U"bg_{}"_fmt(RoomName(roomIndex));
+
+		JSON transitions;
+		transitions[U"Forward"] = RoomName((roomIndex + 1) % options.roomCount);
+		transitions[U"Back"] = JSON{ { U"to", RoomName((roomIndex + options.roomCount - 1) % options.roomCount) },
+			{ U"condition", U"flag_{}"_fmt(roomIndex) }, { U"scope", U"Dimension" } };
+		room[U"transitions"] = transitions;
+
+		Array<JSON> forcusables;
+		for (size_t i = 0; i < options.focusablesPerRoom; ++i)
+		{
+			forcusables.push_back(JSON{ { U"name", U"Object{:0>3}"_fmt(i) },
+				{ U"default_state", JSON{ { U"asset", U"asset_{}_{}"_fmt(roomIndex, i) } } },
+				{ U"hotspot", JSON{ { U"grid_pos", U"B2-C3" } } },
+				{ U"states", Array<JSON>{} } });
+		}
+		room[U"forcusables"] = forcusables;
+
+		Array<JSON> interactables;
+		interactables.push_back(JSON{ { U"name", U"Door" },
+			{ U"default_state", JSON{ { U"asset", U"door" }, { U"grid_pos", U"E1-F4" } } },
+			{ U"states", Array<JSON>{} },
+			{ U"hotspot", MakeHotspot(options, roomIndex) } });
+		room[U"interactables"] = interactables;
+
+		return room;
+	}
+}
+
+namespace SyntheticDimension
+{
+	JSON MakeActionTree(const Options& options, const size_t depth, const size_t seed)
+	{
+		if ((depth == 0) || (options.actionWidth == 0))
+		{
+			return MakeLeafAction(seed);
+		}
+
+		JSON action;
+
+		switch (seed % 3)
+		{
+		case 0:
+			{
+				action[U"type"] = U"Sequence";
+
+				Array<JSON> actions;
+				for (size_t i = 0; i < options.actionWidth; ++i)
+				{
+					actions.push_back(MakeActionTree(options, (depth - 1), (seed * options.actionWidth + i + 1)));
+				}
+				action[U"actions"] = actions;
+				break;
+			}
+		case 1:
+			{
+				action[U"type"] = U"Conditional";
+				action[U"condition"] = JSON{ { U"type", U"HasItem" }, { U"item", U"item_{}"_fmt(seed) } };
+				action[U"success"] = MakeActionTree(options, (depth - 1), (seed * 2 + 1));
+				action[U"failure"] = MakeActionTree(options, (depth - 1), (seed * 2 + 2));
+				break;
+			}
+		default:
+			{
+				action[U"type"] = U"MultiStep";
+				action[U"id"] = U"step_{}"_fmt(seed);
+
+				Array<JSON> steps;
+				for (size_t i = 0; i < options.actionWidth; ++i)
+				{
+					steps.push_back(MakeActionTree(options, (depth - 1), (seed * options.actionWidth + i + 1)));
+				}
+				action[U"steps"] = steps;
+				action[U"final_action"] = MakeLeafAction(seed + 1);
+				break;
+			}
+		}
+
+		return action;
+	}
+
+	bool Generate(const FilePath& dimensionPath, const Options& options)
+	{
+		if (FileSystem::Exists(dimensionPath) && (not FileSystem::Remove(dimensionPath)))
+		{
+			return false;
+		}
+
+		if (not FileSystem::CreateDirectories(dimensionPath))
+		{
+			return false;
+		}
+
+		JSON rooms;
+
+		for (size_t roomIndex = 0; roomIndex < options.roomCount; ++roomIndex)
+		{
+			const String roomName = RoomName(roomIndex);
+			rooms[roomName] = MakeRoom(options, roomIndex);
+
+			const FilePath roomPath = FileSystem::PathAppend(dimensionPath, roomName);
+			FileSystem::CreateDirectories(roomPath);
+
+			for (size_t i = 0; i < options.focusablesPerRoom; ++i)
+			{
+				const String objectName = U"Object{:0>3}"_fmt(i);
+
+				if (not JsonStreamWriter::Save(MakeObject(options, objectName, (roomIndex * options.focusablesPerRoom + i)),
+					FileSystem::PathAppend(roomPath, objectName + U".json")))
+				{
+					return false;
+				}
+			}
+		}
+
+		JSON connections;
+		connections[U"rooms"] = rooms;
+
+		return JsonStreamWriter::Save(connections, FileSystem::PathAppend(dimensionPath, U"room_connections.json"));
+	}
+
+	size_t CountFiles(const Options& options)
+	{
+		return (1 + options.roomCount * options.focusablesPerRoom);
+	}
+}
@@ -0,0 +1,35 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+
+// ベンチマーク用に、指定した大きさの次元フォルダを生成する
+// 内容は options だけで決まる（同じ options なら、同じバイト列のファイルができる）
+namespace SyntheticDimension
+{
+	struct Options
+	{
+		size_t roomCount = 16;
+
+		// 部屋ごとのオブジェクト（Forcusable）ファイルの数
+		size_t focusablesPerRoom = 8;
+
+		// オブジェクトごとの hotspot の数
+		size_t hotspotsPerObject = 4;
+
+		// アクションの木の深さ（0 なら hotspot ごとに単一のアクション）
+		size_t actionDepth = 3;
+
+		// Sequence / MultiStep が持つ子アクションの数
+		size_t actionWidth = 3;
+	};
+
+	// depth 段の入れ子を持つアクションの木を作る（葉の数はおよそ actionWidth ^ depth）
+	[[nodiscard]]
+	JSON MakeActionTree(const Options& options, size_t depth, size_t seed);
+
+	// dimensionPath に次元を生成する（既存のフォルダは削除してから作る）
+	bool Generate(const FilePath& dimensionPath, const Options& options);
+
+	// 生成される JSON ファイルの数
+	[[nodiscard]]
+	size_t CountFiles(const Options& options);
+}
@@ -0,0 +1,168 @@
+﻿#include "Benchmark.hpp"
+#include "../Model/TypedObjects.hpp"
+
+namespace
+{
+	// スキーマのない文書（合成した次元のオブジェクトなど）は、共通のプロパティの型で読む
+	Optional<TypedDocument> BindAny(const StringView schemaName, const JSON& json)
+	{
+		if (auto document = TypedObjects::BindDocument(schemaName, json))
+		{
+			return document;
+		}
+
+		if (auto focusable = TypedObjects::BindFocusable(json))
+		{
+			return TypedDocument{ .data = std::move(*focusable) };
+		}
+
+		return none;
+	}
+
+	// エディタが Forcusable の編集ウィンドウを開くときと同じフィールドを JSON から読む
+	size_t ReadFieldsFromJSON(const JSON& json)
+	{
+		size_t length = 0;
+		length += json[U"name"].getOpt<String>().value_or(U"").size();
+		length += json[U"default_state"][U"asset"].getOpt<String>().value_or(U"").size();
+		length += json[U"hotspot"][U"grid_pos"].getOpt<String>().value_or(U"").size();
+
+		if (json.hasElement(U"states"))
+		{
+			for (const auto& state : json[U"states"].arrayView())
+			{
+				length += state[U"condition_flag"].getOpt<String>().value_or(U"").size();
+				length += state[U"asset"].getOpt<String>().value_or(U"").size();
+			}
+		}
+
+		return length;
+	}
+
+	// 同じフィールドを型付きのデータから読む
+	size_t ReadFieldsFromTyped(const FocusableData& focusable)
+	{
+		size_t length = 0;
+		length += focusable.name.size();
+		length += focusable.defaultState.asset.size();
+		length += focusable.hotspot.gridPos.size();
+
+		if (focusable.states)
+		{
+			for (const auto& state : *focusable.states)
+			{
+				length += state.conditionFlag.size();
+				length += state.asset.size();
+			}
+		}
+
+		return length;
+	}
+}
+
+namespace Benchmark
+{
+	Array<BenchmarkResult> RunTypedModel(const Array<FilePath>& paths, const Array<JSON>& documents, size_t iterations)
+	{
+		Array<BenchmarkResult> results;
+
+		if ((iterations == 0) || (paths.size() != documents.size()))
+		{
+			return results;
+		}
+
+		Array<String> schemaNames;
+
+		for (const auto& path : paths)
+		{
+			schemaNames.push_back(FileSystem::BaseName(path));
+		}
+
+		Array<TypedDocument> typedDocuments;
+
+		// typedDocuments の各要素が documents のどれから読んだものか
+		Array<size_t> sourceIndices;
+
+		for (size_t i = 0; i < documents.size(); ++i)
+		{
+			if (auto document = BindAny(schemaNames[i], documents[i]))
+			{
+				typedDocuments.push_back(std::move(*document));
+				sourceIndices.push_back(i);
+			}
+		}
+
+		results.push_back(Measure(U"TypedObjects::BindDocument", iterations, [&]()
+			{
+				for (size_t i = 0; i < documents.size(); ++i)
+				{
+					const auto document = BindAny(schemaNames[i], documents[i]);
+				}
+			}, documents.size()));
+
+		results.push_back(Measure(U"TypedObjects::ToJSON", iterations, [&]()
+			{
+				for (const auto& document : typedDocuments)
+				{
+					const JSON json = TypedObjects::ToJSON(document);
+				}
+			}, typedDocuments.size()));
+
+		// 編集ウィンドウを開くときのフィールドの読み出し（JSON の検索と、型付きのデータのメンバー参照）
+		size_t jsonLength = 0;
+		size_t typedLength = 0;
+
+		results.push_back(Measure(U"Field reads (JSON)", iterations, [&]()
+			{
+				jsonLength = 0;
+
+				for (const size_t index : sourceIndices)
+				{
+					jsonLength += ReadFieldsFromJSON(documents[index]);
+				}
+			}, sourceIndices.size()));
+
+		results.push_back(Measure(U"Field reads (typed)", iterations, [&]()
+			{
+				typedLength = 0;
+
+				for (const auto& document : typedDocuments)
+				{
+					typedLength += ReadFieldsFromTyped(document.common());
+				}
+			}, typedDocuments.size()));
+
+		if (jsonLength != typedLength)
+		{
+			Logger << U"🚨 [Benchmark] Typed field reads differ from JSON ({} vs {} characters)"_fmt(typedLength, jsonLength);
+		}
+
+		// 書き出した JSON が元の文書と一致するか（unknown に残したキーも含めて戻ること）
+		size_t mismatchCount = 0;
+		size_t unknownCount = 0;
+		size_t jsonBytes = 0;
+		size_t typedBytes = 0;
+
+		for (size_t k = 0; k < typedDocuments.size(); ++k)
+		{
+			const TypedDocument& typed = typedDocuments[k];
+			const JSON& source = documents[sourceIndices[k]];
+
+			jsonBytes += (sizeof(JSON) + JsonBinding::EstimateHeapBytes(source));
+			typedBytes += TypedObjects::EstimateBytes(typed);
+			unknownCount += typed.common().unknown.size();
+
+			if (TypedObjects::ToJSON(typed) != source)
+			{
+				++mismatchCount;
+			}
+		}
+
+		Logger << U"[Benchmark] Typed model: {}/{} documents bound, {} unknown top-level keys, {} round-trip mismatches (missing required properties are written back)"_fmt(
+			typedDocuments.size(), documents.size(), unknownCount, mismatchCount);
+		Logger << U"[Benchmark] Typed model memory: JSON {:.1f} KiB -> typed {:.1f} KiB (estimate, excluding the atom table)"_fmt(
+			(jsonBytes / 1024.0), (typedBytes / 1024.0));
+
+		return results;
+	}
+}
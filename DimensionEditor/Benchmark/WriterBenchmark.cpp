@@ -0,0 +1,51 @@
+﻿#include "Benchmark.hpp"
+#include "../Model/JsonStreamWriter.hpp"
+
+namespace
+{
+	Array<Byte> ReadAll(const FilePath& path)
+	{
+		BinaryReader reader{ path };
+		Array<Byte> bytes(static_cast<size_t>(reader.size()));
+		reader.read(bytes.data(), static_cast<int64>(bytes.size()));
+		return bytes;
+	}
+}
+
+namespace Benchmark
+{
+	Array<BenchmarkResult> RunJsonWriter(const JSON& json, size_t iterations)
+	{
+		Array<BenchmarkResult> results;
+
+		if ((not json) || iterations == 0)
+		{
+			return results;
+		}
+
+		const FilePath directory = FileSystem::GetFolderPath(SpecialFolder::LocalAppData) + U"DimensionEditor/Benchmark/";
+		const FilePath savePath = directory + U"JSON_save.json";
+		const FilePath streamPath = directory + U"JsonStreamWriter.json";
+		FileSystem::CreateDirectories(directory);
+
+		results.push_back(Measure(U"JSON::save", iterations, [&]() { json.save(savePath); }));
+		results.push_back(Measure(U"JsonStreamWriter", iterations, [&]() { JsonStreamWriter::Save(json, streamPath); }));
+
+		const int64 fileSize = FileSystem::FileSize(streamPath);
+		const bool identical = (ReadAll(savePath) == ReadAll(streamPath));
+
+		Logger << U"[Benchmark] JSON writer: {} bytes, output {}"_fmt(fileSize, (identical ? U"identical" : U"DIFFERS"));
+
+		for (const auto& result : results)
+		{
+			const double mbPerSecond = (0.0 < result.medianMs) ? ((fileSize / (1024.0 * 1024.0)) / (result.medianMs / 1000.0)) : 0.0;
+			Logger << U"[Benchmark] {:<18}  median={:.2f}ms  min={:.2f}ms  max={:.2f}ms  {:.1f} MB/s"_fmt(
+				result.name, result.medianMs, result.minMs, result.maxMs, mbPerSecond);
+		}
+
+		FileSystem::Remove(savePath);
+		FileSystem::Remove(streamPath);
+
+		return results;
+	}
+}
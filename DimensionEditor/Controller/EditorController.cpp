@@ -1,17 +1,50 @@
 ﻿#include "EditorController.hpp"
 #include "../Model/DimensionModel.hpp"
+#include "../Model/DimensionPack.hpp"
+#include "../Model/JsonStreamWriter.hpp"
+#include "../Benchmark/Benchmark.hpp"
+#include "../imgui-s3d-wrapper/imgui/DearImGuiAddon.hpp"
 
 namespace
 {
-	enum ActionTypeIndex {
-		ActionType_ShowText = 0,
-		ActionType_GiveItem,
-		ActionType_SetFlag,
-		ActionType_Conditional,
-		ActionType_Sequence,
-		ActionType_MultiStep,
-		ActionType_ChangeDimension
-	};
+	// 条件付きの状態の下書きを組み立てる（Forcusable の状態は座標を持たない）
+	Array<ConditionalStateData> BuildStates(const std::vector<ConditionalStateDraft>& drafts, const bool withGridPos)
+	{
+		Array<ConditionalStateData> states;
+
+		for (const auto& stateDraft : drafts)
+		{
+			ConditionalStateData state{ .conditionFlag = Unicode::FromUTF8(stateDraft.conditionFlagBuffer), .asset = Unicode::FromUTF8(stateDraft.assetBuffer) };
+
+			if (withGridPos)
+			{
+				state.gridPos = Unicode::FromUTF8(stateDraft.gridPosBuffer);
+			}
+
+			states.push_back(std::move(state));
+		}
+
+		return states;
+	}
+
+	// 下書きの内容で interactable を書き換える（下書きにないプロパティは残す）
+	void ApplyInteractableDraft(FocusableData& interactable, const InteractableDraftState& draft)
+	{
+		interactable.name = Unicode::FromUTF8(draft.nameBuffer);
+		interactable.defaultState.asset = Unicode::FromUTF8(draft.defaultStateDraft.assetBuffer);
+		interactable.defaultState.gridPos = Unicode::FromUTF8(draft.defaultStateDraft.gridPosBuffer);
+		interactable.states = BuildStates(draft.states, true);
+		interactable.hotspot = EditorDrafts::BuildHotspot(draft.hotspotDraft);
+	}
+
+	// 下書きの内容で forcusable を書き換える（下書きにないプロパティは残す）
+	void ApplyFocusableDraft(FocusableData& focusable, const ForcusableDraftState& draft)
+	{
+		focusable.name = Unicode::FromUTF8(draft.nameBuffer);
+		focusable.defaultState.asset = Unicode::FromUTF8(draft.defaultStateDraft.assetBuffer);
+		focusable.hotspot.gridPos = Unicode::FromUTF8(draft.hotspotGridPosBuffer);
+		focusable.states = BuildStates(draft.states, false);
+	}
 }
 
 EditorController::EditorController(DimensionModel& model)
@@ -21,6 +54,55 @@ EditorController::EditorController(DimensionModel& model)
 
 void EditorController::update()
 {
+	// ディスク上の変更をModelに反映
+	m_model.update();
+
+	// バックグラウンドで読み込んでいるファイルの完了を確認
+	pollSelectionLoad();
+
+	// 完了した保存の結果を受け取る
+	for (auto& result : m_model.takeSaveResults())
+	{
+		if (result.succeeded)
+		{
+			// 保存した文書は、ディスク上の内容で検証し直す（まだ変更が残っていれば、下でメモリ上の内容に戻る）
+			m_validator.releaseDocument(result.path);
+		}
+
+		if (auto it = m_documents.find(result.path); it != m_documents.end())
+		{
+			if (not result.succeeded)
+			{
+				// 失敗した文書は未保存に戻し、次の保存で必ず書き込む
+				it->second->markSaveFailed();
+			}
+			else if ((it->second != m_selectedDocument) && (not it->second->isDirty()))
+			{
+				// 選択中でない文書は、保存が終わったら閉じる
+				m_documents.erase(it);
+			}
+		}
+
+		m_saveResults[result.path] = std::move(result);
+	}
+
+	updateValidation();
+
+	// 元に戻す・やり直す（テキスト入力中は ImGui 自身の取り消しに任せる）
+	if (KeyControl.pressed() && (not ImGui::GetIO().WantTextInput))
+	{
+		if (KeyZ.down())
+		{
+			undo();
+		}
+		else if (KeyY.down())
+		{
+			redo();
+		}
+	}
+
+	updateDirtyPaths();
+
 	// 今後、キーボードショートカットなどの処理をここに追加
 }
 
@@ -29,244 +111,483 @@ void EditorController::openDimension()
 	const auto result = Dialog::SelectFolder(U"App/data");
 	if (result)
 	{
+		closeDocuments();
 		m_model.Load(result.value());
-		m_selectedPath.clear(); // 選択をリセット
+		openValidation();
 	}
 }
 
 void EditorController::createNewDimension(const String& name, const FilePath& baseDir)
 {
+	closeDocuments();
+
 	// Viewから受け取ったパスと名前をModelに渡す
 	m_model.CreateNew(baseDir, name);
-	m_selectedPath.clear();
+	openValidation();
 }
 
-void EditorController::saveSelectedJson()
+void EditorController::openDimensionPack()
 {
-	m_model.saveJsonForPath(m_selectedPath, m_selectedJsonData);
+	const auto result = Dialog::OpenFile({ FileFilter{ U"Dimension Pack", { String{ DimensionPack::Extension } } } }, U"App/data");
+	if (result)
+	{
+		closeDocuments();
+		m_model.LoadPack(result.value());
+		openValidation();
+	}
 }
 
-void EditorController::addNewHotspot(const HotspotDraftState& hotspotState)
+void EditorController::exportDimensionPack()
 {
-	// UIの状態からJSONデータを組み立てる
-	JSON newHotspotJson = buildJsonFromState(hotspotState);
+	if ((not m_model.isDimensionLoaded()) || m_model.isReadOnly())
+	{
+		return;
+	}
 
-	// Modelにデータの永続化（ファイル保存）を依頼
-	m_model.addHotspot(m_selectedPath, newHotspotJson);
+	// 書き出す前に、編集中の内容をディスクに反映しておく
+	saveAll();
+	m_model.flushSaves();
 
-	// Controllerが持つ現在のJSONデータも更新し、UIに即時反映させる
-	m_selectedJsonData[U"hotspots"].push_back(newHotspotJson);
+	const auto result = Dialog::SaveFile({ FileFilter{ U"Dimension Pack", { String{ DimensionPack::Extension } } } }, U"App/data");
+	if (result)
+	{
+		if (DimensionPack::Pack(m_model.getCurrentDimensionPath(), result.value()))
+		{
+			Logger << U"✅ Exported dimension pack: " << result.value();
+		}
+		else
+		{
+			Logger << U"🚨 Failed to export dimension pack: " << result.value();
+		}
+	}
 }
 
-void EditorController::updateRoomData(const String& roomName, const JSON& newRoomData)
+void EditorController::unpackDimensionPack()
 {
-	if (m_selectedJsonData.hasElement(U"rooms"))
+	const auto packPath = Dialog::OpenFile({ FileFilter{ U"Dimension Pack", { String{ DimensionPack::Extension } } } }, U"App/data");
+	if (not packPath)
 	{
-		m_selectedJsonData[U"rooms"][roomName] = newRoomData;
+		return;
+	}
+
+	const auto baseDir = Dialog::SelectFolder(U"App/data");
+	if (not baseDir)
+	{
+		return;
+	}
+
+	const FilePath dimensionPath = FileSystem::PathAppend(baseDir.value(), FileSystem::BaseName(packPath.value()));
+
+	if (FileSystem::Exists(dimensionPath))
+	{
+		Logger << U"Dimension '{}' already exists."_fmt(dimensionPath);
+		return;
+	}
+
+	if (DimensionPack::Unpack(packPath.value(), dimensionPath))
+	{
+		Logger << U"✅ Unpacked dimension pack: " << dimensionPath;
+
+		// 展開した次元をそのまま開く
+		closeDocuments();
+		m_model.Load(dimensionPath + U"/");
+		openValidation();
+	}
+	else
+	{
+		Logger << U"🚨 Failed to unpack dimension pack: " << packPath.value();
 	}
 }
 
-void EditorController::setSelectedPath(const FilePath& path)
+void EditorController::saveSelectedJson()
 {
-	m_selectedPath = path;
-	// もしパスが空でなく、JSONファイルなら、中身を読み込んで保持する
-	if ((not m_selectedPath.isEmpty()) && (FileSystem::Extension(m_selectedPath) == U"json"))
+	// 読み込みが終わる前は文書がないので、保存するものもない
+	if (m_selectedDocument)
 	{
-		m_selectedJsonData = JSON::Load(m_selectedPath);
+		saveDocument(*m_selectedDocument);
 	}
-	else
+}
+
+void EditorController::saveAll()
+{
+	for (const auto& [path, document] : m_documents)
 	{
-		m_selectedJsonData.clear(); // それ以外の場合はクリア
-	}
-}
-
-JSON EditorController::buildActionJson(const ActionDraft& draft)
-{
-	JSON actionObj;
-	// アクションの種類に応じて分岐
-	switch (draft.typeIndex) {
-	case ActionType_ShowText: // テキストを表示
-		actionObj[U"type"] = U"ShowText";
-		actionObj[U"file"] = Unicode::FromUTF8(draft.fileBuffer);
-		break;
-	case ActionType_GiveItem: // アイテムを入手
-		actionObj[U"type"] = U"GiveItem";
-		actionObj[U"item"] = Unicode::FromUTF8(draft.itemBuffer);
-		break;
-	case ActionType_SetFlag: // フラグを操作
-		actionObj[U"type"] = U"SetFlag";
-		actionObj[U"flag"] = Unicode::FromUTF8(draft.flagBuffer);
-		actionObj[U"value"] = draft.flagValue;
-		break;
-	case ActionType_Conditional: // 条件分岐
-	{
-		actionObj[U"type"] = U"Conditional";
-		JSON conditionObj;
-		if (draft.conditionTypeIndex == 0) // HasItem
+		if (document->isDirty())
 		{
-			conditionObj[U"type"] = U"HasItem";
-			conditionObj[U"item"] = Unicode::FromUTF8(draft.conditionItemBuffer);
+			saveDocument(*document);
 		}
-		else // IsFlagOn
+	}
+}
+
+void EditorController::saveDocument(EditorDocument& document)
+{
+	// 前回保存した内容と同じなら書き込まない
+	if (not document.commitForSave())
+	{
+		Logger << U"Skipped saving unchanged file: " << document.getPath();
+
+		// 保存の結果は届かないので、ここでディスク上の内容での検証に戻す
+		// （戻さないと、編集中に検証したメモリ上の内容が優先され続け、ディスク上の変更が問題の一覧に反映されない）
+		m_validator.releaseDocument(document.getPath());
+	}
+	else
+	{
+		m_model.saveJsonForPath(document.getPath(), document.getJson());
+	}
+
+	updateDirtyPaths();
+}
+
+bool EditorController::isDocumentDirty(const FilePath& path) const
+{
+	if (auto it = m_documents.find(path); it != m_documents.end())
+	{
+		return it->second->isDirty();
+	}
+
+	return false;
+}
+
+void EditorController::updateDirtyPaths()
+{
+	size_t dirtyCount = 0;
+	bool unchanged = true;
+
+	for (const auto& [path, document] : m_documents)
+	{
+		if (document->isDirty())
 		{
-			conditionObj[U"type"] = U"IsFlagOn";
-			conditionObj[U"flag"] = Unicode::FromUTF8(draft.conditionFlagBuffer);
+			++dirtyCount;
+			unchanged = (unchanged && std::binary_search(m_dirtyPaths.begin(), m_dirtyPaths.end(), path));
 		}
-		actionObj[U"condition"] = conditionObj;
+	}
 
-		if (draft.successAction) {
-			actionObj[U"success"] = buildActionJson(*draft.successAction);
-		}
-		if (draft.failureAction) {
-			actionObj[U"failure"] = buildActionJson(*draft.failureAction);
-		}
-		break;
+	if (unchanged && (dirtyCount == m_dirtyPaths.size()))
+	{
+		return;
 	}
-	case ActionType_Sequence: // 連続実行
+
+	m_dirtyPaths.clear();
+
+	for (const auto& [path, document] : m_documents)
 	{
-		actionObj[U"type"] = U"Sequence";
-		Array<JSON> actionsArray;
-		// unique_ptrのリストを反復処理し、中身を再帰的に処理
-		for (const auto& subDraftPtr : draft.actionList)
+		if (document->isDirty())
 		{
-			if (subDraftPtr)
-			{
-				actionsArray.push_back(buildActionJson(*subDraftPtr));
-			}
+			m_dirtyPaths.push_back(path);
 		}
-		actionObj[U"actions"] = actionsArray;
-		break;
 	}
-	case ActionType_MultiStep: // ステップ実行
+
+	m_dirtyPaths.sort();
+	++m_dirtyPathsRevision;
+}
+
+JSON& EditorController::getSelectedJsonData()
+{
+	if (m_selectedDocument)
+	{
+		return m_selectedDocument->getJson();
+	}
+
+	// 読み込み中・未選択のときは空の JSON を返す
+	m_emptyJson.clear();
+	return m_emptyJson;
+}
+
+bool EditorController::isSelectedDirty() const
+{
+	return (m_selectedDocument && m_selectedDocument->isDirty());
+}
+
+void EditorController::markSelectedDirty(const PersistentJson::Path& path)
+{
+	if (m_selectedDocument)
+	{
+		m_selectedDocument->markModified(path);
+		updateDirtyPaths();
+	}
+}
+
+void EditorController::undo()
+{
+	if (m_selectedDocument)
+	{
+		m_selectedDocument->undo();
+	}
+}
+
+void EditorController::redo()
+{
+	if (m_selectedDocument)
+	{
+		m_selectedDocument->redo();
+	}
+}
+
+void EditorController::closeDocuments()
+{
+	saveAll();
+	setSelectedPath(U"");
+	m_documents.clear();
+}
+
+void EditorController::openValidation()
+{
+	m_validator.open(m_model.makeDocumentReader(), m_model.getDocumentPaths());
+}
+
+void EditorController::updateValidation()
+{
+	// ディスク上で追加・削除・変更された文書だけを検証し直す
+	if (const Array<DimensionChange> changes = m_model.takeChanges(); not changes.isEmpty())
 	{
-		actionObj[U"type"] = U"MultiStep";
-		actionObj[U"id"] = Unicode::FromUTF8(draft.idBuffer);
-		Array<JSON> stepsArray;
-		for (const auto& subDraftPtr : draft.actionList)
+		m_validator.setPaths(m_model.getDocumentPaths());
+
+		for (const auto& change : changes)
 		{
-			if (subDraftPtr)
-			{
-				stepsArray.push_back(buildActionJson(*subDraftPtr));
-			}
+			m_validator.invalidate(change.path);
 		}
-		actionObj[U"steps"] = stepsArray;
+	}
 
-		if (draft.finalAction)
+	// 編集中の文書は保存を待たずに検証する（前回から変更のない文書はリビジョンで省かれる）
+	for (const auto& [path, document] : m_documents)
+	{
+		if (document->isDirty())
 		{
-			actionObj[U"final_action"] = buildActionJson(*draft.finalAction);
+			m_validator.validateDocument(path, document->getJson(), document->getRevision());
 		}
-		break;
 	}
-	case ActionType_ChangeDimension:
-		actionObj[U"type"] = U"ChangeDimension";
-		actionObj[U"target"] = Unicode::FromUTF8(draft.targetDimensionBuffer);
-		break;
+
+	m_validator.update();
+}
+
+const SaveQueue::Result* EditorController::findSaveResult(const FilePath& path) const
+{
+	if (auto it = m_saveResults.find(path); it != m_saveResults.end())
+	{
+		return &it->second;
 	}
-	return actionObj;
+
+	return nullptr;
 }
 
-JSON EditorController::buildJsonFromState(const HotspotDraftState& state)
+void EditorController::runLoadBenchmark()
 {
-	JSON hotspotObj;
-	hotspotObj[U"grid_pos"] = Unicode::FromUTF8(state.gridPosBuffer);
-	hotspotObj[U"action"] = buildActionJson(state.rootAction);
-	return hotspotObj;
+	if ((not m_model.isDimensionLoaded()) || m_model.isReadOnly())
+	{
+		return;
+	}
+
+	Benchmark::RunLoaderScaling(m_model.getCurrentDimensionPath());
 }
 
-void EditorController::addNewInteractable(JSON& roomData, const InteractableDraftState& draft)
+void EditorController::runMetadataBenchmark()
 {
-	JSON newInteractable;
-	newInteractable[U"name"] = Unicode::FromUTF8(draft.nameBuffer);
-	newInteractable[U"default_state"][U"asset"] = Unicode::FromUTF8(draft.defaultStateDraft.assetBuffer);
-	newInteractable[U"default_state"][U"grid_pos"] = Unicode::FromUTF8(draft.defaultStateDraft.gridPosBuffer);
+	if ((not m_model.isDimensionLoaded()) || m_model.isReadOnly())
+	{
+		return;
+	}
+
+	Benchmark::RunMetadataScan(m_model.getCurrentDimensionPath());
+}
 
-	Array<JSON> statesArray;
-	for (const auto& stateDraft : draft.states)
+void EditorController::runWriterBenchmark()
+{
+	if (not m_selectedDocument)
 	{
-		JSON stateObj;
-		stateObj[U"condition_flag"] = Unicode::FromUTF8(stateDraft.conditionFlagBuffer);
-		stateObj[U"asset"] = Unicode::FromUTF8(stateDraft.assetBuffer);
-		stateObj[U"grid_pos"] = Unicode::FromUTF8(stateDraft.gridPosBuffer);
-		statesArray.push_back(stateObj);
+		return;
 	}
-	newInteractable[U"states"] = statesArray;
-	newInteractable[U"hotspot"] = buildJsonFromState(draft.hotspotDraft);
 
-	if (not roomData.hasElement(U"interactables"))
+	Benchmark::RunJsonWriter(m_selectedDocument->getJson());
+}
+
+void EditorController::runSuiteBenchmark()
+{
+	const FilePath directory = FileSystem::GetFolderPath(SpecialFolder::LocalAppData) + U"DimensionEditor/Benchmark/";
+	const SyntheticDimension::Options options;
+	constexpr size_t Iterations = 5;
+
+	const Array<Benchmark::BenchmarkResult> results = Benchmark::RunSuite(directory, options, Iterations);
+
+	if (results.isEmpty())
 	{
-		roomData[U"interactables"] = Array<JSON>();
+		return;
 	}
 
-	roomData[U"interactables"].push_back(newInteractable);
+	const FilePath resultPath = directory + U"suite_{}.json"_fmt(DateTime::Now().format(U"yyyyMMdd_HHmmss"));
+
+	if (JsonStreamWriter::Save(Benchmark::ToJSON(results, options, Iterations), resultPath))
+	{
+		Logger << U"[Benchmark] Results written to " << resultPath;
+	}
 }
 
-void EditorController::addNewRoom(const String& roomName)
+void EditorController::addNewHotspot(const HotspotDraftState& hotspotState)
 {
-	m_model.AddNewRoom(roomName);
+	// UIの状態からJSONデータを組み立てる
+	JSON newHotspotJson = EditorDrafts::BuildHotspotJson(hotspotState);
+
+	// メモリ上の文書に1回だけ追加する（保存は saveSelectedJson で別に行う）
+	if (m_selectedDocument && m_model.addHotspot(m_selectedDocument->getJson(), newHotspotJson))
+	{
+		markSelectedDirty({ U"hotspots" });
+	}
 }
 
-void EditorController::updateInteractable(JSON& roomData, int interactableIndex, const InteractableDraftState& draft)
+RoomEditSession EditorController::beginRoomEdit(const String& roomName)
 {
-	auto&& target = roomData[U"interactables"][interactableIndex];
-	target[U"name"] = Unicode::FromUTF8(draft.nameBuffer);
-	target[U"default_state"][U"asset"] = Unicode::FromUTF8(draft.defaultStateDraft.assetBuffer);
-	target[U"default_state"][U"grid_pos"] = Unicode::FromUTF8(draft.defaultStateDraft.gridPosBuffer);
+	if (not m_selectedDocument)
+	{
+		return{};
+	}
 
-	Array<JSON> statesArray;
-	for (const auto& stateDraft : draft.states)
+	return RoomEditSession{ m_selectedDocument, roomName };
+}
+
+bool EditorController::applyRoomEdit(RoomEditSession& session)
+{
+	const std::shared_ptr<EditorDocument> document = session.getDocument();
+
+	// 次元を切り替えるなどして文書が閉じられていたら反映しない
+	const auto it = (document ? m_documents.find(document->getPath()) : m_documents.end());
+
+	if ((it == m_documents.end()) || (it->second != document))
+	{
+		Logger << U"🚨 Room edit discarded: the document is no longer open";
+		session.discard();
+		return false;
+	}
+
+	const bool modified = session.isModified();
+
+	if (not session.commit())
 	{
-		JSON stateObj;
-		stateObj[U"condition_flag"] = Unicode::FromUTF8(stateDraft.conditionFlagBuffer);
-		stateObj[U"asset"] = Unicode::FromUTF8(stateDraft.assetBuffer);
-		stateObj[U"grid_pos"] = Unicode::FromUTF8(stateDraft.gridPosBuffer);
-		statesArray.push_back(stateObj);
+		Logger << U"🚨 Room edit discarded: the room no longer exists";
+		return false;
 	}
-	target[U"states"] = statesArray;
-	target[U"hotspot"] = buildJsonFromState(draft.hotspotDraft);
+
+	if (modified)
+	{
+		saveDocument(*document);
+	}
+
+	return true;
 }
 
-void EditorController::addNewFocusable(const String& roomName, JSON& roomData, const ForcusableDraftState& draft)
+void EditorController::setSelectedPath(const FilePath& path)
 {
-	JSON newForcusable;
-	newForcusable[U"name"] = Unicode::FromUTF8(draft.nameBuffer);
-	newForcusable[U"default_state"][U"asset"] = Unicode::FromUTF8(draft.defaultStateDraft.assetBuffer);
-	newForcusable[U"hotspot"][U"grid_pos"] = Unicode::FromUTF8(draft.hotspotGridPosBuffer);
+	// 未保存の変更がある文書は開いたまま残す（Save All で保存する）。変更のない文書は閉じる
+	if (m_selectedDocument && (not m_selectedDocument->isDirty()))
+	{
+		m_documents.erase(m_selectedDocument->getPath());
+	}
 
-	Array<JSON> statesArray;
-	for (const auto& stateDraft : draft.states)
+	m_selectedPath = path;
+	m_selectedDocument.reset();
+
+	// 前の選択の読み込みが終わっていなければ取り消す
+	if (m_pendingLoad.isValid())
 	{
-		JSON stateObj;
-		stateObj[U"condition_flag"] = Unicode::FromUTF8(stateDraft.conditionFlagBuffer);
-		stateObj[U"asset"] = Unicode::FromUTF8(stateDraft.assetBuffer);
-		statesArray.push_back(stateObj);
+		m_pendingLoad.cancel();
+		m_cancelledLoads.push_back(std::move(m_pendingLoad));
+		m_pendingLoad = DocumentLoadHandle{};
 	}
-	newForcusable[U"states"] = statesArray;
 
-	if (not roomData.hasElement(U"forcusables"))
+	// 編集中のまま開いている文書なら、読み込み直さずにそのまま使う
+	if (auto it = m_documents.find(m_selectedPath); it != m_documents.end())
 	{
-		roomData[U"forcusables"] = Array<JSON>();
+		m_selectedDocument = it->second;
+		return;
 	}
 
-	roomData[U"forcusables"].push_back(newForcusable);
+	// もしパスが空でなく、JSONファイルなら、バックグラウンドで中身を読み込む
+	if ((not m_selectedPath.isEmpty()) && (FileSystem::Extension(m_selectedPath) == U"json"))
+	{
+		m_pendingLoad = m_model.loadDocumentAsync(m_selectedPath);
+	}
+}
+
+void EditorController::pollSelectionLoad()
+{
+	if (m_pendingLoad.isValid() && m_pendingLoad.isReady())
+	{
+		if (auto document = m_pendingLoad.get())
+		{
+			m_documents[document->getPath()] = document;
+			m_selectedDocument = std::move(document);
+		}
+		m_pendingLoad = DocumentLoadHandle{};
+	}
+
+	// 取り消した読み込みは、完了したものから破棄する
+	m_cancelledLoads.remove_if([](const DocumentLoadHandle& load) { return load.isReady(); });
+}
+
+void EditorController::addNewInteractable(RoomEditSession& session, const InteractableDraftState& draft)
+{
+	FocusableData newInteractable;
+	ApplyInteractableDraft(newInteractable, draft);
+
+	session.edit(U"interactables", Array<JSON>()).push_back(TypedObjects::ToJSON(newInteractable));
+}
+
+void EditorController::addNewRoom(const String& roomName)
+{
+	m_model.AddNewRoom(roomName);
+}
+
+void EditorController::updateInteractable(RoomEditSession& session, int interactableIndex, const InteractableDraftState& draft)
+{
+	// 範囲外の添字や、オブジェクトでない要素は書き換えない（空のオブジェクトで置き換えない）
+	const JSON current = session.get(U"interactables");
+
+	if ((interactableIndex < 0) || (not current.isArray()) || (current.size() <= static_cast<size_t>(interactableIndex)))
+	{
+		return;
+	}
+
+	Optional<FocusableData> target = TypedObjects::BindFocusable(current[interactableIndex]);
+
+	if (not target)
+	{
+		return;
+	}
+
+	ApplyInteractableDraft(*target, draft);
+
+	auto&& interactables = session.edit(U"interactables");
+	interactables[interactableIndex] = TypedObjects::ToJSON(*target);
+}
+
+void EditorController::addNewFocusable(RoomEditSession& session, const ForcusableDraftState& draft)
+{
+	FocusableData newForcusable;
+	ApplyFocusableDraft(newForcusable, draft);
+
+	session.edit(U"forcusables", Array<JSON>()).push_back(TypedObjects::ToJSON(newForcusable));
 
 	const String fileName = Unicode::FromUTF8(draft.nameBuffer) + U".json";
-	m_model.CreateNewFocusableFile(roomName, fileName);
+	m_model.CreateNewFocusableFile(session.getRoomName(), fileName);
 }
 
-void EditorController::updateFocusable(JSON& roomData, int focusableIndex, const ForcusableDraftState& draft)
+void EditorController::updateFocusable(RoomEditSession& session, int focusableIndex, const ForcusableDraftState& draft)
 {
-	auto target = roomData[U"forcusables"][focusableIndex];
-	target[U"name"] = Unicode::FromUTF8(draft.nameBuffer);
-	target[U"default_state"][U"asset"] = Unicode::FromUTF8(draft.defaultStateDraft.assetBuffer);
-	target[U"hotspot"][U"grid_pos"] = Unicode::FromUTF8(draft.hotspotGridPosBuffer);
+	// 範囲外の添字や、オブジェクトでない要素は書き換えない（空のオブジェクトで置き換えない）
+	const JSON current = session.get(U"forcusables");
 
-	Array<JSON> statesArray;
-	for (const auto& stateDraft : draft.states)
+	if ((focusableIndex < 0) || (not current.isArray()) || (current.size() <= static_cast<size_t>(focusableIndex)))
 	{
-		JSON stateObj;
-		stateObj[U"condition_flag"] = Unicode::FromUTF8(stateDraft.conditionFlagBuffer);
-		stateObj[U"asset"] = Unicode::FromUTF8(stateDraft.assetBuffer);
-		statesArray.push_back(stateObj);
+		return;
 	}
-	target[U"states"] = statesArray;
+
+	Optional<FocusableData> target = TypedObjects::BindFocusable(current[focusableIndex]);
+
+	if (not target)
+	{
+		return;
+	}
+
+	ApplyFocusableDraft(*target, draft);
+
+	auto&& focusables = session.edit(U"forcusables");
+	focusables[focusableIndex] = TypedObjects::ToJSON(*target);
 }
@@ -1,5 +1,9 @@
 ﻿#pragma once
 #include "EditorDrafts.hpp"
+#include "../Model/DimensionValidator.hpp"
+#include "../Model/DocumentLoadHandle.hpp"
+#include "../Model/SaveQueue.hpp"
+#include "../Model/RoomEditSession.hpp"
 
 
 class DimensionModel;
@@ -15,37 +19,135 @@ public:
 	void openDimension();
 	void createNewDimension(const String& name, const FilePath& baseDir);
 
+	// .dimpak（1ファイルにまとめた次元）の読み込み・書き出し・展開
+	void openDimensionPack();
+	void exportDimensionPack();
+	void unpackDimensionPack();
+
 	void setSelectedPath(const FilePath& path);
 
 	const FilePath& getSelectedPath() const { return m_selectedPath; }
 
-	JSON& getSelectedJsonData() { return m_selectedJsonData; }
+	// 選択したファイルをバックグラウンドで読み込み中なら true
+	bool isSelectionLoading() const { return m_pendingLoad.isValid(); }
+
+	// 指定したファイルの直近の保存結果（まだ保存していなければ nullptr）
+	const SaveQueue::Result* findSaveResult(const FilePath& path) const;
+
+	JSON& getSelectedJsonData();
+
+	// 選択中の文書（読み込み中・未選択なら nullptr）。表示のキャッシュは、文書と EditorDocument::getRevision() の組で無効化する
+	std::shared_ptr<const EditorDocument> getSelectedDocument() const { return m_selectedDocument; }
+
+	// 選択中の文書にまだ保存していない変更があれば true
+	bool isSelectedDirty() const;
+
+	// 選択中の文書を直接書き換えた場合に呼ぶ（path は変更した位置。元に戻す履歴に記録される）
+	void markSelectedDirty(const PersistentJson::Path& path = {});
+
+	// 選択中の文書の変更を元に戻す・やり直す
+	void undo();
+	void redo();
+	bool canUndo() const { return (m_selectedDocument && m_selectedDocument->canUndo()); }
+	bool canRedo() const { return (m_selectedDocument && m_selectedDocument->canRedo()); }
+
+	// 保存していない変更がある文書なら true
+	bool isDocumentDirty(const FilePath& path) const;
+
+	// 保存していない変更がある文書のパスの一覧（昇順）
+	const Array<FilePath>& getDirtyPaths() const { return m_dirtyPaths; }
 
+	// getDirtyPaths() の内容が変わるたびに増える（表示のキャッシュは、この値が変わったときだけ作り直せばよい）
+	uint64 getDirtyPathsRevision() const { return m_dirtyPathsRevision; }
+
+	// 選択中の文書を保存する（前回保存した内容と同じなら書き込まない）
 	void saveSelectedJson();
 
+	// 変更のあるすべての文書を保存する（前回保存した内容と同じものは書き込まない）
+	void saveAll();
+
+	// 現在の次元を対象に、ロード処理のコア数スケーリングを計測する
+	void runLoadBenchmark();
+
+	// 現在の次元を対象に、オブジェクト概要の取得（完全なパースとの比較）を計測する
+	void runMetadataBenchmark();
+
+	// 選択中の文書を対象に、JSON の保存処理を計測する
+	void runWriterBenchmark();
+
+	// 合成した次元で主要な処理をまとめて計測し、結果を JSON に保存する（開いている次元には触れない）
+	void runSuiteBenchmark();
+
 	void addNewHotspot(const HotspotDraftState& hotspotState);
 
-	void updateRoomData(const String& roomName, const JSON& newRoomData);
+	// 選択中の文書（room_connections.json）の部屋を編集するセッションを開く（部屋の内容は複製しない）
+	[[nodiscard]]
+	RoomEditSession beginRoomEdit(const String& roomName);
 
+	// セッションの変更を文書へまとめて反映して保存する
+	bool applyRoomEdit(RoomEditSession& session);
 
-	void addNewInteractable(JSON& roomData, const InteractableDraftState& draft);
+
+	void addNewInteractable(RoomEditSession& session, const InteractableDraftState& draft);
 
 	void addNewRoom(const String& roomName);
 
-	void updateInteractable(JSON& roomData, int interactableIndex, const InteractableDraftState& draft);
+	void updateInteractable(RoomEditSession& session, int interactableIndex, const InteractableDraftState& draft);
 
-	void addNewFocusable(const String& roomName, JSON& roomData, const ForcusableDraftState& draft);
+	void addNewFocusable(RoomEditSession& session, const ForcusableDraftState& draft);
 
-	void updateFocusable(JSON& roomData, int focusableIndex, const ForcusableDraftState& draft);
+	void updateFocusable(RoomEditSession& session, int focusableIndex, const ForcusableDraftState& draft);
 
 	DimensionModel& getModel() { return m_model; }
 	const DimensionModel& getModel() const { return m_model; }
 
-private:
-	JSON buildJsonFromState(const HotspotDraftState& state);
-	JSON buildActionJson(const ActionDraft& draft);
+	// 開いている次元の全文書の検証結果（ディスク上の変更と編集中の文書を反映し続ける）
+	const DimensionValidator& getValidator() const { return m_validator; }
 
+	// すべての文書を読み直して検証する
+	void revalidateAll() { m_validator.revalidateAll(); }
+
+private:
 	DimensionModel& m_model;
+	void pollSelectionLoad();
+
+	void saveDocument(EditorDocument& document);
+
+	// 開いている文書をすべて保存して閉じる（次元を切り替えるときに呼ぶ）
+	void closeDocuments();
+
+	// 開いた次元の検証を始める（次元を切り替えたときに呼ぶ）
+	void openValidation();
+
+	// ディスク上の変更と編集中の文書を検証に反映する（毎フレーム呼ぶ）
+	void updateValidation();
+
+	// 未保存の文書の一覧を更新する（変わっていなければ何もしない。毎フレーム呼ぶので、確保をしない）
+	void updateDirtyPaths();
+
 	FilePath m_selectedPath;
-	JSON m_selectedJsonData;
+
+	// 選択中の文書（読み込み中・未選択のときは nullptr）
+	std::shared_ptr<EditorDocument> m_selectedDocument;
+
+	// 開いている文書（選択中の文書と、保存していない変更がある文書）
+	HashTable<FilePath, std::shared_ptr<EditorDocument>> m_documents;
+
+	// m_documents のうち、保存していない変更がある文書のパス（昇順）
+	Array<FilePath> m_dirtyPaths;
+
+	uint64 m_dirtyPathsRevision = 0;
+
+	JSON m_emptyJson;
+
+	// 選択中のファイルの読み込み
+	DocumentLoadHandle m_pendingLoad;
+
+	// 新しい選択で取り消された読み込み（完了を待たずに破棄するとUIスレッドが止まるため、完了まで保持する）
+	Array<DocumentLoadHandle> m_cancelledLoads;
+
+	// ファイルごとの直近の保存結果
+	HashTable<FilePath, SaveQueue::Result> m_saveResults;
+
+	DimensionValidator m_validator;
 };
@@ -0,0 +1,214 @@
+﻿#include "EditorDrafts.hpp"
+
+namespace
+{
+	constexpr Atom ShowText = Atom::Static(U"ShowText");
+	constexpr Atom GiveItem = Atom::Static(U"GiveItem");
+	constexpr Atom SetFlag = Atom::Static(U"SetFlag");
+	constexpr Atom Conditional = Atom::Static(U"Conditional");
+	constexpr Atom Sequence = Atom::Static(U"Sequence");
+	constexpr Atom MultiStep = Atom::Static(U"MultiStep");
+	constexpr Atom ChangeDimension = Atom::Static(U"ChangeDimension");
+	constexpr Atom HasItem = Atom::Static(U"HasItem");
+	constexpr Atom IsFlagOn = Atom::Static(U"IsFlagOn");
+
+	std::unique_ptr<ActionData> BuildChild(const ActionDraft& draft)
+	{
+		return std::make_unique<ActionData>(EditorDrafts::BuildAction(draft));
+	}
+
+	std::unique_ptr<ActionDraft> BuildChildDraft(const ActionData& action)
+	{
+		auto draft = std::make_unique<ActionDraft>();
+		EditorDrafts::BuildDraftFromAction(*draft, action);
+		return draft;
+	}
+
+	Array<std::unique_ptr<ActionData>> BuildList(const std::vector<std::unique_ptr<ActionDraft>>& drafts)
+	{
+		Array<std::unique_ptr<ActionData>> actions;
+
+		// unique_ptrのリストを反復処理し、中身を再帰的に処理
+		for (const auto& subDraftPtr : drafts)
+		{
+			if (subDraftPtr)
+			{
+				actions.push_back(BuildChild(*subDraftPtr));
+			}
+		}
+
+		return actions;
+	}
+}
+
+namespace EditorDrafts
+{
+	ActionData BuildAction(const ActionDraft& draft)
+	{
+		ActionData action;
+		// アクションの種類に応じて分岐
+		switch (draft.typeIndex) {
+		case ActionType_ShowText: // テキストを表示
+			action.type = ShowText;
+			action.file = Unicode::FromUTF8(draft.fileBuffer);
+			break;
+		case ActionType_GiveItem: // アイテムを入手
+			action.type = GiveItem;
+			action.item = Unicode::FromUTF8(draft.itemBuffer);
+			break;
+		case ActionType_SetFlag: // フラグを操作
+			action.type = SetFlag;
+			action.flag = Unicode::FromUTF8(draft.flagBuffer);
+			action.value = draft.flagValue;
+			break;
+		case ActionType_Conditional: // 条件分岐
+		{
+			action.type = Conditional;
+			ConditionData condition;
+			if (draft.conditionTypeIndex == 0) // HasItem
+			{
+				condition.type = HasItem;
+				condition.item = Unicode::FromUTF8(draft.conditionItemBuffer);
+			}
+			else // IsFlagOn
+			{
+				condition.type = IsFlagOn;
+				condition.flag = Unicode::FromUTF8(draft.conditionFlagBuffer);
+			}
+			action.condition = std::move(condition);
+
+			if (draft.successAction) {
+				action.success = BuildChild(*draft.successAction);
+			}
+			if (draft.failureAction) {
+				action.failure = BuildChild(*draft.failureAction);
+			}
+			break;
+		}
+		case ActionType_Sequence: // 連続実行
+			action.type = Sequence;
+			action.actions = BuildList(draft.actionList);
+			break;
+		case ActionType_MultiStep: // ステップ実行
+			action.type = MultiStep;
+			action.id = Unicode::FromUTF8(draft.idBuffer);
+			action.steps = BuildList(draft.actionList);
+
+			if (draft.finalAction)
+			{
+				action.finalAction = BuildChild(*draft.finalAction);
+			}
+			break;
+		case ActionType_ChangeDimension:
+			action.type = ChangeDimension;
+			action.target = Unicode::FromUTF8(draft.targetDimensionBuffer);
+			break;
+		}
+		return action;
+	}
+
+	JSON BuildActionJson(const ActionDraft& draft)
+	{
+		return TypedObjects::ToJSON(BuildAction(draft));
+	}
+
+	HotspotData BuildHotspot(const HotspotDraftState& state)
+	{
+		HotspotData hotspot;
+		hotspot.gridPos = Unicode::FromUTF8(state.gridPosBuffer);
+		hotspot.action = BuildAction(state.rootAction);
+		return hotspot;
+	}
+
+	JSON BuildHotspotJson(const HotspotDraftState& state)
+	{
+		return TypedObjects::ToJSON(BuildHotspot(state));
+	}
+
+	void BuildDraftFromAction(ActionDraft& draft, const ActionData& action)
+	{
+		const Atom type = action.type;
+
+		if (type == ShowText)
+		{
+			draft.typeIndex = ActionType_ShowText;
+			draft.fileBuffer = action.file.value_or(U"").toUTF8();
+		}
+		else if (type == GiveItem)
+		{
+			draft.typeIndex = ActionType_GiveItem;
+			draft.itemBuffer = action.item.value_or(U"").toUTF8();
+		}
+		else if (type == SetFlag)
+		{
+			draft.typeIndex = ActionType_SetFlag;
+			draft.flagBuffer = action.flag.value_or(U"").toUTF8();
+			draft.flagValue = action.value.value_or(false);
+		}
+		else if (type == Conditional)
+		{
+			draft.typeIndex = ActionType_Conditional;
+			if (action.condition)
+			{
+				const ConditionData& cond = *action.condition;
+				if (cond.type == HasItem)
+				{
+					draft.conditionTypeIndex = 0;
+					draft.conditionItemBuffer = cond.item.value_or(U"").toUTF8();
+				}
+				else
+				{
+					draft.conditionTypeIndex = 1;
+					draft.conditionFlagBuffer = cond.flag.value_or(U"").toUTF8();
+				}
+			}
+
+			if (action.success)
+			{
+				draft.successAction = BuildChildDraft(*action.success);
+			}
+			if (action.failure)
+			{
+				draft.failureAction = BuildChildDraft(*action.failure);
+			}
+		}
+		else if (type == Sequence || type == MultiStep)
+		{
+			draft.typeIndex = (type == Sequence) ? ActionType_Sequence : ActionType_MultiStep;
+			const auto& list = (type == Sequence) ? action.actions : action.steps;
+
+			if (type == MultiStep)
+			{
+				draft.idBuffer = action.id.value_or(U"").toUTF8();
+				if (action.finalAction)
+				{
+					draft.finalAction = BuildChildDraft(*action.finalAction);
+				}
+			}
+
+			if (list)
+			{
+				for (const auto& subAction : *list)
+				{
+					if (subAction)
+					{
+						draft.actionList.push_back(BuildChildDraft(*subAction));
+					}
+				}
+			}
+		}
+		else if (type == ChangeDimension)
+		{
+			draft.typeIndex = ActionType_ChangeDimension;
+			draft.targetDimensionBuffer = action.target.value_or(U"").toUTF8();
+		}
+	}
+
+	void BuildDraftFromActionJson(ActionDraft& draft, const JSON& json)
+	{
+		if (const Optional<ActionData> action = TypedObjects::BindAction(json))
+		{
+			BuildDraftFromAction(draft, *action);
+		}
+	}
+}
@@ -1,7 +1,20 @@
 ﻿#pragma once
 #include <Siv3D.hpp>
+#include "../Model/TypedObjects.hpp"
 
 // ViewとControllerの両方で使われるデータ構造の定義
+// （ImGui に依存しないので、コマンドラインツールからも使う）
+
+// ActionDraft::typeIndex の値
+enum ActionTypeIndex {
+	ActionType_ShowText = 0,
+	ActionType_GiveItem,
+	ActionType_SetFlag,
+	ActionType_Conditional,
+	ActionType_Sequence,
+	ActionType_MultiStep,
+	ActionType_ChangeDimension
+};
 
 struct ActionDraft
 {
@@ -68,3 +81,24 @@ struct ForcusableDraftState
 	std::vector<ConditionalStateDraft> states;
 };
 
+// 下書きと型付きのデータ（TypedObjects.hpp）・JSON の相互変換
+namespace EditorDrafts
+{
+	// 下書きからアクションを組み立てる
+	ActionData BuildAction(const ActionDraft& draft);
+
+	// 下書きからアクションの JSON を組み立てる
+	JSON BuildActionJson(const ActionDraft& draft);
+
+	// 下書きから hotspot を組み立てる
+	HotspotData BuildHotspot(const HotspotDraftState& state);
+
+	// 下書きから hotspot の JSON を組み立てる
+	JSON BuildHotspotJson(const HotspotDraftState& state);
+
+	// アクションから編集用の下書きを組み立てる（不明な種類のアクションは何もしない）
+	void BuildDraftFromAction(ActionDraft& draft, const ActionData& action);
+
+	// アクションの JSON から編集用の下書きを組み立てる（不明な種類のアクションは何もしない）
+	void BuildDraftFromActionJson(ActionDraft& draft, const JSON& json);
+}
@@ -19,11 +19,14 @@ void Main()
 	auto& io = ImGui::GetIO();
 	io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;
 
-	InitializeSchemas();
-	InitializeRecursiveSchemas();
-	InitializeSchemaDependencies();
-
 	DimensionModel model;
+
+	// エディタ設定の読み込み
+	if (const JSON config = JSON::Load(U"editor_config.json"); config && config.hasElement(U"document_cache_budget_mb"))
+	{
+		const int32 budgetMB = config[U"document_cache_budget_mb"].getOr<int32>(256);
+		model.setDocumentCacheBudget(static_cast<size_t>(Max(budgetMB, 0)) << 20);
+	}
 	EditorController controller{ model };
 	EditorView view;
 
@@ -35,4 +38,7 @@ void Main()
 		// ViewがModelの状態を描画
 		view.draw(model, controller);
 	}
+
+	// 保存していない変更を書き込んでから終了する（書き込みは DimensionModel の破棄時に完了を待つ）
+	controller.saveAll();
 }
@@ -0,0 +1,199 @@
+﻿#include "Atom.hpp"
+#include <shared_mutex>
+
+namespace
+{
+	// 番号 → 文字列 の表は固定長のブロックに分けて持ち、ブロックは動かさない
+	// （str() はロックを取らずに引ける。番号を受け取った時点で、その番号の要素は書き込み済み）
+	constexpr uint32 BlockBits = 10;
+
+	constexpr uint32 BlockSize = (1u << BlockBits);
+
+	constexpr uint32 MaxBlocks = 4096;
+
+	// 文字列の本体を置くバッファの大きさ（文字数）
+	constexpr size_t StorageChunkLength = 4096;
+
+	class AtomTable
+	{
+	public:
+		AtomTable()
+		{
+			// 定義済みの文字列はリテラルをそのまま指す（番号は並びの位置になる）
+			for (const auto& name : g_StaticAtomNames)
+			{
+				insert(name);
+			}
+		}
+
+		~AtomTable()
+		{
+			for (auto& block : m_blocks)
+			{
+				delete[] block.load(std::memory_order_relaxed);
+			}
+		}
+
+		[[nodiscard]]
+		uint32 intern(const StringView s)
+		{
+			{
+				std::shared_lock lock{ m_mutex };
+
+				if (auto it = m_ids.find(s); it != m_ids.end())
+				{
+					return it->second;
+				}
+			}
+
+			std::unique_lock lock{ m_mutex };
+
+			// 共有ロックを外している間に、別のスレッドが加えたかもしれない
+			if (auto it = m_ids.find(s); it != m_ids.end())
+			{
+				return it->second;
+			}
+
+			return insert(store(s));
+		}
+
+		[[nodiscard]]
+		Optional<uint32> find(const StringView s) const
+		{
+			std::shared_lock lock{ m_mutex };
+
+			if (auto it = m_ids.find(s); it != m_ids.end())
+			{
+				return it->second;
+			}
+
+			return none;
+		}
+
+		[[nodiscard]]
+		StringView get(const uint32 id) const
+		{
+			return m_blocks[id >> BlockBits].load(std::memory_order_acquire)[id & (BlockSize - 1)];
+		}
+
+		[[nodiscard]]
+		Atom::Stats getStats() const
+		{
+			std::shared_lock lock{ m_mutex };
+
+			const size_t blockCount = ((m_count + BlockSize - 1) / BlockSize);
+
+			return{
+				.atomCount = m_count,
+				.bytes = (m_storageBytes + (blockCount * BlockSize * sizeof(StringView))
+					+ (m_ids.capacity() * (sizeof(std::pair<StringView, uint32>) + 1))),
+			};
+		}
+
+	private:
+		// 文字列をバッファに写し、写した先を返す（排他ロックを取って呼ぶ）
+		StringView store(const StringView s)
+		{
+			if (StorageChunkLength < s.size())
+			{
+				// 長い文字列は専用のバッファに置く
+				m_storage.push_back(std::make_unique<char32[]>(s.size()));
+				m_storageBytes += (s.size() * sizeof(char32));
+				std::copy(s.begin(), s.end(), m_storage.back().get());
+				return StringView{ m_storage.back().get(), s.size() };
+			}
+
+			if (m_storage.isEmpty() || (StorageChunkLength < (m_storageUsed + s.size())))
+			{
+				m_storage.push_back(std::make_unique<char32[]>(StorageChunkLength));
+				m_storageBytes += (StorageChunkLength * sizeof(char32));
+				m_storageUsed = 0;
+			}
+
+			char32* destination = (m_storage.back().get() + m_storageUsed);
+			std::copy(s.begin(), s.end(), destination);
+			m_storageUsed += s.size();
+			return StringView{ destination, s.size() };
+		}
+
+		// 排他ロックを取って呼ぶ（s は表が生きている間有効であること）
+		uint32 insert(const StringView s)
+		{
+			const uint32 id = m_count;
+
+			if ((MaxBlocks * BlockSize) <= id)
+			{
+				throw Error{ U"Atom table is full" };
+			}
+
+			StringView* block = m_blocks[id >> BlockBits].load(std::memory_order_relaxed);
+
+			if (not block)
+			{
+				block = new StringView[BlockSize];
+				m_blocks[id >> BlockBits].store(block, std::memory_order_release);
+			}
+
+			block[id & (BlockSize - 1)] = s;
+			m_ids.emplace(s, id);
+			++m_count;
+			return id;
+		}
+
+		mutable std::shared_mutex m_mutex;
+
+		HashTable<StringView, uint32> m_ids;
+
+		std::array<std::atomic<StringView*>, MaxBlocks> m_blocks{};
+
+		uint32 m_count = 0;
+
+		Array<std::unique_ptr<char32[]>> m_storage;
+
+		size_t m_storageUsed = 0;
+
+		size_t m_storageBytes = 0;
+	};
+
+	AtomTable& GetTable()
+	{
+		// 初めて使うときに作る（静的な初期化の順序に依存しない）
+		static AtomTable table;
+		return table;
+	}
+}
+
+Atom Atom::Intern(const StringView s)
+{
+	if (s.isEmpty())
+	{
+		return Atom{};
+	}
+
+	return Atom{ GetTable().intern(s) };
+}
+
+Optional<Atom> Atom::Find(const StringView s)
+{
+	if (s.isEmpty())
+	{
+		return Atom{};
+	}
+
+	if (const auto id = GetTable().find(s))
+	{
+		return Atom{ *id };
+	}
+
+	return none;
+}
+
+StringView Atom::str() const
+{
+	return GetTable().get(m_id);
+}
+
+Atom::Stats Atom::GetStats()
+{
+	return GetTable().getStats();
+}
@@ -0,0 +1,135 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include <array>
+
+// 起動時に決まった番号でインターンしておく文字列（番号はこの並びの位置。先頭は空文字列）
+// スキーマのキーはすべてここに並べる（並べていないキーは SchemaManager.hpp でコンパイルエラーになる）
+inline constexpr std::array<StringView, 58> g_StaticAtomNames{
+	U"",
+
+	// スキーマのキー
+	U"action", U"actions", U"answers", U"asset", U"background", U"background_texture", U"bg_close", U"bg_open",
+	U"code", U"condition", U"condition_flag", U"default_state", U"failure", U"file", U"final_action", U"flag",
+	U"forcusable", U"grid_pos", U"hotspot", U"id", U"initial_grid", U"interactable", U"interactables", U"item",
+	U"item_close", U"item_open", U"missing_pieces", U"name", U"pages", U"position", U"puzzle_texture", U"puzzle_width",
+	U"scope", U"secret_code", U"states", U"steps", U"success", U"success_image", U"texture", U"to",
+	U"transitions", U"type", U"value",
+
+	// スキーマにないが、エディタが読み書きするキー
+	U"hotspots", U"rooms", U"target",
+
+	// アクションと条件の種類
+	U"ShowText", U"GiveItem", U"SetFlag", U"Conditional", U"Sequence", U"MultiStep", U"ChangeDimension",
+	U"HasItem", U"IsFlagOn",
+
+	// フラグの範囲
+	U"Global", U"Dimension",
+};
+
+// インターンした文字列の番号
+// ・同じ内容の文字列は常に同じ Atom になるので、比較とハッシュは整数の演算で済む
+// ・インターンした文字列は解放しない（str() はプロセスの終わりまで有効）
+// ・どのスレッドからでもインターン・参照できる
+class Atom
+{
+public:
+	// 空文字列
+	constexpr Atom() = default;
+
+	// s の Atom（初めての文字列なら表に加える）
+	[[nodiscard]]
+	static Atom Intern(StringView s);
+
+	// s がインターン済みならその Atom（表には加えない。探すだけの場合に使う）
+	[[nodiscard]]
+	static Optional<Atom> Find(StringView s);
+
+	// g_StaticAtomNames にある文字列の Atom。ない文字列はコンパイルエラーになる
+	[[nodiscard]]
+	static consteval Atom Static(const StringView s)
+	{
+		for (size_t i = 0; i < g_StaticAtomNames.size(); ++i)
+		{
+			if (g_StaticAtomNames[i].view() == s.view())
+			{
+				return Atom{ static_cast<uint32>(i) };
+			}
+		}
+
+		throw "not a static atom (add it to g_StaticAtomNames)";
+	}
+
+	[[nodiscard]]
+	StringView str() const;
+
+	[[nodiscard]]
+	constexpr uint32 id() const noexcept { return m_id; }
+
+	[[nodiscard]]
+	constexpr bool isEmpty() const noexcept { return (m_id == 0); }
+
+	[[nodiscard]]
+	friend constexpr bool operator ==(const Atom&, const Atom&) noexcept = default;
+
+	// 表の大きさ
+	struct Stats
+	{
+		size_t atomCount = 0;
+
+		// 文字列の本体と表が使っているメモリ（バイト）
+		size_t bytes = 0;
+	};
+
+	[[nodiscard]]
+	static Stats GetStats();
+
+private:
+	constexpr explicit Atom(const uint32 id) noexcept
+		: m_id{ id } {}
+
+	uint32 m_id = 0;
+};
+
+template <>
+struct std::hash<Atom>
+{
+	[[nodiscard]]
+	size_t operator ()(const Atom& atom) const noexcept
+	{
+		return std::hash<uint32>{}(atom.id());
+	}
+};
+
+// コードから使うキーと値
+namespace Atoms
+{
+	inline constexpr Atom Action = Atom::Static(U"action");
+	inline constexpr Atom Asset = Atom::Static(U"asset");
+	inline constexpr Atom DefaultState = Atom::Static(U"default_state");
+	inline constexpr Atom GridPos = Atom::Static(U"grid_pos");
+	inline constexpr Atom Hotspot = Atom::Static(U"hotspot");
+	inline constexpr Atom Hotspots = Atom::Static(U"hotspots");
+	inline constexpr Atom Name = Atom::Static(U"name");
+	inline constexpr Atom Rooms = Atom::Static(U"rooms");
+	inline constexpr Atom States = Atom::Static(U"states");
+	inline constexpr Atom Type = Atom::Static(U"type");
+
+	// 値が決まった候補から選ばれるキー（アクションと条件の種類、フラグの範囲）
+	// PersistentJson はこれらのキーの値が定義済みの候補なら Atom として持つ
+	// アイテム名やアセット名などの自由に入力される値は、編集の途中の文字列で表が埋まらないよう String のまま持つ
+	[[nodiscard]]
+	constexpr bool IsEnumKey(const Atom key) noexcept
+	{
+		constexpr std::array Keys{ Atom::Static(U"type"), Atom::Static(U"scope") };
+
+		for (const Atom enumKey : Keys)
+		{
+			if (enumKey == key)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
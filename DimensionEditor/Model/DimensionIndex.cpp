@@ -0,0 +1,472 @@
+﻿#include <filesystem>
+#include "DimensionIndex.hpp"
+#include "DimensionLoader.hpp"
+#include "FileStamp.hpp"
+#include "FileSync.hpp"
+
+namespace
+{
+	constexpr char IndexMagic[8] = { 'D', 'I', 'M', 'I', 'D', 'X', '\0', '\0' };
+
+	constexpr uint32 IndexVersion = 1;
+
+	constexpr uint8 ObjectFlag_HasMetadata = 0x1;
+
+	constexpr uint8 ObjectFlag_HasHotspotCount = 0x2;
+
+	struct IndexedObject
+	{
+		String fileName;
+
+		Optional<FileStamp> stamp;
+
+		Optional<ObjectMetadata> metadata;
+	};
+
+	struct IndexedRoom
+	{
+		String name;
+
+		Optional<FileStamp> directoryStamp;
+
+		Array<IndexedObject> objects;
+	};
+
+	struct IndexData
+	{
+		Optional<FileStamp> rootStamp;
+
+		Optional<FileStamp> connectionsStamp;
+
+		Array<IndexedRoom> rooms;
+	};
+
+	//////////////////////////////////////////////////////////////////
+	//
+	//	書き込み
+	//
+	class IndexWriter
+	{
+	public:
+		template <class Type>
+		void write(const Type& value)
+		{
+			static_assert(std::is_trivially_copyable_v<Type>);
+			m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(Type));
+		}
+
+		void writeString(const StringView s)
+		{
+			const std::string utf8 = s.toUTF8();
+			write(static_cast<uint32>(utf8.size()));
+			m_buffer.append(utf8);
+		}
+
+		void writeStamp(const Optional<FileStamp>& stamp)
+		{
+			write(static_cast<uint8>(stamp.has_value()));
+			write(stamp ? stamp->writeTime : int64{ 0 });
+			write(stamp ? stamp->size : int64{ 0 });
+		}
+
+		[[nodiscard]]
+		const std::string& data() const { return m_buffer; }
+
+	private:
+		std::string m_buffer;
+	};
+
+	//////////////////////////////////////////////////////////////////
+	//
+	//	読み込み（範囲外を読もうとしたら以降はすべて失敗する）
+	//
+	class IndexReader
+	{
+	public:
+		explicit IndexReader(std::string_view data)
+			: m_data{ data } {}
+
+		template <class Type>
+		[[nodiscard]]
+		bool read(Type& value)
+		{
+			static_assert(std::is_trivially_copyable_v<Type>);
+
+			if ((m_data.size() - m_pos) < sizeof(Type))
+			{
+				m_pos = m_data.size();
+				return false;
+			}
+
+			std::memcpy(&value, (m_data.data() + m_pos), sizeof(Type));
+			m_pos += sizeof(Type);
+			return true;
+		}
+
+		[[nodiscard]]
+		bool readString(String& s)
+		{
+			uint32 size = 0;
+
+			if ((not read(size)) || ((m_data.size() - m_pos) < size))
+			{
+				m_pos = m_data.size();
+				return false;
+			}
+
+			s = Unicode::FromUTF8(m_data.substr(m_pos, size));
+			m_pos += size;
+			return true;
+		}
+
+		// 文字列を読んでインターンする（索引の中では文字列として持つ）
+		[[nodiscard]]
+		bool readAtom(Atom& atom)
+		{
+			String s;
+
+			if (not readString(s))
+			{
+				return false;
+			}
+
+			atom = Atom::Intern(s);
+			return true;
+		}
+
+		[[nodiscard]]
+		bool readStamp(Optional<FileStamp>& stamp)
+		{
+			uint8 hasStamp = 0;
+			FileStamp value;
+
+			if ((not read(hasStamp)) || (not read(value.writeTime)) || (not read(value.size)))
+			{
+				return false;
+			}
+
+			if (hasStamp)
+			{
+				stamp = value;
+			}
+			else
+			{
+				stamp.reset();
+			}
+
+			return true;
+		}
+
+	private:
+		std::string_view m_data;
+
+		size_t m_pos = 0;
+	};
+
+	FilePath GetRootPath(const FilePath& dimensionPath)
+	{
+		FilePath path = FileSystem::FullPath(dimensionPath);
+
+		while (path.ends_with(U'/'))
+		{
+			path.pop_back();
+		}
+
+		return path;
+	}
+
+	Optional<IndexData> ReadIndex(const FilePath& indexPath)
+	{
+		BinaryReader reader{ indexPath };
+
+		if (not reader)
+		{
+			return none;
+		}
+
+		std::string bytes(static_cast<size_t>(reader.size()), '\0');
+
+		if (reader.read(bytes.data(), static_cast<int64>(bytes.size())) != static_cast<int64>(bytes.size()))
+		{
+			return none;
+		}
+
+		IndexReader in{ bytes };
+		char magic[8] = {};
+		uint32 version = 0;
+
+		if ((not in.read(magic)) || (std::memcmp(magic, IndexMagic, sizeof(IndexMagic)) != 0)
+			|| (not in.read(version)) || (version != IndexVersion))
+		{
+			return none;
+		}
+
+		IndexData index;
+		uint32 roomCount = 0;
+
+		if ((not in.readStamp(index.rootStamp)) || (not in.readStamp(index.connectionsStamp)) || (not in.read(roomCount)))
+		{
+			return none;
+		}
+
+		for (uint32 i = 0; i < roomCount; ++i)
+		{
+			IndexedRoom room;
+			uint32 objectCount = 0;
+
+			if ((not in.readString(room.name)) || (not in.readStamp(room.directoryStamp)) || (not in.read(objectCount)))
+			{
+				return none;
+			}
+
+			for (uint32 k = 0; k < objectCount; ++k)
+			{
+				IndexedObject object;
+				uint8 flags = 0;
+
+				if ((not in.readString(object.fileName)) || (not in.read(flags)) || (not in.readStamp(object.stamp)))
+				{
+					return none;
+				}
+
+				if (flags & ObjectFlag_HasMetadata)
+				{
+					ObjectMetadata metadata;
+					uint64 hotspotCount = 0;
+
+					if ((not in.readString(metadata.name)) || (not in.readAtom(metadata.type)) || (not in.read(hotspotCount)))
+					{
+						return none;
+					}
+
+					if (flags & ObjectFlag_HasHotspotCount)
+					{
+						metadata.hotspotCount = static_cast<size_t>(hotspotCount);
+					}
+
+					object.metadata = std::move(metadata);
+				}
+
+				room.objects.push_back(std::move(object));
+			}
+
+			index.rooms.push_back(std::move(room));
+		}
+
+		return index;
+	}
+
+	// 更新日時とサイズが索引と一致するオブジェクトだけ、索引の概要を引き継ぐ
+	void CarryOverMetadata(const FilePath& roomPath, Array<FocusableObjectModel>& objects, const IndexedRoom& indexedRoom)
+	{
+		HashTable<String, const IndexedObject*> indexedObjects;
+
+		for (const auto& indexedObject : indexedRoom.objects)
+		{
+			if (indexedObject.metadata && indexedObject.stamp)
+			{
+				indexedObjects.emplace(indexedObject.fileName, &indexedObject);
+			}
+		}
+
+		if (indexedObjects.empty())
+		{
+			return;
+		}
+
+		for (auto& object : objects)
+		{
+			const auto it = indexedObjects.find(object.fileName);
+
+			if (it == indexedObjects.end())
+			{
+				continue;
+			}
+
+			if (FileStamp::Query(FileSystem::PathAppend(roomPath, object.fileName)) == it->second->stamp)
+			{
+				object.metadata = it->second->metadata;
+				object.metadataStamp = it->second->stamp;
+			}
+		}
+	}
+}
+
+namespace DimensionIndex
+{
+	FilePath GetIndexPath(const FilePath& dimensionPath)
+	{
+		return (GetRootPath(dimensionPath) + U".dimindex");
+	}
+
+	LoadResult LoadRooms(const FilePath& dimensionPath)
+	{
+		LoadResult result;
+
+		const FilePath rootPath = GetRootPath(dimensionPath);
+		const Optional<IndexData> index = ReadIndex(GetIndexPath(dimensionPath));
+
+		// 一覧を取る前に取る（一覧を取る間に変わった場合は、次に開くときに食い違いとして検出される）
+		result.rootStamp = FileStamp::Query(rootPath);
+		result.connectionsStamp = FileStamp::Query(FileSystem::PathAppend(rootPath, U"room_connections.json"));
+
+		// 次元フォルダ直下（部屋フォルダの追加・削除）と room_connections.json が変わっていなければ、部屋の構成は索引のまま
+		if (index
+			&& index->rootStamp
+			&& (result.rootStamp == index->rootStamp)
+			&& (result.connectionsStamp == index->connectionsStamp))
+		{
+			result.rooms.reserve(index->rooms.size());
+
+			for (const auto& indexedRoom : index->rooms)
+			{
+				const FilePath roomPath = FileSystem::PathAppend(rootPath, indexedRoom.name);
+				RoomModel room{ .name = indexedRoom.name, .objects = {}, .directoryStamp = FileStamp::Query(roomPath) };
+
+				if (room.directoryStamp == indexedRoom.directoryStamp)
+				{
+					// 一覧は索引のまま使い、内容が変わったファイルの概要だけを破棄する
+					room.objects.reserve(indexedRoom.objects.size());
+
+					for (const auto& indexedObject : indexedRoom.objects)
+					{
+						FocusableObjectModel object{ indexedObject.fileName };
+
+						if (indexedObject.metadata && indexedObject.stamp
+							&& (FileStamp::Query(FileSystem::PathAppend(roomPath, indexedObject.fileName)) == indexedObject.stamp))
+						{
+							object.metadata = indexedObject.metadata;
+							object.metadataStamp = indexedObject.stamp;
+						}
+
+						room.objects.push_back(std::move(object));
+					}
+				}
+				else
+				{
+					// ファイルの追加・削除・リネームがあった部屋だけを走査し直す
+					for (const auto& filePath : FileSystem::DirectoryContents(roomPath, Recursive::No))
+					{
+						if (FileSystem::Extension(filePath) == U"json")
+						{
+							room.objects.push_back({ FileSystem::FileName(filePath) });
+						}
+					}
+
+					CarryOverMetadata(roomPath, room.objects, indexedRoom);
+					++result.rescannedRoomCount;
+				}
+
+				result.rooms.push_back(std::move(room));
+			}
+
+			return result;
+		}
+
+		// 索引が使えないので次元全体を走査する（変わっていないファイルの概要は引き継ぐ）
+		result.rooms = DimensionLoader::LoadRooms(dimensionPath);
+		result.fullScan = true;
+
+		if (index)
+		{
+			HashTable<String, const IndexedRoom*> indexedRooms;
+
+			for (const auto& indexedRoom : index->rooms)
+			{
+				indexedRooms.emplace(indexedRoom.name, &indexedRoom);
+			}
+
+			for (auto& room : result.rooms)
+			{
+				if (const auto it = indexedRooms.find(room.name); it != indexedRooms.end())
+				{
+					CarryOverMetadata(FileSystem::PathAppend(rootPath, room.name), room.objects, *it->second);
+				}
+			}
+		}
+
+		return result;
+	}
+
+	bool Save(const FilePath& dimensionPath, const Optional<FileStamp>& rootStamp, const Optional<FileStamp>& connectionsStamp, const Array<RoomModel>& rooms)
+	{
+		const FilePath rootPath = GetRootPath(dimensionPath);
+
+		// 今の更新日時を書くと、一覧を取った後に追加されたファイルを見逃すので、一覧を取った時点の値を書く
+		IndexWriter out;
+		out.write(IndexMagic);
+		out.write(IndexVersion);
+		out.writeStamp(rootStamp);
+		out.writeStamp(connectionsStamp);
+		out.write(static_cast<uint32>(rooms.size()));
+
+		for (const auto& room : rooms)
+		{
+			const FilePath roomPath = FileSystem::PathAppend(rootPath, room.name);
+
+			out.writeString(room.name);
+			out.writeStamp(room.directoryStamp);
+			out.write(static_cast<uint32>(room.objects.size()));
+
+			for (const auto& object : room.objects)
+			{
+				// 概要は読んだ時点の更新日時と組にして書く（今の更新日時を書くと、読んだ後の変更を見逃す）
+				const bool hasMetadata = (object.metadata && object.metadataStamp);
+				const Optional<FileStamp> stamp = (hasMetadata ? object.metadataStamp : FileStamp::Query(FileSystem::PathAppend(roomPath, object.fileName)));
+
+				uint8 flags = 0;
+				if (hasMetadata) { flags |= ObjectFlag_HasMetadata; }
+				if (hasMetadata && object.metadata->hotspotCount) { flags |= ObjectFlag_HasHotspotCount; }
+
+				out.writeString(object.fileName);
+				out.write(flags);
+				out.writeStamp(stamp);
+
+				if (hasMetadata)
+				{
+					out.writeString(object.metadata->name);
+					out.writeString(object.metadata->type.str());
+					out.write(static_cast<uint64>(object.metadata->hotspotCount.value_or(0)));
+				}
+			}
+		}
+
+		// 書き込み途中の索引が残らないよう、一時ファイルに書いてから置き換える
+		const FilePath indexPath = GetIndexPath(dimensionPath);
+		const FilePath tempPath = (indexPath + U".saving");
+		{
+			BinaryWriter writer{ tempPath };
+
+			if (not writer)
+			{
+				return false;
+			}
+
+			const std::string& data = out.data();
+
+			if (writer.write(data.data(), static_cast<int64>(data.size())) != static_cast<int64>(data.size()))
+			{
+				writer.close();
+				FileSystem::Remove(tempPath);
+				return false;
+			}
+		}
+
+		if (not SyncFile(tempPath))
+		{
+			FileSystem::Remove(tempPath);
+			return false;
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(std::filesystem::path{ tempPath.str() }, std::filesystem::path{ indexPath.str() }, ec);
+
+		if (ec)
+		{
+			FileSystem::Remove(tempPath);
+			return false;
+		}
+
+		return true;
+	}
+}
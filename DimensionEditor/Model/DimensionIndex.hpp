@@ -0,0 +1,42 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include "DimensionModel.hpp"
+
+// 次元フォルダの横に置く索引ファイル（<次元フォルダ名>.dimindex）
+//
+// 部屋とオブジェクトの一覧、各ファイルの更新日時とサイズ、オブジェクトの概要を保存しておき、
+// 次に開くときは stat だけで検証して、フォルダの更新日時が変わった部屋だけを走査し直す
+// （索引は次元フォルダの外に置くので、書き込んでも次元フォルダの更新日時は変わらない）
+namespace DimensionIndex
+{
+	struct LoadResult
+	{
+		Array<RoomModel> rooms;
+
+		// 部屋の一覧を取る直前の次元フォルダと room_connections.json の更新日時とサイズ（Save にそのまま渡す）
+		Optional<FileStamp> rootStamp;
+
+		Optional<FileStamp> connectionsStamp;
+
+		// 索引が使えず、次元全体を走査した
+		bool fullScan = false;
+
+		// 走査し直した部屋の数
+		size_t rescannedRoomCount = 0;
+
+		// 索引の内容と異なっていた（索引を書き直すべき）
+		[[nodiscard]]
+		bool isStale() const { return (fullScan || (0 < rescannedRoomCount)); }
+	};
+
+	[[nodiscard]]
+	FilePath GetIndexPath(const FilePath& dimensionPath);
+
+	// 索引を使って部屋の一覧を作る（索引がない・壊れている・部屋の構成が変わった場合は次元全体を走査する）
+	[[nodiscard]]
+	LoadResult LoadRooms(const FilePath& dimensionPath);
+
+	// 現在の部屋の一覧と、取得済みのオブジェクトの概要を索引に書き出す
+	// 更新日時は書き出す時点では取らず、一覧を取った時点の値（rootStamp, connectionsStamp, RoomModel::directoryStamp）を書く
+	bool Save(const FilePath& dimensionPath, const Optional<FileStamp>& rootStamp, const Optional<FileStamp>& connectionsStamp, const Array<RoomModel>& rooms);
+}
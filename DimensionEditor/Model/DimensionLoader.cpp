@@ -0,0 +1,177 @@
+﻿#include "DimensionLoader.hpp"
+
+namespace
+{
+	// 走査対象の部屋
+	struct RoomSource
+	{
+		String name;
+		FilePath directory;
+		bool hasDirectory = false;
+	};
+
+	// 1部屋分の走査結果（ログはワーカースレッドから出さず、メインスレッドでまとめて出力する）
+	struct RoomScanResult
+	{
+		RoomModel room;
+		Array<String> warnings;
+	};
+
+	RoomScanResult ScanRoom(const RoomSource& source)
+	{
+		RoomScanResult result;
+		result.room.name = source.name;
+
+		if (not source.hasDirectory)
+		{
+			result.warnings.push_back(U"⚠️ Warning: Room defined in JSON but directory not found: " + source.name);
+			return result;
+		}
+
+		// 一覧を取る前に取る（走査中に追加されたファイルは、次に開くときに食い違いとして検出される）
+		result.room.directoryStamp = FileStamp::Query(source.directory);
+
+		// 部屋のフォルダ直下の.jsonファイル（オブジェクト）を探す
+		for (const auto& filePath : FileSystem::DirectoryContents(source.directory, Recursive::No))
+		{
+			if (FileSystem::Extension(filePath) != U"json")
+			{
+				continue;
+			}
+
+			String fileName = FileSystem::FileName(filePath);
+
+			if (fileName.isEmpty())
+			{
+				result.warnings.push_back(U"⚠️ Warning: Found a JSON file with an empty name in room directory: " + source.directory);
+				continue;
+			}
+
+			result.room.objects.push_back({ std::move(fileName) });
+		}
+
+		return result;
+	}
+
+	// 走査対象の部屋を列挙する（次元フォルダ直下の列挙は1回だけ）
+	Array<RoomSource> EnumerateRooms(const FilePath& dimensionPath)
+	{
+		// 次元フォルダ直下にある部屋フォルダ
+		HashTable<String, FilePath> directories;
+		Array<String> directoryOrder;
+
+		for (const auto& path : FileSystem::DirectoryContents(dimensionPath, Recursive::No))
+		{
+			if (FileSystem::IsDirectory(path))
+			{
+				String roomName = FileSystem::BaseName(path);
+				directoryOrder.push_back(roomName);
+				directories.emplace(std::move(roomName), path);
+			}
+		}
+
+		Array<RoomSource> sources;
+		HashSet<String> listedRoomNames;
+
+		// room_connections.json に記載された部屋を優先
+		const FilePath connectionsPath = FileSystem::PathAppend(dimensionPath, U"room_connections.json");
+		const JSON connections = JSON::Load(connectionsPath);
+
+		if (connections && connections.hasElement(U"rooms") && connections[U"rooms"].isObject())
+		{
+			for (const JSONItem& roomPair : connections[U"rooms"])
+			{
+				if (roomPair.key.isEmpty())
+				{
+					continue;
+				}
+
+				RoomSource source;
+				source.name = roomPair.key;
+
+				if (auto it = directories.find(source.name); it != directories.end())
+				{
+					source.directory = it->second;
+					source.hasDirectory = true;
+				}
+
+				listedRoomNames.insert(source.name);
+				sources.push_back(std::move(source));
+			}
+		}
+
+		// JSONに記載がない（またはJSON自体がない）フォルダを追加
+		for (const auto& roomName : directoryOrder)
+		{
+			if (not listedRoomNames.contains(roomName))
+			{
+				sources.push_back({ .name = roomName, .directory = directories[roomName], .hasDirectory = true });
+			}
+		}
+
+		return sources;
+	}
+}
+
+namespace DimensionLoader
+{
+	Array<RoomModel> LoadRooms(const FilePath& dimensionPath, size_t workerCount)
+	{
+		const Array<RoomSource> sources = EnumerateRooms(dimensionPath);
+
+		if (workerCount == 0)
+		{
+			workerCount = Max<size_t>(Threading::GetConcurrency(), 1);
+		}
+		workerCount = Min(workerCount, sources.size());
+
+		// 結果は部屋のインデックスに直接書き込むので、スレッドの実行順に関係なく順序が決まる
+		Array<RoomScanResult> results(sources.size());
+
+		if (workerCount <= 1)
+		{
+			for (size_t i = 0; i < sources.size(); ++i)
+			{
+				results[i] = ScanRoom(sources[i]);
+			}
+		}
+		else
+		{
+			std::atomic<size_t> nextIndex{ 0 };
+
+			const auto worker = [&]()
+				{
+					for (size_t i = nextIndex++; i < sources.size(); i = nextIndex++)
+					{
+						results[i] = ScanRoom(sources[i]);
+					}
+				};
+
+			Array<AsyncTask<void>> tasks;
+			for (size_t i = 0; i < workerCount; ++i)
+			{
+				tasks.push_back(Async(worker));
+			}
+
+			for (auto& task : tasks)
+			{
+				task.get();
+			}
+		}
+
+		Array<RoomModel> rooms;
+		rooms.reserve(results.size());
+
+		for (auto& result : results)
+		{
+			for (const auto& warning : result.warnings)
+			{
+				Logger << warning;
+			}
+
+			rooms.push_back(std::move(result.room));
+		}
+
+		return rooms;
+	}
+}
@@ -0,0 +1,12 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include "DimensionModel.hpp"
+
+namespace DimensionLoader
+{
+	// 次元フォルダを走査して部屋の一覧を作る
+	// 部屋ごとのフォルダ走査はワーカースレッドで並列に行い、結果は常に同じ順序で返す
+	// （room_connections.json に記載された順 → フォルダのみ存在する部屋の順）
+	// workerCount が 0 の場合は論理コア数を使う
+	Array<RoomModel> LoadRooms(const FilePath& dimensionPath, size_t workerCount = 0);
+}
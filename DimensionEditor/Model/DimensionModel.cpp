@@ -1,5 +1,10 @@
 ﻿#include "DimensionModel.hpp"
-#include "../SchemaManager.hpp"
+#include "DimensionIndex.hpp"
+#include "DimensionPack.hpp"
+#include "JsonHeaderScanner.hpp"
+#include "JsonStreamWriter.hpp"
+#include "SchemaRegistry.hpp"
+#include "TemplateService.hpp"
 
 namespace
 {
@@ -19,57 +24,45 @@ namespace
 
 		return path;
 	}
-}
 
-JSON CreateTemplateFromSchema(const Schema& schema)
-{
-	JSON newJson;
-	for (const auto& propPair : schema)
+	// パック内の仮想パス（<パック>/部屋名/ファイル名）の文書をパースする
+	JSON LoadFromPack(const DimensionPack& pack, const FilePath& rootPath, const FilePath& path)
 	{
-		const auto& key = propPair.first;
-		const auto& prop = propPair.second;
+		if (not path.starts_with(rootPath))
+		{
+			return JSON::Invalid();
+		}
 
-		switch (prop.type)
+		const Array<String> parts = path.substr(rootPath.size()).split(U'/')
+			.removed_if([](const String& part) { return part.isEmpty(); });
+
+		Optional<std::string_view> bytes;
+
+		if ((parts.size() == 1) && (parts[0] == U"room_connections.json"))
 		{
-		case JSONValueType::String:
-			newJson[key] = U"";
-			break;
-		case JSONValueType::Number:
-			newJson[key] = 0;
-			break;
-		case JSONValueType::Bool:
-			newJson[key] = false;
-			break;
-		case JSONValueType::Array:
-			newJson[key] = Array<JSON>();
-			break;
-		case JSONValueType::Object:
-			// 子スキーマが定義されていれば、再帰的にテンプレートを生成
-			if (prop.childSchema)
-			{
-				newJson[key] = CreateTemplateFromSchema(*prop.childSchema);
-			}
-			else
-			{
-				newJson[key] = JSON();
-			}
-			break;
-		default:
-			newJson[key] = JSON(); // Null
-			break;
+			bytes = pack.getConnections();
+		}
+		else if (parts.size() == 2)
+		{
+			bytes = pack.findFile(parts[0], parts[1]);
+		}
+
+		if (not bytes)
+		{
+			return JSON::Invalid();
 		}
+
+		return JSON::Load(MemoryViewReader{ bytes->data(), bytes->size() });
 	}
-	return newJson;
 }
 
-
 JSON GetFocusableTemplate(const String& objectType)
 {
 	// objectTypeに一致するスキーマを取得
-	if (auto schema = GetSchema(objectType))
+	if (const CompiledSchema* schema = SchemaRegistry::Find(objectType))
 	{
-		// 取得したスキーマからテンプレートを自動生成
-		return CreateTemplateFromSchema(schema.value());
+		// スキーマの雛形をコピーする（雛形はスキーマごとに1回だけ作る）
+		return TemplateService::Create(schema->handle);
 	}
 
 	// 不明な種類の場合は空のオブジェクトを返す
@@ -79,13 +72,23 @@ JSON GetFocusableTemplate(const String& objectType)
 
 
 DimensionModel::DimensionModel()
+	: m_saveQueue{ [this](const FilePath& path, const JSON& json) { m_documentCache.store(path, json); } }
+{
+}
+
+DimensionModel::~DimensionModel()
 {
+	// 取得済みのオブジェクトの概要を次回に引き継ぐ
+	// （保存の完了を待ち、書き換えたファイルの概要は破棄してから記録する。概要は読んだ時点の更新日時で記録される）
+	m_saveQueue.flush();
+	applySaveResults();
+	saveIndex();
 }
 
 void DimensionModel::CreateNew(const FilePath& baseDir, const String& dimensionName)
 {
-	m_currentDimensionPath = FileSystem::PathAppend(baseDir, dimensionName);
-	if (FileSystem::Exists(m_currentDimensionPath))
+	const FilePath dimensionPath = FileSystem::PathAppend(baseDir, dimensionName);
+	if (FileSystem::Exists(dimensionPath))
 	{
 		// 既に存在する場合は何もしない
 		Logger << U"Dimension '{}' already exists."_fmt(dimensionName);
@@ -99,7 +102,7 @@ void DimensionModel::CreateNew(const FilePath& baseDir, const String& dimensionN
 
 	for (const auto& roomName : defaultRooms)
 	{
-		FileSystem::CreateDirectories(FileSystem::PathAppend(m_currentDimensionPath, roomName));
+		FileSystem::CreateDirectories(FileSystem::PathAppend(dimensionPath, roomName));
 	}
 
 	// room_connections.json のテンプレートを生成
@@ -157,11 +160,11 @@ void DimensionModel::CreateNew(const FilePath& baseDir, const String& dimensionN
 	};
 
 	// ファイルに保存
-	const FilePath jsonPath = FileSystem::PathAppend(m_currentDimensionPath, U"room_connections.json");
-	connectionsJson.save(jsonPath);
+	const FilePath jsonPath = FileSystem::PathAppend(dimensionPath, U"room_connections.json");
+	JsonStreamWriter::Save(connectionsJson, jsonPath);
 
 	// 作成したDimensionをエディタに読み込む
-	Load(m_currentDimensionPath + U"/");
+	Load(dimensionPath + U"/");
 }
 void DimensionModel::Load(const FilePath& dimensionPath)
 {
@@ -169,92 +172,306 @@ void DimensionModel::Load(const FilePath& dimensionPath)
 		return;
 	}
 
+	// 前に開いていた次元の索引を更新しておく
+	saveIndex();
+
+	m_pack.reset();
 	m_currentDimensionPath = dimensionPath;
 	m_dimensionName = GetFolderNameFromPath(dimensionPath);
-	m_rooms.clear();
 
-	// ロード済みの部屋名を記録するセット
-	HashSet<String> loadedRoomNames;
+	// 索引があれば、フォルダの更新日時が変わった部屋だけを走査する
+	// （索引が使えない場合は、部屋フォルダの走査をワーカースレッドで並列に行う）
+	DimensionIndex::LoadResult result = DimensionIndex::LoadRooms(dimensionPath);
+	m_rooms = std::move(result.rooms);
+	m_rootStamp = result.rootStamp;
+	m_connectionsStamp = result.connectionsStamp;
+	++m_revision;
+
+	if (result.isStale())
+	{
+		DimensionIndex::Save(dimensionPath, m_rootStamp, m_connectionsStamp, m_rooms);
+	}
+
+	// 以降の変更は監視して差分だけを反映する
+	m_watcher.start(dimensionPath);
+}
+
+void DimensionModel::LoadPack(const FilePath& packPath)
+{
+	auto pack = std::make_shared<DimensionPack>();
+
+	if (not pack->open(packPath))
+	{
+		Logger << U"🚨 Failed to open dimension pack: " << packPath;
+		return;
+	}
+
+	saveIndex();
+
+	// パックの内容は変化しないので監視は不要
+	m_watcher.stop();
+
+	m_currentDimensionPath = (FileSystem::FullPath(packPath) + U"/");
+	m_dimensionName = FileSystem::BaseName(packPath);
+	m_rooms = pack->makeRooms();
+	m_rootStamp.reset();
+	m_connectionsStamp.reset();
+	m_pack = std::move(pack);
+	++m_revision;
+}
+
+void DimensionModel::update()
+{
+	for (auto& change : m_watcher.retrieveChanges())
+	{
+		applyChange(change);
+		m_changes.push_back(std::move(change));
+	}
 
-	// room_connections.json を優先してロード
-	const FilePath connectionsPath = FileSystem::PathAppend(dimensionPath, U"room_connections.json");
-	const JSON connections = JSON::Load(connectionsPath);
+	applySaveResults();
+}
 
-	// connectionsが存在し、かつ"rooms"要素を持っている場合
-	if (connections && connections.hasElement(U"rooms") && connections[U"rooms"].isObject())
+void DimensionModel::applySaveResults()
+{
+	for (auto& result : m_saveQueue.takeResults())
 	{
-		for (const JSONItem& roomPair : connections[U"rooms"])
+		if (result.succeeded)
 		{
-			if (roomPair.key.isEmpty())
-			{
-				continue;
-			}
+			Logger << U"✅ Saved: {} ({} request(s))"_fmt(result.path, result.requestCount);
+			resetMetadata(m_currentDimensionPath, result.path);
+		}
+		else
+		{
+			Logger << U"🚨 Failed to save: {} ({})"_fmt(result.path, result.error);
+		}
+
+		m_saveResults.push_back(std::move(result));
+	}
+}
 
-			RoomModel currentRoom;
-			currentRoom.name = roomPair.key;
-			const FilePath roomDirectory = FileSystem::PathAppend(dimensionPath, currentRoom.name);
+void DimensionModel::applyChange(const DimensionChange& change)
+{
+	const FilePath& rootPath = m_watcher.getRootPath();
 
-			// フォルダが存在するか確認
-			if (FileSystem::IsDirectory(roomDirectory))
+	if (not change.path.starts_with(rootPath))
+	{
+		return;
+	}
+
+	// 次元フォルダからの相対パスを 部屋名 / ファイル名 に分解
+	const Array<String> parts = change.path.substr(rootPath.size()).split(U'/')
+		.removed_if([](const String& part) { return part.isEmpty(); });
+
+	// 削除されたファイルのキャッシュは破棄する
+	// （内容の変更はキャッシュ側が更新日時とサイズで検出する。保存直後に登録した内容を捨てないよう、ここでは破棄しない）
+	if (change.kind == DimensionChange::Kind::Removed)
+	{
+		m_documentCache.invalidate(change.path);
+	}
+
+	if (parts.size() == 1)
+	{
+		// 次元フォルダ直下: 部屋フォルダの追加・削除
+		if (change.kind == DimensionChange::Kind::Added)
+		{
+			if (FileSystem::IsDirectory(change.path))
+			{
+				addRoom(parts[0]);
+			}
+		}
+		else if (change.kind == DimensionChange::Kind::Removed)
+		{
+			removeRoom(parts[0]);
+		}
+	}
+	else if ((parts.size() == 2) && (FileSystem::Extension(parts[1]) == U"json"))
+	{
+		// 部屋フォルダ直下: オブジェクトの追加・削除
+		if (change.kind == DimensionChange::Kind::Added)
+		{
+			addObject(parts[0], parts[1]);
+			resetMetadata(rootPath, change.path);
+		}
+		else if (change.kind == DimensionChange::Kind::Modified)
+		{
+			resetMetadata(rootPath, change.path);
+		}
+		else if (change.kind == DimensionChange::Kind::Removed)
+		{
+			// 保存時のリネームによる置き換えでも削除が通知されるので、実際に消えたか確認する
+			if (not FileSystem::Exists(change.path))
 			{
-				// 部屋のフォルダ内の.jsonファイル（オブジェクト）を探す
-				for (const auto& filePath : FileSystem::DirectoryContents(roomDirectory))
-				{
-					if (FileSystem::Extension(filePath) == U"json")
-					{
-						const String fileName = FileSystem::FileName(filePath);
-
-						if (not fileName.isEmpty())
-						{
-							currentRoom.objects.push_back({ fileName });
-						}
-						else
-						{
-							// 例外を投げる代わりにログ出力に変更
-							Logger << U"⚠️ Warning: Found a JSON file with an empty name in room directory: " + roomDirectory;
-						}
-					}
-				}
+				removeObject(parts[0], parts[1]);
 			}
-			else
+		}
+	}
+}
+
+RoomModel* DimensionModel::findRoom(const String& roomName)
+{
+	for (auto& room : m_rooms)
+	{
+		if (room.name == roomName)
+		{
+			return &room;
+		}
+	}
+
+	return nullptr;
+}
+
+void DimensionModel::addRoom(const String& roomName)
+{
+	if (roomName.isEmpty() || findRoom(roomName))
+	{
+		return;
+	}
+
+	// 既にファイルが入ったフォルダが移動・リネームされてきた場合に備えて、その部屋だけを走査する
+	// （次元フォルダの更新日時は取り直さないので、次に開くときは部屋の構成を走査し直す）
+	const FilePath roomPath = FileSystem::PathAppend(m_currentDimensionPath, roomName);
+	RoomModel room{ .name = roomName, .objects = {}, .directoryStamp = FileStamp::Query(roomPath) };
+
+	for (const auto& filePath : FileSystem::DirectoryContents(roomPath, Recursive::No))
+	{
+		if (FileSystem::Extension(filePath) == U"json")
+		{
+			room.objects.push_back({ FileSystem::FileName(filePath) });
+		}
+	}
+
+	m_rooms.push_back(std::move(room));
+	++m_revision;
+}
+
+void DimensionModel::removeRoom(const String& roomName)
+{
+	const size_t roomCount = m_rooms.size();
+
+	m_rooms.remove_if([&](const RoomModel& room) { return (room.name == roomName); });
+
+	if (m_rooms.size() != roomCount)
+	{
+		++m_revision;
+	}
+}
+
+const ObjectMetadata& DimensionModel::getObjectMetadata(const size_t roomIndex, const size_t objectIndex)
+{
+	const RoomModel& room = m_rooms[roomIndex];
+	FocusableObjectModel& object = m_rooms[roomIndex].objects[objectIndex];
+
+	if (not object.metadata)
+	{
+		Optional<ObjectMetadata> metadata;
+		Optional<FileStamp> stamp;
+
+		if (m_pack)
+		{
+			if (const auto bytes = m_pack->findFile(room.name, object.fileName))
 			{
-				Logger << U"⚠️ Warning: Room defined in JSON but directory not found: " << currentRoom.name;
+				metadata = JsonHeaderScanner::ScanObjectMetadata(*bytes);
 			}
+		}
+		else
+		{
+			const FilePath path = FileSystem::PathAppend(FileSystem::PathAppend(m_currentDimensionPath, room.name), object.fileName);
 
-			m_rooms.push_back(currentRoom);
-			loadedRoomNames.insert(currentRoom.name);
+			// 走査の前に取る（走査中に書き換えられた場合は、次に開くときに食い違いとして検出される）
+			stamp = FileStamp::Query(path);
+			metadata = JsonHeaderScanner::ScanFile(path);
 		}
+
+		// 読めなかったファイルも毎フレーム読み直さないよう、空の概要を記録する
+		object.metadata = metadata.value_or(ObjectMetadata{});
+		object.metadataStamp = stamp;
+	}
+
+	return *object.metadata;
+}
+
+void DimensionModel::resetMetadata(const FilePath& rootPath, const FilePath& path)
+{
+	if (not path.starts_with(rootPath))
+	{
+		return;
 	}
 
-	// ディレクトリをスキャンし、まだロードされていない（JSONに記載がない、またはJSON自体がない）フォルダがあれば追加
-	for (const auto& path : FileSystem::DirectoryContents(dimensionPath))
+	const Array<String> parts = path.substr(rootPath.size()).split(U'/')
+		.removed_if([](const String& part) { return part.isEmpty(); });
+
+	if (parts.size() != 2)
 	{
-		if (FileSystem::IsDirectory(path))
+		return;
+	}
+
+	if (RoomModel* room = findRoom(parts[0]))
+	{
+		for (auto& object : room->objects)
 		{
-			const String roomName = FileSystem::BaseName(path);
-			// まだロードされていなければ追加
-			if (not loadedRoomNames.contains(roomName))
+			if (object.fileName == parts[1])
 			{
-				RoomModel currentRoom;
-				currentRoom.name = roomName;
-
-				// フォルダの中の.jsonファイルを探す
-				for (const auto& filePath : FileSystem::DirectoryContents(path))
-				{
-					if (FileSystem::Extension(filePath) == U"json")
-					{
-						currentRoom.objects.push_back({ FileSystem::FileName(filePath) });
-					}
-				}
-				m_rooms.push_back(currentRoom);
+				object.metadata.reset();
+				object.metadataStamp.reset();
+				++m_metadataRevision;
+				return;
 			}
 		}
 	}
 }
 
+void DimensionModel::saveIndex()
+{
+	if ((not isDimensionLoaded()) || isReadOnly())
+	{
+		return;
+	}
+
+	if (not DimensionIndex::Save(m_currentDimensionPath, m_rootStamp, m_connectionsStamp, m_rooms))
+	{
+		Logger << U"⚠️ Warning: Failed to write dimension index: " << DimensionIndex::GetIndexPath(m_currentDimensionPath);
+	}
+}
+
+void DimensionModel::addObject(const String& roomName, const String& fileName)
+{
+	RoomModel* room = findRoom(roomName);
+
+	if (not room)
+	{
+		return;
+	}
+
+	for (const auto& object : room->objects)
+	{
+		if (object.fileName == fileName)
+		{
+			return;
+		}
+	}
+
+	room->objects.push_back({ fileName });
+	++m_revision;
+}
+
+void DimensionModel::removeObject(const String& roomName, const String& fileName)
+{
+	if (RoomModel* room = findRoom(roomName))
+	{
+		const size_t objectCount = room->objects.size();
+
+		room->objects.remove_if([&](const FocusableObjectModel& object) { return (object.fileName == fileName); });
+
+		if (room->objects.size() != objectCount)
+		{
+			++m_revision;
+		}
+	}
+}
+
 void DimensionModel::CreateNewFocusableFile(const String& roomName, const String& fileName)
 {
-	if (m_currentDimensionPath.isEmpty())
+	if (m_currentDimensionPath.isEmpty() || isReadOnly())
 	{
 		return;
 	}
@@ -271,10 +488,12 @@ void DimensionModel::CreateNewFocusableFile(const String& roomName, const String
 	const String objectType = FileSystem::BaseName(fileName);
 	JSON templateJson = GetFocusableTemplate(objectType);
 
-	if (templateJson.save(newFilePath))
+	if (JsonStreamWriter::Save(templateJson, newFilePath))
 	{
 		Logger << U"✅ Created new focusable file: " << newFilePath;
-		Load(m_currentDimensionPath);
+
+		// 次元全体を読み直さず、作成したファイルだけをモデルに追加する
+		addObject(roomName, fileName);
 	}
 	else
 	{
@@ -284,19 +503,16 @@ void DimensionModel::CreateNewFocusableFile(const String& roomName, const String
 
 void DimensionModel::AddNewRoom(const String& roomName)
 {
-	if (m_currentDimensionPath.isEmpty() || roomName.isEmpty())
+	if (m_currentDimensionPath.isEmpty() || roomName.isEmpty() || isReadOnly())
 	{
 		return;
 	}
 
 	// 既に同じ名前の部屋がないか確認
-	for (const auto& room : m_rooms)
+	if (findRoom(roomName))
 	{
-		if (room.name == roomName)
-		{
-			Logger << U"Room '{}' already exists in model."_fmt(roomName);
-			return;
-		}
+		Logger << U"Room '{}' already exists in model."_fmt(roomName);
+		return;
 	}
 
 	// 1. ディスク上に新しいフォルダを作成
@@ -307,7 +523,7 @@ void DimensionModel::AddNewRoom(const String& roomName)
 	}
 
 	// 2. メモリ上の部屋リストに追加
-	m_rooms.push_back({ .name = roomName, .objects = {} });
+	addRoom(roomName);
 }
 
 void DimensionModel::saveJsonForPath(const FilePath& path, const JSON& jsonData)
@@ -317,27 +533,91 @@ void DimensionModel::saveJsonForPath(const FilePath& path, const JSON& jsonData)
 		return;
 	}
 
-	if (jsonData.save(path))
+	if (isReadOnly())
 	{
-		Logger << U"✅ Saved: " << path;
+		m_saveResults.push_back({ .path = path, .succeeded = false, .error = U"dimension pack is read-only", .requestCount = 1 });
+		return;
 	}
-	else
+
+	// 書き込みはワーカースレッドで行い、書き込みが終わった内容はキャッシュに登録される
+	m_saveQueue.enqueue(path, jsonData);
+}
+
+JSON DimensionModel::loadDocument(const FilePath& path)
+{
+	if (m_pack)
 	{
-		Logger << U"🚨 Failed to save: " << path;
+		return LoadFromPack(*m_pack, m_currentDimensionPath, path);
 	}
+
+	return m_documentCache.load(path);
 }
 
-void DimensionModel::addHotspot(const FilePath& targetJsonPath, const JSON& newHotspot)
+Array<FilePath> DimensionModel::getDocumentPaths() const
 {
-	if (targetJsonPath.isEmpty() || not FileSystem::Exists(targetJsonPath))
+	if (m_currentDimensionPath.isEmpty())
 	{
-		return;
+		return{};
 	}
 
-	JSON targetJson = JSON::Load(targetJsonPath);
+	Array<FilePath> paths{ m_currentDimensionPath + U"room_connections.json" };
+
+	for (const auto& room : m_rooms)
+	{
+		for (const auto& object : room.objects)
+		{
+			paths.push_back(m_currentDimensionPath + U"/" + room.name + U"/" + object.fileName);
+		}
+	}
+
+	return paths;
+}
+
+std::function<JSON(const FilePath&)> DimensionModel::makeDocumentReader() const
+{
+	if (m_pack)
+	{
+		return [pack = m_pack, rootPath = m_currentDimensionPath](const FilePath& path)
+			{
+				return LoadFromPack(*pack, rootPath, path);
+			};
+	}
+
+	// 検証などで次元全体を読むときに、エディタで使う文書をキャッシュから追い出さないよう、キャッシュは通さない
+	return [](const FilePath& path)
+		{
+			const Blob blob{ path };
+			return JSON::Load(MemoryViewReader{ blob.data(), blob.size() });
+		};
+}
+
+DocumentLoadHandle DimensionModel::loadDocumentAsync(const FilePath& path)
+{
+	auto cancelled = std::make_shared<std::atomic<bool>>(false);
+
+	// キャッシュはスレッドセーフなので、ワーカーから直接読み込んでよい
+	// パックは読み込み中に別の次元が開かれても解放されないよう、ワーカーが参照を持つ
+	// 保存済みの内容のハッシュもワーカーで計算しておく
+	AsyncTask<std::shared_ptr<EditorDocument>> task = Async([this, path, cancelled, pack = m_pack, rootPath = m_currentDimensionPath]()
+		{
+			if (*cancelled)
+			{
+				return std::shared_ptr<EditorDocument>{};
+			}
+
+			JSON json = (pack ? LoadFromPack(*pack, rootPath, path) : m_documentCache.load(path));
+
+			return std::make_shared<EditorDocument>(path, std::move(json));
+		});
+
+	return{ path, std::move(task), std::move(cancelled) };
+}
+
+bool DimensionModel::addHotspot(JSON& targetJson, const JSON& newHotspot)
+{
 	if (not targetJson)
 	{
-		return;
+		return false;
 	}
 
 	// "hotspots" 配列がなければ作成
@@ -350,7 +630,8 @@ void DimensionModel::addHotspot(const FilePath& targetJsonPath, const JSON& newH
 	if (targetJson[U"hotspots"].isArray())
 	{
 		targetJson[U"hotspots"].push_back(newHotspot);
-		// ファイルに保存
-		saveJsonForPath(targetJsonPath, targetJson);
+		return true;
 	}
+
+	return false;
 }
@@ -1,10 +1,34 @@
 ﻿#pragma once
 #include <Siv3D.hpp>
+#include "DimensionWatcher.hpp"
+#include "JsonDocumentCache.hpp"
+#include "DocumentLoadHandle.hpp"
+#include "SaveQueue.hpp"
+#include "Atom.hpp"
+#include "FileStamp.hpp"
+
+class DimensionPack;
+
+// 階層表示用のオブジェクトの概要（ファイルの先頭レベルだけを読んで得る）
+struct ObjectMetadata
+{
+	String name; // "name"
+
+	Atom type; // "type"（なければ空。種類の名前は多くのオブジェクトで同じなので、インターンして持つ）
+
+	Optional<size_t> hotspotCount; // "hotspots" 配列の要素数
+};
 
 // Forcusableオブジェクトのデータ構造
 struct FocusableObjectModel
 {
 	String fileName; // 例: "Lockbox.json"
+
+	// 初めて必要になったときに読み込み、ファイルが変更されたら破棄する
+	Optional<ObjectMetadata> metadata;
+
+	// metadata を読んだ時点のファイルの更新日時とサイズ（索引にはこの値を書き、次に開くときに照合する）
+	Optional<FileStamp> metadataStamp;
 };
 
 // ルームのデータ構造
@@ -12,6 +36,10 @@ struct RoomModel
 {
 	String name;
 	Array<FocusableObjectModel> objects;
+
+	// objects の一覧を取る直前の部屋フォルダの更新日時とサイズ（索引にはこの値を書く）
+	// 監視で一覧を差分だけ更新しても取り直さない（次に開くときに食い違いとして検出され、その部屋だけ走査し直す）
+	Optional<FileStamp> directoryStamp;
 };
 
 class DimensionModel
@@ -19,27 +47,126 @@ class DimensionModel
 public:
 	DimensionModel();
 
+	~DimensionModel();
+
 	void CreateNew(const FilePath& baseDir, const String& dimensionName);
 	void Load(const FilePath& dimensionPath);
 
+	// .dimpak を読み取り専用で開く（文書はマップしたファイルから直接パースする）
+	void LoadPack(const FilePath& packPath);
+
+	// ディスク上の変更を監視し、影響のある部屋だけを更新する（毎フレーム呼ぶ）
+	void update();
+
 	void CreateNewFocusableFile(const String& roomName, const String& fileName);
 
 	void AddNewRoom(const String& roomName);
 	
 	const String& getDimensionName() const { return m_dimensionName; }
 	const Array<RoomModel>& getRooms() const { return m_rooms; }
+
+	// 部屋とオブジェクトの構成が変わるたびに増える（次元の読み込み、部屋・オブジェクトの追加と削除）
+	// 表示のキャッシュは、この値が変わったときだけ作り直せばよい
+	[[nodiscard]]
+	uint64 getRevision() const noexcept { return m_revision; }
+
+	// オブジェクトの概要が破棄されるたびに増える（ファイルの変更・保存）
+	[[nodiscard]]
+	uint64 getMetadataRevision() const noexcept { return m_metadataRevision; }
+
+	// オブジェクトの概要（初回だけファイルの先頭レベルを走査し、以降はキャッシュを返す）
+	const ObjectMetadata& getObjectMetadata(size_t roomIndex, size_t objectIndex);
 	bool isDimensionLoaded() const { return (not m_currentDimensionPath.isEmpty()); }
+	// .dimpak から開いた次元は保存やファイルの追加ができない
+	bool isReadOnly() const { return (m_pack != nullptr); }
+	// 保存はバックグラウンドで行う（結果は takeSaveResults() で受け取る）
 	void saveJsonForPath(const FilePath& path, const JSON& jsonData);
 
+	[[nodiscard]]
+	bool isSavePending(const FilePath& path) const { return m_saveQueue.isPending(path); }
+
+	// 待機中の保存がすべて書き終わるまで待つ
+	void flushSaves() { m_saveQueue.flush(); }
+
+	// 前回の呼び出し以降に完了した保存の結果
+	[[nodiscard]]
+	Array<SaveQueue::Result> takeSaveResults() { return std::exchange(m_saveResults, Array<SaveQueue::Result>{}); }
+
+	// 前回の呼び出し以降に update() で反映した、ディスク上の変更
+	[[nodiscard]]
+	Array<DimensionChange> takeChanges() { return std::exchange(m_changes, Array<DimensionChange>{}); }
+
+	// 次元のすべての文書のパス（room_connections.json と各部屋のオブジェクト。階層パネルと同じ形式）
+	[[nodiscard]]
+	Array<FilePath> getDocumentPaths() const;
+
+	// ワーカースレッドから文書を読む関数（キャッシュを通さない。パックから開いた次元はパックから読む）
+	// 返した関数は、別の次元を開いた後も元の次元を読む
+	[[nodiscard]]
+	std::function<JSON(const FilePath&)> makeDocumentReader() const;
+
 	const FilePath& getCurrentDimensionPath() const { return m_currentDimensionPath; }
 
-	void addHotspot(const FilePath& targetJsonPath, const JSON& newHotspot);
+	// メモリ上の文書に hotspot を追加する（保存は saveJsonForPath で別に行う）
+	bool addHotspot(JSON& targetJson, const JSON& newHotspot);
+
+	// JSONファイルを読み込む（変更のないファイルはキャッシュから返し、パースしない）
+	[[nodiscard]]
+	JSON loadDocument(const FilePath& path);
+
+	// JSONファイルをワーカースレッドで読み込み、編集用の文書として返す
+	[[nodiscard]]
+	DocumentLoadHandle loadDocumentAsync(const FilePath& path);
+
+	void setDocumentCacheBudget(size_t budgetBytes) { m_documentCache.setBudget(budgetBytes); }
+
+	[[nodiscard]]
+	JsonDocumentCache::Stats getDocumentCacheStats() const { return m_documentCache.getStats(); }
 
 
 
 private:
+	void applyChange(const DimensionChange& change);
+
+	RoomModel* findRoom(const String& roomName);
+
+	void addRoom(const String& roomName);
+
+	void removeRoom(const String& roomName);
+
+	void addObject(const String& roomName, const String& fileName);
+
+	void removeObject(const String& roomName, const String& fileName);
+
+	// 完了した保存の結果を記録し、保存したファイルの概要を破棄する
+	void applySaveResults();
+
+	// ファイルの内容が変わったオブジェクトの概要を破棄する（次に表示するときに読み直す）
+	void resetMetadata(const FilePath& rootPath, const FilePath& path);
+
+	// 開いている次元フォルダの索引（.dimindex）を書き出す
+	void saveIndex();
+
 	FilePath m_currentDimensionPath;
 	int m_dimensionId;
 	String m_dimensionName;
 	Array<RoomModel> m_rooms;
+
+	// m_rooms の部屋の一覧を取る直前の次元フォルダと room_connections.json の更新日時とサイズ（索引にはこの値を書く）
+	Optional<FileStamp> m_rootStamp;
+	Optional<FileStamp> m_connectionsStamp;
+
+	uint64 m_revision = 0;
+	uint64 m_metadataRevision = 0;
+	DimensionWatcher m_watcher;
+	JsonDocumentCache m_documentCache;
+
+	// 読み込み中のワーカーがマップを参照している間は閉じないよう、共有で持つ
+	std::shared_ptr<const DimensionPack> m_pack;
+
+	// m_documentCache を参照するので、それより後に宣言する（先に破棄され、待機中の保存を書き終える）
+	SaveQueue m_saveQueue;
+	Array<SaveQueue::Result> m_saveResults;
+
+	Array<DimensionChange> m_changes;
 };
@@ -0,0 +1,595 @@
+﻿#include <filesystem>
+#include "DimensionPack.hpp"
+#include "DimensionLoader.hpp"
+#include "FileSync.hpp"
+
+struct DimensionPack::Header
+{
+	char magic[8];
+
+	uint32 version;
+
+	uint32 roomCount;
+
+	uint32 objectCount;
+
+	uint32 flags;
+
+	uint64 stringsOffset;
+
+	uint64 stringsSize;
+
+	uint64 connectionsOffset;
+
+	uint64 connectionsSize;
+
+	uint64 reserved;
+};
+
+struct DimensionPack::RoomRecord
+{
+	uint32 nameOffset;
+
+	uint32 nameSize;
+
+	uint32 firstObject;
+
+	uint32 objectCount;
+
+	uint32 flags;
+
+	uint32 reserved;
+};
+
+struct DimensionPack::ObjectRecord
+{
+	uint32 nameOffset;
+
+	uint32 nameSize;
+
+	uint64 dataOffset;
+
+	uint64 dataSize;
+};
+
+namespace
+{
+	constexpr char PackMagic[8] = { 'D', 'I', 'M', 'P', 'A', 'K', '\0', '\0' };
+
+	constexpr uint32 PackVersion = 1;
+
+	constexpr uint32 HeaderFlag_HasConnections = 0x1;
+
+	constexpr uint32 RoomFlag_HasDirectory = 0x1;
+
+	// ファイルの内容は 8 バイト境界に揃えて格納する
+	constexpr uint64 DataAlignment = 8;
+
+	uint64 AlignUp(const uint64 value)
+	{
+		return ((value + (DataAlignment - 1)) / DataAlignment * DataAlignment);
+	}
+
+	bool WritePadding(BinaryWriter& writer)
+	{
+		constexpr Byte zeros[DataAlignment] = {};
+		const uint64 pos = static_cast<uint64>(writer.getPos());
+		const int64 padding = static_cast<int64>(AlignUp(pos) - pos);
+		return (writer.write(zeros, padding) == padding);
+	}
+
+	// ファイルの内容をそのまま書き込み、書き込んだバイト数を返す
+	Optional<uint64> CopyFileTo(BinaryWriter& writer, const FilePath& path)
+	{
+		BinaryReader reader{ path };
+
+		if (not reader)
+		{
+			return none;
+		}
+
+		Array<Byte> buffer(static_cast<size_t>(Min<int64>(reader.size(), (1 << 20))));
+		uint64 total = 0;
+
+		while (true)
+		{
+			const int64 read = reader.read(buffer.data(), static_cast<int64>(buffer.size()));
+
+			if (read <= 0)
+			{
+				break;
+			}
+
+			if (writer.write(buffer.data(), read) != read)
+			{
+				return none;
+			}
+
+			total += static_cast<uint64>(read);
+		}
+
+		return total;
+	}
+
+	// 展開先のフォルダの中に1階層だけ作れる名前か（空、"."、".."、区切り文字やドライブを含む名前は、フォルダの外を指しうる）
+	bool IsSafeEntryName(const std::string_view name)
+	{
+		if (name.empty() || (name == ".") || (name == ".."))
+		{
+			return false;
+		}
+
+		return (name.find_first_of(std::string_view{ "/\\:\0", 4 }) == std::string_view::npos);
+	}
+
+	bool WriteBytes(const FilePath& path, std::string_view bytes)
+	{
+		BinaryWriter writer{ path };
+
+		if (not writer)
+		{
+			return false;
+		}
+
+		return (writer.write(bytes.data(), static_cast<int64>(bytes.size())) == static_cast<int64>(bytes.size()));
+	}
+}
+
+bool DimensionPack::open(const FilePath& packPath)
+{
+	// テーブルはマップしたメモリをそのまま参照するので、レイアウトを固定する
+	static_assert(sizeof(Header) == 64);
+	static_assert(sizeof(RoomRecord) == 24);
+	static_assert(sizeof(ObjectRecord) == 24);
+
+	close();
+
+	if (not m_file.open(packPath))
+	{
+		return false;
+	}
+
+	const auto mapped = m_file.map();
+	m_data = mapped.data;
+	m_size = mapped.size;
+
+	if ((m_data == nullptr) || (m_size < sizeof(Header)))
+	{
+		close();
+		return false;
+	}
+
+	const Header* header = reinterpret_cast<const Header*>(m_data);
+
+	if ((std::memcmp(header->magic, PackMagic, sizeof(PackMagic)) != 0) || (header->version != PackVersion))
+	{
+		Logger << U"🚨 Not a dimension pack (or unsupported version): " << packPath;
+		close();
+		return false;
+	}
+
+	const uint64 roomsOffset = sizeof(Header);
+	const uint64 objectsOffset = (roomsOffset + (uint64{ header->roomCount } * sizeof(RoomRecord)));
+	const uint64 tablesEnd = (objectsOffset + (uint64{ header->objectCount } * sizeof(ObjectRecord)));
+
+	if ((m_size < tablesEnd)
+		|| (m_size < header->stringsOffset) || ((m_size - header->stringsOffset) < header->stringsSize)
+		|| (m_size < header->connectionsOffset) || ((m_size - header->connectionsOffset) < header->connectionsSize))
+	{
+		Logger << U"🚨 Dimension pack is truncated: " << packPath;
+		close();
+		return false;
+	}
+
+	m_header = header;
+	m_rooms = reinterpret_cast<const RoomRecord*>(m_data + roomsOffset);
+	m_objects = reinterpret_cast<const ObjectRecord*>(m_data + objectsOffset);
+
+	// 以降の参照では範囲を確かめないので、すべてのレコードをここで1回だけ確かめる
+	if (not hasValidRecords())
+	{
+		Logger << U"🚨 Dimension pack is corrupt: " << packPath;
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void DimensionPack::close()
+{
+	m_header = nullptr;
+	m_rooms = nullptr;
+	m_objects = nullptr;
+	m_data = nullptr;
+	m_size = 0;
+
+	if (m_file.isOpen())
+	{
+		m_file.unmap();
+		m_file.close();
+	}
+}
+
+size_t DimensionPack::roomCount() const
+{
+	return (m_header ? m_header->roomCount : 0);
+}
+
+DimensionPack::Room DimensionPack::getRoom(const size_t index) const
+{
+	const RoomRecord& record = m_rooms[index];
+
+	return{
+		.name = getString(record.nameOffset, record.nameSize),
+		.firstObject = record.firstObject,
+		.objectCount = record.objectCount,
+		.hasDirectory = ((record.flags & RoomFlag_HasDirectory) != 0),
+	};
+}
+
+std::string_view DimensionPack::getObjectName(const size_t objectIndex) const
+{
+	const ObjectRecord& record = m_objects[objectIndex];
+	return getString(record.nameOffset, record.nameSize);
+}
+
+std::string_view DimensionPack::getObjectData(const size_t objectIndex) const
+{
+	const ObjectRecord& record = m_objects[objectIndex];
+	return getBytes(record.dataOffset, record.dataSize);
+}
+
+Optional<std::string_view> DimensionPack::getConnections() const
+{
+	if ((not m_header) || ((m_header->flags & HeaderFlag_HasConnections) == 0))
+	{
+		return none;
+	}
+
+	return getBytes(m_header->connectionsOffset, m_header->connectionsSize);
+}
+
+Optional<std::string_view> DimensionPack::findFile(const StringView roomName, const StringView fileName) const
+{
+	if (not m_header)
+	{
+		return none;
+	}
+
+	const std::string roomNameUTF8 = Unicode::ToUTF8(roomName);
+	const std::string fileNameUTF8 = Unicode::ToUTF8(fileName);
+
+	for (size_t i = 0; i < roomCount(); ++i)
+	{
+		const Room room = getRoom(i);
+
+		if (room.name != roomNameUTF8)
+		{
+			continue;
+		}
+
+		// 部屋内のオブジェクトは名前順に並んでいるので二分探索する
+		size_t first = room.firstObject;
+		size_t last = (size_t{ room.firstObject } + room.objectCount);
+
+		while (first < last)
+		{
+			const size_t middle = (first + (last - first) / 2);
+			const std::string_view name = getObjectName(middle);
+
+			if (name == fileNameUTF8)
+			{
+				return getObjectData(middle);
+			}
+			else if (name < fileNameUTF8)
+			{
+				first = (middle + 1);
+			}
+			else
+			{
+				last = middle;
+			}
+		}
+
+		return none;
+	}
+
+	return none;
+}
+
+Array<RoomModel> DimensionPack::makeRooms() const
+{
+	Array<RoomModel> rooms;
+	rooms.reserve(roomCount());
+
+	for (size_t i = 0; i < roomCount(); ++i)
+	{
+		const Room room = getRoom(i);
+
+		RoomModel roomModel;
+		roomModel.name = Unicode::FromUTF8(room.name);
+		roomModel.objects.reserve(room.objectCount);
+
+		for (uint32 k = 0; k < room.objectCount; ++k)
+		{
+			roomModel.objects.push_back({ Unicode::FromUTF8(getObjectName(size_t{ room.firstObject } + k)) });
+		}
+
+		rooms.push_back(std::move(roomModel));
+	}
+
+	return rooms;
+}
+
+bool DimensionPack::hasValidRecords() const
+{
+	const auto isStringInRange = [this](const uint32 offset, const uint32 size)
+		{
+			return ((offset <= m_header->stringsSize) && (size <= (m_header->stringsSize - offset)));
+		};
+
+	const auto isBytesInRange = [this](const uint64 offset, const uint64 size)
+		{
+			return ((offset <= m_size) && (size <= (m_size - offset)));
+		};
+
+	for (uint32 i = 0; i < m_header->roomCount; ++i)
+	{
+		const RoomRecord& record = m_rooms[i];
+
+		if ((not isStringInRange(record.nameOffset, record.nameSize))
+			|| (m_header->objectCount < (uint64{ record.firstObject } + record.objectCount)))
+		{
+			return false;
+		}
+	}
+
+	for (uint32 i = 0; i < m_header->objectCount; ++i)
+	{
+		const ObjectRecord& record = m_objects[i];
+
+		if ((not isStringInRange(record.nameOffset, record.nameSize)) || (not isBytesInRange(record.dataOffset, record.dataSize)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+std::string_view DimensionPack::getString(const uint32 offset, const uint32 size) const
+{
+	// 範囲は open() で確かめてある
+	return{ reinterpret_cast<const char*>(m_data + m_header->stringsOffset + offset), size };
+}
+
+std::string_view DimensionPack::getBytes(const uint64 offset, const uint64 size) const
+{
+	// 範囲は open() で確かめてある（ヘッダの room_connections.json の範囲も含む）
+	return{ reinterpret_cast<const char*>(m_data + offset), static_cast<size_t>(size) };
+}
+
+bool DimensionPack::Pack(const FilePath& dimensionPath, const FilePath& packPath)
+{
+	if (not FileSystem::IsDirectory(dimensionPath))
+	{
+		return false;
+	}
+
+	Array<RoomModel> rooms = DimensionLoader::LoadRooms(dimensionPath);
+
+	Array<RoomRecord> roomRecords;
+	Array<ObjectRecord> objectRecords;
+	Array<FilePath> objectPaths;
+	std::string strings;
+
+	const auto addString = [&strings](const String& s) -> std::pair<uint32, uint32>
+		{
+			const std::string utf8 = s.toUTF8();
+			const uint32 offset = static_cast<uint32>(strings.size());
+			strings += utf8;
+			return{ offset, static_cast<uint32>(utf8.size()) };
+		};
+
+	for (auto& room : rooms)
+	{
+		const FilePath roomPath = FileSystem::PathAppend(dimensionPath, room.name);
+
+		// 二分探索できるよう、部屋内のオブジェクトを UTF-8 のバイト順に並べる
+		Array<std::pair<std::string, String>> sortedNames;
+		for (const auto& object : room.objects)
+		{
+			sortedNames.emplace_back(object.fileName.toUTF8(), object.fileName);
+		}
+		sortedNames.sort_by([](const auto& a, const auto& b) { return (a.first < b.first); });
+
+		const auto [nameOffset, nameSize] = addString(room.name);
+		roomRecords.push_back({
+			.nameOffset = nameOffset,
+			.nameSize = nameSize,
+			.firstObject = static_cast<uint32>(objectRecords.size()),
+			.objectCount = static_cast<uint32>(sortedNames.size()),
+			.flags = (FileSystem::IsDirectory(roomPath) ? RoomFlag_HasDirectory : 0u),
+			.reserved = 0,
+		});
+
+		for (const auto& name : sortedNames)
+		{
+			const auto [objectNameOffset, objectNameSize] = addString(name.second);
+			objectRecords.push_back({ .nameOffset = objectNameOffset, .nameSize = objectNameSize, .dataOffset = 0, .dataSize = 0 });
+			objectPaths.push_back(FileSystem::PathAppend(roomPath, name.second));
+		}
+	}
+
+	Header header{};
+	std::memcpy(header.magic, PackMagic, sizeof(PackMagic));
+	header.version = PackVersion;
+	header.roomCount = static_cast<uint32>(roomRecords.size());
+	header.objectCount = static_cast<uint32>(objectRecords.size());
+	header.stringsOffset = (sizeof(Header) + (roomRecords.size() * sizeof(RoomRecord)) + (objectRecords.size() * sizeof(ObjectRecord)));
+	header.stringsSize = strings.size();
+
+	const FilePath tempPath = packPath + U".saving";
+	{
+		BinaryWriter writer{ tempPath };
+
+		if (not writer)
+		{
+			return false;
+		}
+
+		// ヘッダーと部屋・オブジェクトのテーブルを書く（すべて書けなければ false）
+		const auto writeTables = [&]()
+			{
+				const int64 roomBytes = static_cast<int64>(roomRecords.size() * sizeof(RoomRecord));
+				const int64 objectBytes = static_cast<int64>(objectRecords.size() * sizeof(ObjectRecord));
+				return ((writer.write(&header, sizeof(Header)) == static_cast<int64>(sizeof(Header)))
+					&& (writer.write(roomRecords.data(), roomBytes) == roomBytes)
+					&& (writer.write(objectRecords.data(), objectBytes) == objectBytes));
+			};
+
+		// テーブルは内容の位置が決まってから書き直すので、まずは仮の内容で場所を確保する
+		bool succeeded = (writeTables()
+			&& (writer.write(strings.data(), static_cast<int64>(strings.size())) == static_cast<int64>(strings.size()))
+			&& WritePadding(writer));
+
+		const FilePath connectionsPath = FileSystem::PathAppend(dimensionPath, U"room_connections.json");
+
+		if (succeeded && FileSystem::IsFile(connectionsPath))
+		{
+			header.flags |= HeaderFlag_HasConnections;
+			header.connectionsOffset = static_cast<uint64>(writer.getPos());
+
+			if (const auto size = CopyFileTo(writer, connectionsPath))
+			{
+				header.connectionsSize = *size;
+				succeeded = WritePadding(writer);
+			}
+			else
+			{
+				succeeded = false;
+			}
+		}
+
+		for (size_t i = 0; succeeded && (i < objectRecords.size()); ++i)
+		{
+			objectRecords[i].dataOffset = static_cast<uint64>(writer.getPos());
+
+			if (const auto size = CopyFileTo(writer, objectPaths[i]))
+			{
+				objectRecords[i].dataSize = *size;
+				succeeded = WritePadding(writer);
+			}
+			else
+			{
+				Logger << U"🚨 Failed to read: " << objectPaths[i];
+				succeeded = false;
+			}
+		}
+
+		if (succeeded)
+		{
+			// 書き直しに失敗すると位置が 0 のままのテーブルが残るので、パック全体の失敗とする
+			writer.setPos(0);
+			succeeded = ((writer.getPos() == 0) && writeTables());
+			writer.flush();
+		}
+
+		writer.close();
+
+		// 既存のパックを置き換える前に、内容をディスクへ書き出す
+		if ((not succeeded) || (not SyncFile(tempPath)))
+		{
+			FileSystem::Remove(tempPath);
+			return false;
+		}
+	}
+
+	std::error_code ec;
+	std::filesystem::rename(std::filesystem::path{ tempPath.str() }, std::filesystem::path{ packPath.str() }, ec);
+
+	if (ec)
+	{
+		FileSystem::Remove(tempPath);
+		return false;
+	}
+
+	return true;
+}
+
+bool DimensionPack::Unpack(const FilePath& packPath, const FilePath& dimensionPath)
+{
+	DimensionPack pack;
+
+	if (not pack.open(packPath))
+	{
+		return false;
+	}
+
+	// 名前はパックの中身なので信用しない。ファイルを作る前に、展開するすべての部屋とオブジェクトの名前を確かめる
+	for (size_t i = 0; i < pack.roomCount(); ++i)
+	{
+		const Room room = pack.getRoom(i);
+
+		if ((not room.hasDirectory) && (room.objectCount == 0))
+		{
+			continue;
+		}
+
+		if (not IsSafeEntryName(room.name))
+		{
+			Logger << U"🚨 Dimension pack has an invalid room name: " << Unicode::FromUTF8(room.name);
+			return false;
+		}
+
+		for (uint32 k = 0; k < room.objectCount; ++k)
+		{
+			if (const std::string_view name = pack.getObjectName(size_t{ room.firstObject } + k); not IsSafeEntryName(name))
+			{
+				Logger << U"🚨 Dimension pack has an invalid file name: " << Unicode::FromUTF8(name);
+				return false;
+			}
+		}
+	}
+
+	if (not FileSystem::CreateDirectories(dimensionPath) && (not FileSystem::IsDirectory(dimensionPath)))
+	{
+		return false;
+	}
+
+	if (const auto connections = pack.getConnections())
+	{
+		if (not WriteBytes(FileSystem::PathAppend(dimensionPath, U"room_connections.json"), *connections))
+		{
+			return false;
+		}
+	}
+
+	for (size_t i = 0; i < pack.roomCount(); ++i)
+	{
+		const Room room = pack.getRoom(i);
+
+		if ((not room.hasDirectory) && (room.objectCount == 0))
+		{
+			continue;
+		}
+
+		const FilePath roomPath = FileSystem::PathAppend(dimensionPath, Unicode::FromUTF8(room.name));
+		FileSystem::CreateDirectories(roomPath);
+
+		for (uint32 k = 0; k < room.objectCount; ++k)
+		{
+			const size_t objectIndex = (size_t{ room.firstObject } + k);
+			const FilePath filePath = FileSystem::PathAppend(roomPath, Unicode::FromUTF8(pack.getObjectName(objectIndex)));
+
+			if (not WriteBytes(filePath, pack.getObjectData(objectIndex)))
+			{
+				Logger << U"🚨 Failed to write: " << filePath;
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,102 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include "DimensionModel.hpp"
+
+// 次元を1つのファイルにまとめたコンテナ（.dimpak）
+//
+// [ヘッダ 64 bytes][部屋テーブル][オブジェクトテーブル][名前の文字列 (UTF-8)][ファイルの内容]
+//
+// ・部屋は次元フォルダを読み込んだときと同じ順序、各部屋のオブジェクトはファイル名（UTF-8）の昇順で並ぶ
+// ・room_connections.json と部屋フォルダ直下の .json ファイルを、バイト列のまま格納する（フォルダと相互に無損失で変換できる）
+// ・開くときはファイルをメモリマップし、テーブルや内容はコピーせずに参照する
+// ・数値はリトルエンディアン
+class DimensionPack
+{
+public:
+	static constexpr StringView Extension = U"dimpak";
+
+	struct Room
+	{
+		std::string_view name;
+
+		uint32 firstObject = 0;
+
+		uint32 objectCount = 0;
+
+		// 展開時にフォルダを作るか（room_connections.json にだけ記載された部屋は false）
+		bool hasDirectory = false;
+	};
+
+	DimensionPack() = default;
+
+	DimensionPack(const DimensionPack&) = delete;
+
+	DimensionPack& operator =(const DimensionPack&) = delete;
+
+	// メモリマップして開く。形式が正しくない、またはテーブルや名前・内容の範囲がファイルの外を指していれば false
+	bool open(const FilePath& packPath);
+
+	void close();
+
+	[[nodiscard]]
+	bool isOpen() const { return (m_header != nullptr); }
+
+	[[nodiscard]]
+	size_t roomCount() const;
+
+	[[nodiscard]]
+	Room getRoom(size_t index) const;
+
+	[[nodiscard]]
+	std::string_view getObjectName(size_t objectIndex) const;
+
+	[[nodiscard]]
+	std::string_view getObjectData(size_t objectIndex) const;
+
+	// room_connections.json の内容（格納されていなければ none）
+	[[nodiscard]]
+	Optional<std::string_view> getConnections() const;
+
+	// 部屋名とファイル名からファイルの内容を探す（コピーしない）
+	[[nodiscard]]
+	Optional<std::string_view> findFile(StringView roomName, StringView fileName) const;
+
+	// DimensionModel に渡す部屋の一覧を作る
+	[[nodiscard]]
+	Array<RoomModel> makeRooms() const;
+
+	// 次元フォルダを .dimpak に書き出す
+	static bool Pack(const FilePath& dimensionPath, const FilePath& packPath);
+
+	// .dimpak を次元フォルダに展開する
+	static bool Unpack(const FilePath& packPath, const FilePath& dimensionPath);
+
+private:
+	struct Header;
+
+	struct RoomRecord;
+
+	struct ObjectRecord;
+
+	// すべての部屋とオブジェクトのレコードの範囲が、テーブルとファイルの中に収まっているか
+	[[nodiscard]]
+	bool hasValidRecords() const;
+
+	[[nodiscard]]
+	std::string_view getString(uint32 offset, uint32 size) const;
+
+	[[nodiscard]]
+	std::string_view getBytes(uint64 offset, uint64 size) const;
+
+	MemoryMappedFileView m_file;
+
+	const Byte* m_data = nullptr;
+
+	size_t m_size = 0;
+
+	const Header* m_header = nullptr;
+
+	const RoomRecord* m_rooms = nullptr;
+
+	const ObjectRecord* m_objects = nullptr;
+};
@@ -0,0 +1,342 @@
+﻿#include "DimensionValidator.hpp"
+
+DimensionValidator::~DimensionValidator()
+{
+	close();
+}
+
+void DimensionValidator::open(DocumentReader reader, const Array<FilePath>& paths)
+{
+	close();
+
+	m_reader = std::move(reader);
+	setPaths(paths);
+}
+
+void DimensionValidator::close()
+{
+	if (m_task.isValid())
+	{
+		// ワーカーは文書ごとに取り消しを確認するので、待つのは検証中の1文書分だけ
+		*m_cancelled = true;
+		m_task.wait();
+		m_task = AsyncTask<PassOutput>{};
+	}
+
+	m_reader = nullptr;
+	m_entries.clear();
+	m_pending.clear();
+	m_lastPass = PassStats{};
+	m_problemsDirty = true;
+}
+
+void DimensionValidator::setPaths(const Array<FilePath>& paths)
+{
+	HashSet<FilePath> current;
+	current.reserve(paths.size());
+
+	for (const auto& path : paths)
+	{
+		FilePath key = NormalizePath(path);
+
+		if (not m_entries.contains(key))
+		{
+			m_entries.emplace(key, Entry{ .path = path });
+			m_pending.insert(key);
+		}
+
+		current.insert(std::move(key));
+	}
+
+	Array<FilePath> removedKeys;
+
+	for (const auto& [key, entry] : m_entries)
+	{
+		if (not current.contains(key))
+		{
+			removedKeys.push_back(key);
+		}
+	}
+
+	for (const auto& key : removedKeys)
+	{
+		if (not m_entries[key].problems.isEmpty())
+		{
+			m_problemsDirty = true;
+		}
+
+		m_pending.erase(key);
+		m_entries.erase(key);
+	}
+}
+
+void DimensionValidator::invalidate(const FilePath& path)
+{
+	const FilePath key = NormalizePath(path);
+	auto it = m_entries.find(key);
+
+	// 編集中の文書はメモリ上の内容を優先する（保存が終わったら releaseDocument で読み直す）
+	if ((it == m_entries.end()) || it->second.memoryRevision)
+	{
+		return;
+	}
+
+	++it->second.generation;
+	m_pending.insert(key);
+}
+
+void DimensionValidator::revalidateAll()
+{
+	for (auto& [key, entry] : m_entries)
+	{
+		if (entry.memoryRevision)
+		{
+			continue;
+		}
+
+		// 更新日時とサイズが同じでも読み直す
+		entry.stamp.reset();
+		++entry.generation;
+		m_pending.insert(key);
+	}
+}
+
+void DimensionValidator::validateDocument(const FilePath& path, const JSON& json, const uint64 revision)
+{
+	const FilePath key = NormalizePath(path);
+	Entry& entry = m_entries[key];
+
+	if (entry.memoryRevision == revision)
+	{
+		return;
+	}
+
+	if (entry.path.isEmpty())
+	{
+		entry.path = path;
+	}
+
+	// 1文書の検証は軽いので、UIスレッドでそのまま行う（実行中のディスクからの検証の結果は捨てる）
+	entry.problems = SchemaValidator::ValidateDocument(FileSystem::BaseName(path), json);
+	entry.memoryRevision = revision;
+	++entry.generation;
+	m_pending.erase(key);
+	m_problemsDirty = true;
+}
+
+void DimensionValidator::releaseDocument(const FilePath& path)
+{
+	const FilePath key = NormalizePath(path);
+	auto it = m_entries.find(key);
+
+	if ((it == m_entries.end()) || (not it->second.memoryRevision))
+	{
+		return;
+	}
+
+	it->second.memoryRevision.reset();
+	it->second.stamp.reset();
+	++it->second.generation;
+	m_pending.insert(key);
+}
+
+void DimensionValidator::update()
+{
+	if (m_task.isReady())
+	{
+		applyPass(m_task.get());
+		m_task = AsyncTask<PassOutput>{};
+	}
+
+	if ((not m_task.isValid()) && m_reader && (not m_pending.isEmpty()))
+	{
+		startPass();
+	}
+
+	if (m_problemsDirty)
+	{
+		rebuildProblems();
+	}
+}
+
+const Array<SchemaProblem>& DimensionValidator::getProblems(const FilePath& path) const
+{
+	static const Array<SchemaProblem> NoProblems;
+
+	if (auto it = m_entries.find(NormalizePath(path)); it != m_entries.end())
+	{
+		return it->second.problems;
+	}
+
+	return NoProblems;
+}
+
+FilePath DimensionValidator::NormalizePath(const FilePath& path)
+{
+	// JsonDocumentCache と同じく、"dimension//North/Lockbox.json" と "dimension/North/Lockbox.json" を同じキーにする
+	return FileSystem::FullPath(path);
+}
+
+DimensionValidator::JobResult DimensionValidator::ValidateFile(const DocumentReader& reader, const Job& job)
+{
+	JobResult result{ .key = job.key, .generation = job.generation, .stamp = FileStamp::Query(job.path), .completed = true };
+
+	if (job.knownStamp && (result.stamp == job.knownStamp))
+	{
+		result.unchanged = true;
+		return result;
+	}
+
+	const JSON json = reader(job.path);
+
+	if (not json)
+	{
+		result.problems.push_back({ .severity = SchemaProblem::Severity::Error, .path = U"", .message = U"failed to read or parse the file" });
+		return result;
+	}
+
+	// スキーマはファイル名（拡張子なし）で決まる（エディタのインスペクタと同じ）
+	result.problems = SchemaValidator::ValidateDocument(FileSystem::BaseName(job.path), json);
+	return result;
+}
+
+void DimensionValidator::startPass()
+{
+	Array<Job> jobs;
+	jobs.reserve(m_pending.size());
+
+	for (const auto& key : m_pending)
+	{
+		if (auto it = m_entries.find(key); (it != m_entries.end()) && (not it->second.memoryRevision))
+		{
+			jobs.push_back({ .key = key, .path = it->second.path, .generation = it->second.generation, .knownStamp = it->second.stamp });
+		}
+	}
+
+	m_pending.clear();
+
+	if (jobs.isEmpty())
+	{
+		return;
+	}
+
+	m_cancelled = std::make_shared<std::atomic<bool>>(false);
+	m_passStopwatch.restart();
+
+	m_task = Async([reader = m_reader, jobs = std::move(jobs), cancelled = m_cancelled]()
+		{
+			const size_t workerCount = Max<size_t>(Min<size_t>(Threading::GetConcurrency(), jobs.size()), 1);
+
+			// 結果は文書のインデックスに直接書き込むので、スレッドの実行順に関係なく順序が決まる
+			PassOutput output{ .results = Array<JobResult>(jobs.size()), .jobCount = workerCount };
+			std::atomic<size_t> nextIndex{ 0 };
+
+			const auto worker = [&]()
+				{
+					for (size_t i = nextIndex++; i < jobs.size(); i = nextIndex++)
+					{
+						if (*cancelled)
+						{
+							return;
+						}
+
+						output.results[i] = ValidateFile(reader, jobs[i]);
+					}
+				};
+
+			Array<AsyncTask<void>> tasks;
+
+			for (size_t i = 1; i < workerCount; ++i)
+			{
+				tasks.push_back(Async(worker));
+			}
+
+			worker();
+
+			for (auto& task : tasks)
+			{
+				task.get();
+			}
+
+			return output;
+		});
+}
+
+void DimensionValidator::applyPass(PassOutput&& output)
+{
+	PassStats stats{ .jobCount = output.jobCount, .millisec = m_passStopwatch.msF() };
+
+	for (auto& result : output.results)
+	{
+		if (not result.completed)
+		{
+			continue;
+		}
+
+		auto it = m_entries.find(result.key);
+
+		// 検証を始めた後に、一覧から消えたか、検証し直しを求められた文書の結果は捨てる
+		if ((it == m_entries.end()) || (it->second.generation != result.generation))
+		{
+			continue;
+		}
+
+		it->second.stamp = result.stamp;
+
+		if (result.unchanged)
+		{
+			++stats.skippedCount;
+			continue;
+		}
+
+		++stats.validatedCount;
+
+		if ((not result.problems.isEmpty()) || (not it->second.problems.isEmpty()))
+		{
+			it->second.problems = std::move(result.problems);
+			m_problemsDirty = true;
+		}
+	}
+
+	m_lastPass = stats;
+}
+
+void DimensionValidator::rebuildProblems()
+{
+	m_problemsDirty = false;
+	m_problems.clear();
+	m_errorCount = 0;
+	m_warningCount = 0;
+
+	// 問題のある文書は通常ごく一部なので、それだけを並べ替える
+	Array<const std::pair<const FilePath, Entry>*> documents;
+
+	for (const auto& item : m_entries)
+	{
+		if (not item.second.problems.isEmpty())
+		{
+			documents.push_back(&item);
+		}
+	}
+
+	documents.sort_by([](const auto* a, const auto* b) { return (a->second.path < b->second.path); });
+
+	for (const auto* document : documents)
+	{
+		for (const auto& problem : document->second.problems)
+		{
+			m_problems.push_back({ .filePath = document->second.path, .problem = problem });
+
+			if (problem.severity == SchemaProblem::Severity::Error)
+			{
+				++m_errorCount;
+			}
+			else
+			{
+				++m_warningCount;
+			}
+		}
+	}
+
+	++m_revision;
+}
@@ -0,0 +1,190 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include "FileStamp.hpp"
+#include "SchemaValidator.hpp"
+
+// 次元の検証で見つかった問題（文書のパスと、その中の位置）
+struct DimensionProblem
+{
+	FilePath filePath;
+
+	SchemaProblem problem;
+};
+
+// 次元のすべての文書を SchemaRegistry のスキーマで検証し、問題の一覧を保つ
+// ・ディスク上の文書はワーカースレッドで並列に検証する（結果は update() で取り込むので、UIスレッドは待たない）
+// ・2回目以降は、変更のあった文書（invalidate されたもの、一覧に加わったもの）だけを検証し直す
+//   更新日時とサイズが前回の検証時と同じなら、パースもしない
+// ・編集中の文書は、保存を待たずにメモリ上の内容で検証する
+// パスは表記の揺れ（"dimension//North/Lockbox.json" など）を区別せずに扱う
+class DimensionValidator
+{
+public:
+	// 文書を読む関数（ワーカースレッドから同時に呼ばれる）。読めなければ無効な JSON を返す
+	using DocumentReader = std::function<JSON(const FilePath&)>;
+
+	// 直近に完了した検証の統計
+	struct PassStats
+	{
+		// パースして検証した文書の数
+		size_t validatedCount = 0;
+
+		// 更新日時とサイズが変わっておらず、検証を省いた文書の数
+		size_t skippedCount = 0;
+
+		size_t jobCount = 0;
+
+		double millisec = 0.0;
+	};
+
+	DimensionValidator() = default;
+
+	~DimensionValidator();
+
+	DimensionValidator(const DimensionValidator&) = delete;
+
+	DimensionValidator& operator =(const DimensionValidator&) = delete;
+
+	// 検証する次元を切り替え、すべての文書を検証する（前の次元の結果は捨てる）
+	void open(DocumentReader reader, const Array<FilePath>& paths);
+
+	// 検証をやめ、結果を捨てる（実行中の検証は取り消して終わるのを待つ）
+	void close();
+
+	// 次元の文書の一覧を更新する（加わった文書は検証し、なくなった文書の結果は捨てる）
+	void setPaths(const Array<FilePath>& paths);
+
+	// ディスク上の内容が変わった文書を、次の update() で検証し直す
+	void invalidate(const FilePath& path);
+
+	// すべての文書をディスクから読み直して検証する（編集中の文書を除く）
+	void revalidateAll();
+
+	// 編集中の文書をメモリ上の内容で検証する（revision が前回と同じなら何もしない）
+	void validateDocument(const FilePath& path, const JSON& json, uint64 revision);
+
+	// 編集中の文書の検証をやめ、ディスク上の内容で検証し直す（保存が終わったときや、変更を捨てたときに呼ぶ）
+	void releaseDocument(const FilePath& path);
+
+	// 完了した検証を取り込み、待っている文書があれば次の検証を始める（毎フレーム呼ぶ）
+	void update();
+
+	// ワーカースレッドで検証中なら true
+	[[nodiscard]]
+	bool isRunning() const { return m_task.isValid(); }
+
+	// 問題の一覧（文書のパス順、その中では位置の順）
+	[[nodiscard]]
+	const Array<DimensionProblem>& getProblems() const { return m_problems; }
+
+	// path の文書の問題（まだ検証していない、または問題がなければ空）
+	[[nodiscard]]
+	const Array<SchemaProblem>& getProblems(const FilePath& path) const;
+
+	[[nodiscard]]
+	size_t getErrorCount() const { return m_errorCount; }
+
+	[[nodiscard]]
+	size_t getWarningCount() const { return m_warningCount; }
+
+	[[nodiscard]]
+	size_t getDocumentCount() const { return m_entries.size(); }
+
+	// 問題の一覧が変わるたびに増える
+	[[nodiscard]]
+	uint64 getRevision() const { return m_revision; }
+
+	[[nodiscard]]
+	const PassStats& getLastPass() const { return m_lastPass; }
+
+private:
+	struct Entry
+	{
+		// setPaths に渡された形式のパス（問題の一覧に出し、読み込みにも使う）
+		FilePath path;
+
+		Array<SchemaProblem> problems;
+
+		// ディスク上の内容を検証したときの更新日時とサイズ
+		Optional<FileStamp> stamp;
+
+		// 検証の要求のたびに増やし、それより前に始めた検証の結果を取り込まないようにする
+		uint64 generation = 0;
+
+		// 編集中の文書の内容で検証したときの、文書のリビジョン（ディスク上の内容で検証したなら none）
+		Optional<uint64> memoryRevision;
+	};
+
+	struct Job
+	{
+		FilePath key;
+
+		FilePath path;
+
+		uint64 generation = 0;
+
+		// 前回検証したときの更新日時とサイズ（同じなら検証を省く）
+		Optional<FileStamp> knownStamp;
+	};
+
+	struct JobResult
+	{
+		FilePath key;
+
+		uint64 generation = 0;
+
+		Optional<FileStamp> stamp;
+
+		Array<SchemaProblem> problems;
+
+		// 取り消されずに最後まで検証した
+		bool completed = false;
+
+		// 更新日時とサイズが変わっておらず、検証を省いた
+		bool unchanged = false;
+	};
+
+	struct PassOutput
+	{
+		Array<JobResult> results;
+
+		size_t jobCount = 0;
+	};
+
+	[[nodiscard]]
+	static FilePath NormalizePath(const FilePath& path);
+
+	static JobResult ValidateFile(const DocumentReader& reader, const Job& job);
+
+	void startPass();
+
+	void applyPass(PassOutput&& output);
+
+	void rebuildProblems();
+
+	DocumentReader m_reader;
+
+	// NormalizePath したパス → 文書
+	HashTable<FilePath, Entry> m_entries;
+
+	// 次の検証で読み直す文書（NormalizePath したパス）
+	HashSet<FilePath> m_pending;
+
+	AsyncTask<PassOutput> m_task;
+
+	std::shared_ptr<std::atomic<bool>> m_cancelled;
+
+	Stopwatch m_passStopwatch;
+
+	PassStats m_lastPass;
+
+	Array<DimensionProblem> m_problems;
+
+	bool m_problemsDirty = false;
+
+	uint64 m_revision = 0;
+
+	size_t m_errorCount = 0;
+
+	size_t m_warningCount = 0;
+};
@@ -0,0 +1,296 @@
+﻿#include "DimensionWatcher.hpp"
+
+namespace
+{
+	void AddRoomFiles(const FilePath& roomPath, const HashTable<String, FileStamp>& files, DimensionChange::Kind kind, Array<DimensionChange>& changes)
+	{
+		for (const auto& file : files)
+		{
+			changes.push_back({ roomPath + file.first, kind });
+		}
+	}
+}
+
+DimensionWatcher::~DimensionWatcher()
+{
+	stop();
+}
+
+void DimensionWatcher::start(const FilePath& dimensionPath)
+{
+	stop();
+
+	m_rootPath = FileSystem::FullPath(dimensionPath);
+
+	if (not m_rootPath.ends_with(U'/'))
+	{
+		m_rootPath.push_back(U'/');
+	}
+
+	m_watcher = std::make_unique<DirectoryWatcher>(m_rootPath);
+
+	if (not m_watcher->isActive())
+	{
+		// 変更通知が使えない場合はポーリングに切り替える（最初のポーリングで比べる相手の状態を取る）
+		Logger << U"⚠️ Warning: DirectoryWatcher is not available. Falling back to polling: " << m_rootPath;
+		m_watcher.reset();
+		m_snapshot = std::make_shared<Snapshot>();
+		m_cancelled = std::make_shared<std::atomic<bool>>(false);
+		startPolling();
+	}
+}
+
+void DimensionWatcher::stop()
+{
+	if (m_cancelled)
+	{
+		*m_cancelled = true;
+	}
+
+	// 取り消したポーリングは部屋1つの走査を終えたところで戻るので、ここで待つ
+	if (m_pollingTask.isValid())
+	{
+		m_pollingTask.wait();
+		m_pollingTask = AsyncTask<Array<DimensionChange>>{};
+	}
+
+	m_watcher.reset();
+	m_rootPath.clear();
+	m_snapshot.reset();
+	m_cancelled.reset();
+	m_pollingTimer.reset();
+}
+
+Array<DimensionChange> DimensionWatcher::retrieveChanges()
+{
+	Array<DimensionChange> changes;
+
+	if (not isWatching())
+	{
+		return changes;
+	}
+
+	if (m_watcher)
+	{
+		for (const auto& change : m_watcher->retrieveChanges())
+		{
+			switch (change.action)
+			{
+			case FileAction::Added:
+			case FileAction::RenamedNewName:
+				changes.push_back({ change.path, DimensionChange::Kind::Added });
+				break;
+			case FileAction::Removed:
+			case FileAction::RenamedOldName:
+				changes.push_back({ change.path, DimensionChange::Kind::Removed });
+				break;
+			case FileAction::Modified:
+				changes.push_back({ change.path, DimensionChange::Kind::Modified });
+				break;
+			default:
+				break;
+			}
+		}
+	}
+	else
+	{
+		// 終わったポーリングの結果を受け取り、間隔をおいて次のポーリングを始める
+		if (m_pollingTask.isValid() && m_pollingTask.isReady())
+		{
+			changes = m_pollingTask.get();
+			m_pollingTimer.restart();
+		}
+
+		if ((not m_pollingTask.isValid()) && (PollingIntervalSec <= m_pollingTimer.sF()))
+		{
+			startPolling();
+		}
+	}
+
+	return changes;
+}
+
+void DimensionWatcher::startPolling()
+{
+	m_pollingTask = Async([rootPath = m_rootPath, snapshot = m_snapshot, cancelled = m_cancelled]()
+		{
+			Array<DimensionChange> changes;
+
+			if (not snapshot->isTaken)
+			{
+				TakeSnapshot(rootPath, *snapshot, *cancelled);
+				snapshot->isTaken = true;
+			}
+			else
+			{
+				PollChanges(rootPath, *snapshot, changes, *cancelled);
+			}
+
+			return changes;
+		});
+}
+
+void DimensionWatcher::TakeSnapshot(const FilePath& rootPath, Snapshot& snapshot, const std::atomic<bool>& cancelled)
+{
+	for (const auto& path : FileSystem::DirectoryContents(rootPath, Recursive::No))
+	{
+		if (cancelled)
+		{
+			return;
+		}
+
+		if (FileSystem::IsDirectory(path))
+		{
+			snapshot.rooms.emplace(FileSystem::BaseName(path), ScanRoom(path));
+		}
+		else if (const auto stamp = FileStamp::Query(path))
+		{
+			snapshot.rootFiles.emplace(FileSystem::FileName(path), *stamp);
+		}
+	}
+}
+
+DimensionWatcher::RoomSnapshot DimensionWatcher::ScanRoom(const FilePath& roomPath)
+{
+	RoomSnapshot snapshot;
+	snapshot.directoryStamp = FileStamp::Query(roomPath);
+
+	for (const auto& filePath : FileSystem::DirectoryContents(roomPath, Recursive::No))
+	{
+		if (const auto stamp = FileStamp::Query(filePath))
+		{
+			snapshot.files.emplace(FileSystem::FileName(filePath), *stamp);
+		}
+	}
+
+	return snapshot;
+}
+
+void DimensionWatcher::PollChanges(const FilePath& rootPath, Snapshot& snapshot, Array<DimensionChange>& changes, const std::atomic<bool>& cancelled)
+{
+	HashTable<String, FileStamp> rootFiles;
+	HashSet<String> roomNames;
+
+	for (const auto& path : FileSystem::DirectoryContents(rootPath, Recursive::No))
+	{
+		if (FileSystem::IsDirectory(path))
+		{
+			roomNames.insert(FileSystem::BaseName(path));
+		}
+		else if (const auto stamp = FileStamp::Query(path))
+		{
+			rootFiles.emplace(FileSystem::FileName(path), *stamp);
+		}
+	}
+
+	// 次元フォルダ直下のファイル（room_connections.json など）
+	for (const auto& [fileName, stamp] : rootFiles)
+	{
+		const auto it = snapshot.rootFiles.find(fileName);
+
+		if (it == snapshot.rootFiles.end())
+		{
+			changes.push_back({ rootPath + fileName, DimensionChange::Kind::Added });
+		}
+		else if (it->second != stamp)
+		{
+			changes.push_back({ rootPath + fileName, DimensionChange::Kind::Modified });
+		}
+	}
+
+	for (const auto& file : snapshot.rootFiles)
+	{
+		if (not rootFiles.contains(file.first))
+		{
+			changes.push_back({ rootPath + file.first, DimensionChange::Kind::Removed });
+		}
+	}
+
+	snapshot.rootFiles = std::move(rootFiles);
+
+	// 削除された部屋
+	Array<String> removedRooms;
+
+	for (const auto& room : snapshot.rooms)
+	{
+		if (not roomNames.contains(room.first))
+		{
+			const FilePath roomPath = rootPath + room.first + U'/';
+			AddRoomFiles(roomPath, room.second.files, DimensionChange::Kind::Removed, changes);
+			changes.push_back({ roomPath, DimensionChange::Kind::Removed });
+			removedRooms.push_back(room.first);
+		}
+	}
+
+	for (const auto& roomName : removedRooms)
+	{
+		snapshot.rooms.erase(roomName);
+	}
+
+	for (const auto& roomName : roomNames)
+	{
+		// 取り消された場合は途中で戻る（この状態はもう使わない）
+		if (cancelled)
+		{
+			return;
+		}
+
+		const FilePath roomPath = rootPath + roomName + U'/';
+		auto it = snapshot.rooms.find(roomName);
+
+		// 追加された部屋
+		if (it == snapshot.rooms.end())
+		{
+			RoomSnapshot room = ScanRoom(roomPath);
+			changes.push_back({ roomPath, DimensionChange::Kind::Added });
+			AddRoomFiles(roomPath, room.files, DimensionChange::Kind::Added, changes);
+			snapshot.rooms.emplace(roomName, std::move(room));
+			continue;
+		}
+
+		RoomSnapshot& room = it->second;
+
+		// フォルダの更新日時が変わっていれば、ファイルの追加・削除・リネームがあった
+		if (FileStamp::Query(roomPath) != room.directoryStamp)
+		{
+			RoomSnapshot latest = ScanRoom(roomPath);
+
+			for (const auto& [fileName, stamp] : latest.files)
+			{
+				const auto fileIt = room.files.find(fileName);
+
+				if (fileIt == room.files.end())
+				{
+					changes.push_back({ roomPath + fileName, DimensionChange::Kind::Added });
+				}
+				else if (fileIt->second != stamp)
+				{
+					changes.push_back({ roomPath + fileName, DimensionChange::Kind::Modified });
+				}
+			}
+
+			for (const auto& file : room.files)
+			{
+				if (not latest.files.contains(file.first))
+				{
+					changes.push_back({ roomPath + file.first, DimensionChange::Kind::Removed });
+				}
+			}
+
+			room = std::move(latest);
+			continue;
+		}
+
+		// ファイル内容の変更はフォルダの更新日時に現れないので、個別に確認する
+		for (auto& [fileName, stamp] : room.files)
+		{
+			const FilePath filePath = roomPath + fileName;
+
+			if (const auto latest = FileStamp::Query(filePath); latest && (*latest != stamp))
+			{
+				stamp = *latest;
+				changes.push_back({ filePath, DimensionChange::Kind::Modified });
+			}
+		}
+	}
+}
@@ -0,0 +1,95 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include "FileStamp.hpp"
+
+// 次元フォルダ内で起きた変更
+struct DimensionChange
+{
+	enum class Kind
+	{
+		Added,
+		Removed,
+		Modified,
+	};
+
+	// 変更されたファイル、またはフォルダ（末尾が '/'）のフルパス
+	FilePath path;
+
+	Kind kind;
+};
+
+// 次元フォルダの変更を監視するクラス
+// OSの変更通知（Windows: ReadDirectoryChangesW, Linux: inotify）を使い、
+// 利用できない環境ではフォルダを定期的にポーリングして同じ形式の変更を返す
+// （ポーリングはワーカースレッドで行い、終わったものを retrieveChanges() で受け取る。UI スレッドではファイルを stat しない）
+class DimensionWatcher
+{
+public:
+	DimensionWatcher() = default;
+
+	~DimensionWatcher();
+
+	void start(const FilePath& dimensionPath);
+
+	void stop();
+
+	// 前回の呼び出し以降に起きた変更を取り出す
+	[[nodiscard]]
+	Array<DimensionChange> retrieveChanges();
+
+	[[nodiscard]]
+	bool isWatching() const { return (not m_rootPath.isEmpty()); }
+
+	[[nodiscard]]
+	bool isPolling() const { return (isWatching() && (not m_watcher)); }
+
+	// 監視対象のフォルダ（フルパス、末尾は '/'）
+	[[nodiscard]]
+	const FilePath& getRootPath() const { return m_rootPath; }
+
+private:
+	// ポーリング時に保持する部屋フォルダの状態
+	struct RoomSnapshot
+	{
+		Optional<FileStamp> directoryStamp;
+		HashTable<String, FileStamp> files;
+	};
+
+	// ポーリングで前回と比べる次元フォルダの状態（実行中のポーリングのワーカーだけが読み書きする）
+	struct Snapshot
+	{
+		HashTable<String, FileStamp> rootFiles;
+
+		HashTable<String, RoomSnapshot> rooms;
+
+		// 最初のポーリングで取る（それまでは比べる相手がない）
+		bool isTaken = false;
+	};
+
+	static constexpr double PollingIntervalSec = 2.0;
+
+	// 次のポーリングをワーカースレッドで始める
+	void startPolling();
+
+	static void TakeSnapshot(const FilePath& rootPath, Snapshot& snapshot, const std::atomic<bool>& cancelled);
+
+	static void PollChanges(const FilePath& rootPath, Snapshot& snapshot, Array<DimensionChange>& changes, const std::atomic<bool>& cancelled);
+
+	[[nodiscard]]
+	static RoomSnapshot ScanRoom(const FilePath& roomPath);
+
+	FilePath m_rootPath;
+
+	std::unique_ptr<DirectoryWatcher> m_watcher;
+
+	// 前回のポーリングが終わってからの時間
+	Stopwatch m_pollingTimer;
+
+	// start() ごとに作り直す（取り消したワーカーが、次の監視の状態を書き換えないようにする）
+	std::shared_ptr<Snapshot> m_snapshot;
+
+	std::shared_ptr<std::atomic<bool>> m_cancelled;
+
+	// 実行中のポーリング（同時に1つだけ）
+	AsyncTask<Array<DimensionChange>> m_pollingTask;
+};
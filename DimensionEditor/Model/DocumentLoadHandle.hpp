@@ -0,0 +1,49 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include "EditorDocument.hpp"
+
+// バックグラウンドで行っている文書読み込みのハンドル（future のように完了を問い合わせて結果を受け取る）
+// AsyncTask は破棄時に完了を待つため、取り消したハンドルは完了するまで呼び出し側で保持すること
+class DocumentLoadHandle
+{
+public:
+	DocumentLoadHandle() = default;
+
+	DocumentLoadHandle(const FilePath& path, AsyncTask<std::shared_ptr<EditorDocument>>&& task, std::shared_ptr<std::atomic<bool>> cancelled)
+		: m_path{ path }
+		, m_task{ std::move(task) }
+		, m_cancelled{ std::move(cancelled) } {}
+
+	[[nodiscard]]
+	bool isValid() const { return m_task.isValid(); }
+
+	// 読み込みが完了していれば true
+	[[nodiscard]]
+	bool isReady() const { return m_task.isReady(); }
+
+	// 結果を受け取る（isReady() が true になってから1回だけ呼ぶ。取り消された場合は nullptr）
+	[[nodiscard]]
+	std::shared_ptr<EditorDocument> get() { return m_task.get(); }
+
+	// 結果を不要にする。ワーカーがまだ読み込みを始めていなければ、読み込み自体を行わない
+	void cancel()
+	{
+		if (m_cancelled)
+		{
+			*m_cancelled = true;
+		}
+	}
+
+	[[nodiscard]]
+	bool isCancelled() const { return (m_cancelled && *m_cancelled); }
+
+	[[nodiscard]]
+	const FilePath& getPath() const { return m_path; }
+
+private:
+	FilePath m_path;
+
+	AsyncTask<std::shared_ptr<EditorDocument>> m_task;
+
+	std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
@@ -0,0 +1,125 @@
+﻿#include "EditorDocument.hpp"
+#include "JsonStreamWriter.hpp"
+
+EditorDocument::EditorDocument(const FilePath& path, JSON json)
+	: m_path{ path }
+	, m_json{ std::move(json) }
+	, m_persistedHash{ ComputeHash(m_json) }
+	, m_history{ { .root = PersistentJson::FromJSON(m_json), .path = {} } }
+{
+}
+
+void EditorDocument::markModified(const PersistentJson::Path& path, const bool mergeSamePath)
+{
+	++m_revision;
+	m_dirty = true;
+
+	const PersistentJson::NodePtr& current = m_history[m_historyIndex].root;
+	PersistentJson::NodePtr root = PersistentJson::UpdateAt(current, m_json, path);
+
+	// 内容が変わっていなければ履歴に残さない
+	if (root == current)
+	{
+		return;
+	}
+
+	// 最後の変更と同じ位置なら、その変更を置き換える
+	if (mergeSamePath && m_canMerge && (m_history[m_historyIndex].path == path))
+	{
+		m_history[m_historyIndex].root = std::move(root);
+		return;
+	}
+
+	// やり直し用の履歴は捨てる
+	m_history.resize(m_historyIndex + 1);
+	m_history.push_back({ .root = std::move(root), .path = path });
+
+	if (MaxHistory < m_history.size())
+	{
+		m_history.pop_front();
+	}
+
+	m_historyIndex = (m_history.size() - 1);
+	m_canMerge = true;
+}
+
+bool EditorDocument::undo()
+{
+	if (not canUndo())
+	{
+		return false;
+	}
+
+	const HistoryEntry& entry = m_history[m_historyIndex];
+	const PersistentJson::NodePtr previous = PersistentJson::Find(m_history[m_historyIndex - 1].root, entry.path);
+	PersistentJson::AssignJSON(m_json, entry.path, (previous ? Optional<JSON>{ PersistentJson::ToJSON(previous) } : none));
+
+	--m_historyIndex;
+	++m_revision;
+	m_dirty = true;
+	m_canMerge = false;
+	return true;
+}
+
+bool EditorDocument::redo()
+{
+	if (not canRedo())
+	{
+		return false;
+	}
+
+	const HistoryEntry& entry = m_history[m_historyIndex + 1];
+	const PersistentJson::NodePtr next = PersistentJson::Find(entry.root, entry.path);
+	PersistentJson::AssignJSON(m_json, entry.path, (next ? Optional<JSON>{ PersistentJson::ToJSON(next) } : none));
+
+	++m_historyIndex;
+	++m_revision;
+	m_dirty = true;
+	m_canMerge = false;
+	return true;
+}
+
+bool EditorDocument::commitForSave()
+{
+	const uint64 hash = ComputeHash(m_json);
+	m_dirty = false;
+	m_canMerge = false;
+
+	if (m_persistedHash == hash)
+	{
+		return false;
+	}
+
+	m_persistedHash = hash;
+	return true;
+}
+
+void EditorDocument::markSaveFailed()
+{
+	m_persistedHash.reset();
+	m_dirty = true;
+}
+
+uint64 EditorDocument::ComputeHash(const JSON& json)
+{
+	constexpr uint64 OffsetBasis = 14695981039346656037ull;
+	constexpr uint64 Prime = 1099511628211ull;
+
+	uint64 hash = OffsetBasis;
+
+	// 文字列全体を作らず、書き出しながらハッシュを計算する
+	JsonStreamWriter writer{ [&hash](std::string_view chunk)
+		{
+			for (const char ch : chunk)
+			{
+				hash ^= static_cast<uint8>(ch);
+				hash *= Prime;
+			}
+
+			return true;
+		} };
+
+	writer.write(json);
+
+	return hash;
+}
@@ -0,0 +1,102 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include <deque>
+#include "PersistentJson.hpp"
+
+// エディタで開いている1つの JSON 文書
+// ・内容を書き換えたら markModified() を呼ぶ（未保存の変更の有無と、変更回数を記録する）
+// ・最後に保存（または読み込み）した内容のハッシュを持ち、保存時に内容が同じなら書き込みを省く
+// ・変更の履歴を PersistentJson の根として持ち、元に戻す・やり直す（1回の変更で増えるのは変更した経路の分だけ）
+class EditorDocument
+{
+public:
+	// 履歴に残す変更の最大数
+	static constexpr size_t MaxHistory = 10000;
+
+	// 読み込んだ内容をそのまま保存済みの状態として開く
+	EditorDocument(const FilePath& path, JSON json);
+
+	[[nodiscard]]
+	const FilePath& getPath() const { return m_path; }
+
+	[[nodiscard]]
+	JSON& getJson() { return m_json; }
+
+	[[nodiscard]]
+	const JSON& getJson() const { return m_json; }
+
+	// 現在の内容を表す変更できない木（getJson() を書き換えた場合は、markModified() を呼んだ時点で更新される）
+	// 子の値を取り出しても確保しないので、毎フレームの表示はこちらから読む
+	[[nodiscard]]
+	const PersistentJson::NodePtr& getRoot() const { return m_history[m_historyIndex].root; }
+
+	// 内容を書き換えたら呼ぶ。path には変更した値の位置（またはそれを含む位置）を渡す
+	// path の部分だけを比較して履歴に記録するので、できるだけ狭い位置を渡すほど速い（空なら文書全体）
+	// mergeSamePath なら、直前の変更と同じ位置の変更を1つの変更にまとめる（文字の入力やドラッグを1回で元に戻せる）
+	void markModified(const PersistentJson::Path& path = {}, bool mergeSamePath = true);
+
+	[[nodiscard]]
+	bool canUndo() const { return (0 < m_historyIndex); }
+
+	[[nodiscard]]
+	bool canRedo() const { return ((m_historyIndex + 1) < m_history.size()); }
+
+	// 直前の変更を元に戻す（変更した位置の値だけを履歴から復元する）
+	bool undo();
+
+	bool redo();
+
+	// 履歴に残っている状態の数（最初の状態を含む）
+	[[nodiscard]]
+	size_t getHistorySize() const { return m_history.size(); }
+
+	// 保存していない変更があれば true（変更後に元へ戻した場合も、保存するまでは true）
+	[[nodiscard]]
+	bool isDirty() const { return m_dirty; }
+
+	// 内容を書き換えた回数
+	[[nodiscard]]
+	uint64 getRevision() const { return m_revision; }
+
+	// 保存の直前に呼ぶ。内容が最後に保存したものと同じなら false を返し、書き込みは不要
+	// true を返した場合は、現在の内容を保存済みとして記録する
+	[[nodiscard]]
+	bool commitForSave();
+
+	// 保存に失敗した場合に呼ぶ（次の保存では必ず書き込む）
+	void markSaveFailed();
+
+	// 保存される形式（JSON::save と同じ UTF-8）のハッシュ（FNV-1a 64bit）
+	[[nodiscard]]
+	static uint64 ComputeHash(const JSON& json);
+
+private:
+	FilePath m_path;
+
+	JSON m_json;
+
+	// 最後に保存（または読み込み）した内容のハッシュ。保存に失敗した場合は none
+	Optional<uint64> m_persistedHash;
+
+	uint64 m_revision = 0;
+
+	bool m_dirty = false;
+
+	struct HistoryEntry
+	{
+		// この状態の文書全体
+		PersistentJson::NodePtr root;
+
+		// 1つ前の状態から変更した位置
+		PersistentJson::Path path;
+	};
+
+	// 上限を超えたら先頭から捨てるので、先頭の削除が定数時間の deque で持つ
+	std::deque<HistoryEntry> m_history;
+
+	// 現在の状態の m_history での位置
+	size_t m_historyIndex = 0;
+
+	// 次の変更を最後の変更にまとめてよいか（元に戻す・やり直す・保存の後はまとめない）
+	bool m_canMerge = false;
+};
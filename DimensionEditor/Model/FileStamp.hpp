@@ -0,0 +1,46 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include <filesystem>
+
+// ファイルの更新日時とサイズ（変更検出用）
+struct FileStamp
+{
+	int64 writeTime = 0;
+	int64 size = 0;
+
+	[[nodiscard]]
+	friend bool operator ==(const FileStamp&, const FileStamp&) = default;
+
+	// 更新日時とサイズをまとめて取得する。存在しない場合は none
+	[[nodiscard]]
+	static Optional<FileStamp> Query(const FilePath& path)
+	{
+		std::error_code ec;
+		const std::filesystem::directory_entry entry{ std::filesystem::path{ path.str() }, ec };
+
+		if (ec || (not entry.exists(ec)))
+		{
+			return none;
+		}
+
+		FileStamp stamp;
+		stamp.writeTime = static_cast<int64>(entry.last_write_time(ec).time_since_epoch().count());
+
+		if (ec)
+		{
+			return none;
+		}
+
+		if (entry.is_regular_file(ec))
+		{
+			stamp.size = static_cast<int64>(entry.file_size(ec));
+
+			if (ec)
+			{
+				return none;
+			}
+		}
+
+		return stamp;
+	}
+};
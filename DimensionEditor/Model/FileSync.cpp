@@ -0,0 +1,39 @@
+﻿#include "FileSync.hpp"
+
+#if SIV3D_PLATFORM(WINDOWS)
+#	include <Siv3D/Windows/Windows.hpp>
+#else
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+bool SyncFile(const FilePath& path)
+{
+#if SIV3D_PLATFORM(WINDOWS)
+
+	const HANDLE file = ::CreateFileW(path.toWstr().c_str(), GENERIC_WRITE, (FILE_SHARE_READ | FILE_SHARE_WRITE), nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	const bool succeeded = (::FlushFileBuffers(file) != 0);
+	::CloseHandle(file);
+	return succeeded;
+
+#else
+
+	const int fd = ::open(path.toUTF8().c_str(), O_WRONLY);
+
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	const bool succeeded = (::fsync(fd) == 0);
+	::close(fd);
+	return succeeded;
+
+#endif
+}
@@ -0,0 +1,7 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+
+// ファイルの内容を OS のキャッシュからディスクまで書き出す（BinaryWriter::flush は C ランタイムのバッファしか書き出さない）
+// 一時ファイルに書いてから置き換える保存では、置き換える前に呼ぶ（置き換えた後に中身のないファイルが残らないようにする）
+[[nodiscard]]
+bool SyncFile(const FilePath& path);
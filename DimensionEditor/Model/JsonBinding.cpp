@@ -0,0 +1,47 @@
+﻿#include "JsonBinding.hpp"
+
+namespace
+{
+	// nlohmann::json の値1つ（型のタグと値の共用体）
+	constexpr size_t JsonValueBytes = 16;
+
+	// std::map の節（左右と親へのポインタ、色と番兵のフラグ）と、キーと値の組
+	constexpr size_t MapNodeBytes = (32 + sizeof(std::string) + JsonValueBytes);
+}
+
+namespace JsonBinding
+{
+	size_t EstimateHeapBytes(const JSON& json)
+	{
+		switch (json.getType())
+		{
+		case JSONValueType::Object:
+			{
+				size_t bytes = 0;
+
+				// オブジェクトは std::map を別に確保し、メンバーごとに節を確保する（キーは UTF-8 の std::string）
+				for (const auto& member : json)
+				{
+					bytes += (MapNodeBytes + StringFootprint::StdHeapBytes(member.key.toUTF8().size()) + EstimateHeapBytes(member.value));
+				}
+
+				return (sizeof(std::map<std::string, int>) + bytes);
+			}
+		case JSONValueType::Array:
+			{
+				size_t bytes = (sizeof(std::vector<int>) + (json.size() * JsonValueBytes));
+
+				for (const auto& element : json.arrayView())
+				{
+					bytes += EstimateHeapBytes(element);
+				}
+
+				return bytes;
+			}
+		case JSONValueType::String:
+			return (sizeof(std::string) + StringFootprint::StdHeapBytes(json.getString().toUTF8().size()));
+		default:
+			return 0;
+		}
+	}
+}
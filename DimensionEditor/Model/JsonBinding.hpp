@@ -0,0 +1,386 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include <tuple>
+#include "Atom.hpp"
+#include "StringFootprint.hpp"
+
+// 構造体に対応するキーのないメンバー（キーと値をそのまま持ち、書き出すときに戻す）
+using UnknownMembers = Array<std::pair<String, JSON>>;
+
+// 構造体と JSON の対応。型ごとに特殊化し、次のものを持たせる
+//   static constexpr auto Fields = std::tuple{ JsonBinding::Bind(U"key", &Type::member), ... };
+//   static constexpr UnknownMembers Type::* Unknown = &Type::unknown;
+template <class Type>
+struct Binding;
+
+// 構造体と JSON の相互変換
+// ・読み込みはオブジェクトのメンバーを1回だけ走査し、キーは Atom の整数比較で対応するメンバーを探す
+// ・対応するメンバーのないキーと、型が合わない値は UnknownMembers にそのまま残す（書き出すと元に戻る）
+// ・Optional と std::unique_ptr のメンバーは、値がなければ書き出さない。それ以外のメンバーは常に書き出す
+namespace JsonBinding
+{
+	// 構造体のメンバー1つと、JSON のキーの対応
+	template <class Owner, class Member>
+	struct Field
+	{
+		Atom key;
+
+		Member Owner::* member;
+	};
+
+	// キーは定義済みの Atom に限る（g_StaticAtomNames にないキーはコンパイルエラーになる）
+	template <class Owner, class Member>
+	consteval Field<Owner, Member> Bind(const StringView key, Member Owner::* member)
+	{
+		return{ Atom::Static(key), member };
+	}
+
+	// 値を読み書きする。Read は型が合わなければ false を返し、out は書き換えない
+	template <class Type>
+	struct Codec;
+
+	// JSON の値が、値自体の大きさとは別に確保するバイト数の見積もり（nlohmann::json の std::map と std::string の配置で数える）
+	[[nodiscard]]
+	size_t EstimateHeapBytes(const JSON& json);
+
+	// 値を持つメンバーか（Optional と std::unique_ptr は空なら false）
+	template <class Type>
+	[[nodiscard]]
+	bool HasValue(const Type&) { return true; }
+
+	template <class Type>
+	[[nodiscard]]
+	bool HasValue(const Optional<Type>& value) { return value.has_value(); }
+
+	template <class Type>
+	[[nodiscard]]
+	bool HasValue(const std::unique_ptr<Type>& value) { return static_cast<bool>(value); }
+
+	template <class Type>
+	using MemberType = std::remove_cvref_t<Type>;
+
+	// field のキーが key なら value を読み、true を返す（読めたかどうかは bound に返す）
+	template <class Type, class Field>
+	bool ReadField(const Field& field, const Atom key, const JSON& value, Type& out, bool& bound)
+	{
+		if (field.key != key)
+		{
+			return false;
+		}
+
+		bound = Codec<MemberType<decltype(out.*field.member)>>::Read(value, out.*field.member);
+		return true;
+	}
+
+	template <class Type, class Field>
+	void WriteField(const Field& field, const Type& value, JSON& json)
+	{
+		const auto& member = (value.*field.member);
+
+		if (HasValue(member))
+		{
+			json[field.key.str()] = Codec<MemberType<decltype(member)>>::Write(member);
+		}
+	}
+
+	template <class Type>
+	[[nodiscard]]
+	bool ReadObject(const JSON& json, Type& out)
+	{
+		if (not json.isObject())
+		{
+			return false;
+		}
+
+		for (const auto& member : json)
+		{
+			bool bound = false;
+
+			// インターンされていないキーは、どのメンバーのキーでもない
+			if (const Optional<Atom> key = Atom::Find(member.key))
+			{
+				// キーが一致したメンバーで止める
+				std::apply([&](const auto&... fields) { (ReadField(fields, *key, member.value, out, bound) || ...); }, Binding<Type>::Fields);
+			}
+
+			if (not bound)
+			{
+				(out.*Binding<Type>::Unknown).emplace_back(member.key, member.value);
+			}
+		}
+
+		return true;
+	}
+
+	template <class Type>
+	[[nodiscard]]
+	JSON WriteObject(const Type& value)
+	{
+		JSON json;
+
+		std::apply([&](const auto&... fields) { (WriteField(fields, value, json), ...); }, Binding<Type>::Fields);
+
+		for (const auto& [key, member] : (value.*Binding<Type>::Unknown))
+		{
+			json[key] = member;
+		}
+
+		return json;
+	}
+
+	// 値が確保しているバイト数（構造体自体の大きさは含まない）
+	template <class Type>
+	[[nodiscard]]
+	size_t ObjectHeapBytes(const Type& value)
+	{
+		size_t bytes = 0;
+
+		std::apply([&](const auto&... fields)
+			{
+				((bytes += Codec<MemberType<decltype(value.*fields.member)>>::HeapBytes(value.*fields.member)), ...);
+			}, Binding<Type>::Fields);
+
+		const UnknownMembers& unknown = (value.*Binding<Type>::Unknown);
+		bytes += (unknown.capacity() * sizeof(std::pair<String, JSON>));
+
+		for (const auto& [key, member] : unknown)
+		{
+			bytes += (StringFootprint::HeapBytes(key.capacity()) + EstimateHeapBytes(member));
+		}
+
+		return bytes;
+	}
+
+	// Binding を持つ構造体はオブジェクトとして読み書きする
+	template <class Type>
+	struct Codec
+	{
+		[[nodiscard]]
+		static bool Read(const JSON& json, Type& out)
+		{
+			Type value{};
+
+			if (not ReadObject(json, value))
+			{
+				return false;
+			}
+
+			out = std::move(value);
+			return true;
+		}
+
+		[[nodiscard]]
+		static JSON Write(const Type& value) { return WriteObject(value); }
+
+		[[nodiscard]]
+		static size_t HeapBytes(const Type& value) { return ObjectHeapBytes(value); }
+	};
+
+	template <>
+	struct Codec<String>
+	{
+		[[nodiscard]]
+		static bool Read(const JSON& json, String& out)
+		{
+			if (not json.isString())
+			{
+				return false;
+			}
+
+			out = json.getString();
+			return true;
+		}
+
+		[[nodiscard]]
+		static JSON Write(const String& value) { return JSON(value); }
+
+		[[nodiscard]]
+		static size_t HeapBytes(const String& value) { return StringFootprint::HeapBytes(value.capacity()); }
+	};
+
+	// 候補から選ぶ値の文字列。文字列の本体は Atom の表が持つ
+	// 表にない文字列はインターンせず、型が合わないものとして UnknownMembers に残す（文書の値で表を増やさない）
+	template <>
+	struct Codec<Atom>
+	{
+		[[nodiscard]]
+		static bool Read(const JSON& json, Atom& out)
+		{
+			if (not json.isString())
+			{
+				return false;
+			}
+
+			const Optional<Atom> atom = Atom::Find(json.getString());
+
+			if (not atom)
+			{
+				return false;
+			}
+
+			out = *atom;
+			return true;
+		}
+
+		[[nodiscard]]
+		static JSON Write(const Atom value) { return JSON(String{ value.str() }); }
+
+		[[nodiscard]]
+		static size_t HeapBytes(const Atom) { return 0; }
+	};
+
+	template <>
+	struct Codec<bool>
+	{
+		[[nodiscard]]
+		static bool Read(const JSON& json, bool& out)
+		{
+			if (not json.isBool())
+			{
+				return false;
+			}
+
+			out = json.get<bool>();
+			return true;
+		}
+
+		[[nodiscard]]
+		static JSON Write(const bool value) { return JSON(value); }
+
+		[[nodiscard]]
+		static size_t HeapBytes(const bool) { return 0; }
+	};
+
+	// 整数だけを読む（小数は型が合わないものとして UnknownMembers に残し、書き出したときに表記が変わらないようにする）
+	template <>
+	struct Codec<int32>
+	{
+		[[nodiscard]]
+		static bool Read(const JSON& json, int32& out)
+		{
+			if (not json.isInteger())
+			{
+				return false;
+			}
+
+			const Optional<int32> value = json.getOpt<int32>();
+
+			if (not value)
+			{
+				return false;
+			}
+
+			out = *value;
+			return true;
+		}
+
+		[[nodiscard]]
+		static JSON Write(const int32 value) { return JSON(value); }
+
+		[[nodiscard]]
+		static size_t HeapBytes(const int32) { return 0; }
+	};
+
+	template <class Type>
+	struct Codec<Array<Type>>
+	{
+		[[nodiscard]]
+		static bool Read(const JSON& json, Array<Type>& out)
+		{
+			if (not json.isArray())
+			{
+				return false;
+			}
+
+			Array<Type> values(json.size());
+			size_t i = 0;
+
+			for (const auto& element : json.arrayView())
+			{
+				if (not Codec<Type>::Read(element, values[i++]))
+				{
+					return false;
+				}
+			}
+
+			out = std::move(values);
+			return true;
+		}
+
+		[[nodiscard]]
+		static JSON Write(const Array<Type>& values)
+		{
+			Array<JSON> elements;
+			elements.reserve(values.size());
+
+			for (const auto& value : values)
+			{
+				elements.push_back(Codec<Type>::Write(value));
+			}
+
+			return JSON(elements);
+		}
+
+		[[nodiscard]]
+		static size_t HeapBytes(const Array<Type>& values)
+		{
+			size_t bytes = (values.capacity() * sizeof(Type));
+
+			for (const auto& value : values)
+			{
+				bytes += Codec<Type>::HeapBytes(value);
+			}
+
+			return bytes;
+		}
+	};
+
+	template <class Type>
+	struct Codec<Optional<Type>>
+	{
+		[[nodiscard]]
+		static bool Read(const JSON& json, Optional<Type>& out)
+		{
+			Type value{};
+
+			if (not Codec<Type>::Read(json, value))
+			{
+				return false;
+			}
+
+			out = std::move(value);
+			return true;
+		}
+
+		[[nodiscard]]
+		static JSON Write(const Optional<Type>& value) { return Codec<Type>::Write(*value); }
+
+		[[nodiscard]]
+		static size_t HeapBytes(const Optional<Type>& value) { return (value ? Codec<Type>::HeapBytes(*value) : 0); }
+	};
+
+	// 自身を子に持つ構造体（アクションの success など）
+	template <class Type>
+	struct Codec<std::unique_ptr<Type>>
+	{
+		[[nodiscard]]
+		static bool Read(const JSON& json, std::unique_ptr<Type>& out)
+		{
+			auto value = std::make_unique<Type>();
+
+			if (not Codec<Type>::Read(json, *value))
+			{
+				return false;
+			}
+
+			out = std::move(value);
+			return true;
+		}
+
+		[[nodiscard]]
+		static JSON Write(const std::unique_ptr<Type>& value) { return (value ? Codec<Type>::Write(*value) : JSON(nullptr)); }
+
+		[[nodiscard]]
+		static size_t HeapBytes(const std::unique_ptr<Type>& value) { return (value ? (sizeof(Type) + Codec<Type>::HeapBytes(*value)) : 0); }
+	};
+}
@@ -0,0 +1,161 @@
+﻿#include "JsonDocumentCache.hpp"
+
+JsonDocumentCache::JsonDocumentCache(const size_t budgetBytes)
+	: m_budgetBytes{ budgetBytes }
+{
+}
+
+JSON JsonDocumentCache::load(const FilePath& path)
+{
+	const FilePath key = NormalizePath(path);
+	const Optional<FileStamp> stamp = FileStamp::Query(key);
+
+	if (not stamp)
+	{
+		invalidate(key);
+		return JSON::Invalid();
+	}
+
+	std::shared_ptr<const JSON> document;
+	{
+		std::lock_guard lock{ m_mutex };
+
+		if (auto it = m_index.find(key); it != m_index.end())
+		{
+			if (it->second->stamp == *stamp)
+			{
+				// 最近使われたものとして先頭に移動
+				m_entries.splice(m_entries.begin(), m_entries, it->second);
+				document = it->second->document;
+				++m_hits;
+			}
+			else
+			{
+				eraseEntry(it->second);
+			}
+		}
+
+		if (not document)
+		{
+			++m_misses;
+		}
+	}
+
+	if (document)
+	{
+		return *document;
+	}
+
+	// パースはロックの外で行う（他のスレッドのヒットを待たせない）
+	JSON json = JSON::Load(key);
+
+	if (json)
+	{
+		insert(key, *stamp, std::make_shared<const JSON>(json));
+	}
+
+	return json;
+}
+
+void JsonDocumentCache::store(const FilePath& path, const JSON& json)
+{
+	const FilePath key = NormalizePath(path);
+
+	if (const auto stamp = FileStamp::Query(key))
+	{
+		insert(key, *stamp, std::make_shared<const JSON>(json));
+	}
+	else
+	{
+		invalidate(key);
+	}
+}
+
+void JsonDocumentCache::invalidate(const FilePath& path)
+{
+	const FilePath key = NormalizePath(path);
+
+	std::lock_guard lock{ m_mutex };
+
+	if (auto it = m_index.find(key); it != m_index.end())
+	{
+		eraseEntry(it->second);
+	}
+}
+
+void JsonDocumentCache::clear()
+{
+	std::lock_guard lock{ m_mutex };
+
+	m_entries.clear();
+	m_index.clear();
+	m_usedBytes = 0;
+}
+
+void JsonDocumentCache::setBudget(const size_t budgetBytes)
+{
+	std::lock_guard lock{ m_mutex };
+
+	m_budgetBytes = budgetBytes;
+	evict();
+}
+
+JsonDocumentCache::Stats JsonDocumentCache::getStats() const
+{
+	std::lock_guard lock{ m_mutex };
+
+	return{
+		.hits = m_hits,
+		.misses = m_misses,
+		.evictions = m_evictions,
+		.entryCount = m_entries.size(),
+		.usedBytes = m_usedBytes,
+		.budgetBytes = m_budgetBytes,
+	};
+}
+
+FilePath JsonDocumentCache::NormalizePath(const FilePath& path)
+{
+	// "dimension//North/Lockbox.json" と "dimension/North/Lockbox.json" を同じキーにする
+	return FileSystem::FullPath(path);
+}
+
+void JsonDocumentCache::insert(const FilePath& key, const FileStamp& stamp, std::shared_ptr<const JSON> document)
+{
+	std::lock_guard lock{ m_mutex };
+
+	if (auto it = m_index.find(key); it != m_index.end())
+	{
+		eraseEntry(it->second);
+	}
+
+	const size_t cost = Max<size_t>(static_cast<size_t>(stamp.size), 1) * DomCostFactor;
+
+	// 1つで上限を超える文書はキャッシュしない
+	if (m_budgetBytes < cost)
+	{
+		return;
+	}
+
+	m_entries.push_front({ .path = key, .stamp = stamp, .document = std::move(document), .cost = cost });
+	m_index[key] = m_entries.begin();
+	m_usedBytes += cost;
+
+	evict();
+}
+
+void JsonDocumentCache::eraseEntry(const EntryList::iterator it)
+{
+	m_usedBytes -= it->cost;
+	m_index.erase(it->path);
+	m_entries.erase(it);
+}
+
+void JsonDocumentCache::evict()
+{
+	while ((m_budgetBytes < m_usedBytes) && (not m_entries.empty()))
+	{
+		eraseEntry(std::prev(m_entries.end()));
+		++m_evictions;
+	}
+}
@@ -0,0 +1,83 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include <list>
+#include <mutex>
+#include "FileStamp.hpp"
+
+// パース済みJSONのキャッシュ
+// パス・更新日時・サイズをキーに保持し、使用量が上限を超えたら最も古く使われたものから破棄する（LRU）
+// 複数スレッドから同時に呼び出してよい
+class JsonDocumentCache
+{
+public:
+	struct Stats
+	{
+		uint64 hits = 0;
+		uint64 misses = 0;
+		uint64 evictions = 0;
+		size_t entryCount = 0;
+		size_t usedBytes = 0;
+		size_t budgetBytes = 0;
+	};
+
+	static constexpr size_t DefaultBudgetBytes = (256 << 20);
+
+	explicit JsonDocumentCache(size_t budgetBytes = DefaultBudgetBytes);
+
+	// キャッシュが有効ならそのコピーを返し、無効（未登録・ファイル更新済み）ならパースして登録する
+	// 読み込めなかった場合は無効なJSONを返す
+	[[nodiscard]]
+	JSON load(const FilePath& path);
+
+	// 保存した内容をそのまま登録する（保存直後の再パースを避ける）
+	void store(const FilePath& path, const JSON& json);
+
+	void invalidate(const FilePath& path);
+
+	void clear();
+
+	void setBudget(size_t budgetBytes);
+
+	[[nodiscard]]
+	Stats getStats() const;
+
+private:
+	struct Entry
+	{
+		FilePath path;
+		FileStamp stamp;
+		std::shared_ptr<const JSON> document;
+		size_t cost = 0;
+	};
+
+	using EntryList = std::list<Entry>;
+
+	// DOMのメモリ使用量の見積もり（ファイルサイズに対する倍率）
+	static constexpr size_t DomCostFactor = 8;
+
+	[[nodiscard]]
+	static FilePath NormalizePath(const FilePath& path);
+
+	void insert(const FilePath& key, const FileStamp& stamp, std::shared_ptr<const JSON> document);
+
+	void eraseEntry(EntryList::iterator it);
+
+	void evict();
+
+	mutable std::mutex m_mutex;
+
+	// 先頭ほど最近使われたエントリ
+	EntryList m_entries;
+
+	HashTable<FilePath, EntryList::iterator> m_index;
+
+	size_t m_budgetBytes;
+
+	size_t m_usedBytes = 0;
+
+	uint64 m_hits = 0;
+
+	uint64 m_misses = 0;
+
+	uint64 m_evictions = 0;
+};
@@ -0,0 +1,484 @@
+﻿#include "JsonHeaderScanner.hpp"
+
+namespace
+{
+	class Scanner
+	{
+	public:
+		explicit Scanner(std::string_view input)
+			: m_it{ input.data() }
+			, m_end{ input.data() + input.size() } {}
+
+		void skipWhitespace()
+		{
+			while ((m_it < m_end) && ((*m_it == ' ') || (*m_it == '\t') || (*m_it == '\n') || (*m_it == '\r')))
+			{
+				++m_it;
+			}
+		}
+
+		// UTF-8 BOM を読み飛ばす
+		void skipBOM()
+		{
+			if (((m_end - m_it) >= 3) && (static_cast<uint8>(m_it[0]) == 0xEF) && (static_cast<uint8>(m_it[1]) == 0xBB) && (static_cast<uint8>(m_it[2]) == 0xBF))
+			{
+				m_it += 3;
+			}
+		}
+
+		[[nodiscard]]
+		bool consume(const char ch)
+		{
+			skipWhitespace();
+
+			if ((m_it < m_end) && (*m_it == ch))
+			{
+				++m_it;
+				return true;
+			}
+
+			return false;
+		}
+
+		[[nodiscard]]
+		char peek()
+		{
+			skipWhitespace();
+			return ((m_it < m_end) ? *m_it : '\0');
+		}
+
+		// 文字列を読み、引用符の内側をそのまま返す。エスケープを含むかどうかを hasEscape に返す
+		[[nodiscard]]
+		Optional<std::string_view> readRawString(bool& hasEscape)
+		{
+			hasEscape = false;
+
+			if (not consume('"'))
+			{
+				return none;
+			}
+
+			const char* begin = m_it;
+
+			while (m_it < m_end)
+			{
+				if (*m_it == '"')
+				{
+					const std::string_view raw{ begin, static_cast<size_t>(m_it - begin) };
+					++m_it;
+					return raw;
+				}
+
+				if (*m_it == '\\')
+				{
+					hasEscape = true;
+					++m_it;
+				}
+
+				++m_it;
+			}
+
+			return none;
+		}
+
+		// 値を1つ読み飛ばす
+		[[nodiscard]]
+		bool skipValue()
+		{
+			const char first = peek();
+
+			if (first == '"')
+			{
+				bool hasEscape;
+				return readRawString(hasEscape).has_value();
+			}
+
+			if ((first == '{') || (first == '['))
+			{
+				size_t depth = 0;
+
+				while (m_it < m_end)
+				{
+					const char ch = *m_it;
+
+					if (ch == '"')
+					{
+						bool hasEscape;
+						if (not readRawString(hasEscape))
+						{
+							return false;
+						}
+						continue;
+					}
+
+					++m_it;
+
+					if ((ch == '{') || (ch == '['))
+					{
+						++depth;
+					}
+					else if ((ch == '}') || (ch == ']'))
+					{
+						if (--depth == 0)
+						{
+							return true;
+						}
+					}
+				}
+
+				return false;
+			}
+
+			// 数値・true・false・null
+			const char* begin = m_it;
+
+			while ((m_it < m_end) && (*m_it != ',') && (*m_it != '}') && (*m_it != ']')
+				&& (*m_it != ' ') && (*m_it != '\t') && (*m_it != '\n') && (*m_it != '\r'))
+			{
+				++m_it;
+			}
+
+			return (begin != m_it);
+		}
+
+		// 配列の要素数を数える（要素の中身は読み飛ばす）
+		[[nodiscard]]
+		Optional<size_t> countArrayElements()
+		{
+			if (not consume('['))
+			{
+				return none;
+			}
+
+			if (consume(']'))
+			{
+				return 0;
+			}
+
+			size_t count = 0;
+
+			while (true)
+			{
+				if (not skipValue())
+				{
+					return none;
+				}
+
+				++count;
+
+				if (consume(','))
+				{
+					continue;
+				}
+
+				if (consume(']'))
+				{
+					return count;
+				}
+
+				return none;
+			}
+		}
+
+	private:
+		const char* m_it;
+
+		const char* m_end;
+	};
+
+	void AppendUTF8(std::string& out, const char32 codePoint)
+	{
+		if (codePoint < 0x80)
+		{
+			out.push_back(static_cast<char>(codePoint));
+		}
+		else if (codePoint < 0x800)
+		{
+			out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+			out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+		}
+		else if (codePoint < 0x10000)
+		{
+			out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+			out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+			out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+		}
+		else
+		{
+			out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+			out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+			out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+			out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+		}
+	}
+
+	Optional<char32> ParseHex4(const std::string_view s, const size_t pos)
+	{
+		if (s.size() < (pos + 4))
+		{
+			return none;
+		}
+
+		char32 value = 0;
+
+		for (size_t i = pos; i < (pos + 4); ++i)
+		{
+			const char ch = s[i];
+			value <<= 4;
+
+			if (('0' <= ch) && (ch <= '9'))
+			{
+				value |= static_cast<char32>(ch - '0');
+			}
+			else if (('a' <= ch) && (ch <= 'f'))
+			{
+				value |= static_cast<char32>(ch - 'a' + 10);
+			}
+			else if (('A' <= ch) && (ch <= 'F'))
+			{
+				value |= static_cast<char32>(ch - 'A' + 10);
+			}
+			else
+			{
+				return none;
+			}
+		}
+
+		return value;
+	}
+
+	// 引用符の内側のエスケープを解除して UTF-8 で返す
+	Optional<std::string> Unescape(const std::string_view raw)
+	{
+		std::string out;
+		out.reserve(raw.size());
+
+		for (size_t i = 0; i < raw.size(); ++i)
+		{
+			if (raw[i] != '\\')
+			{
+				out.push_back(raw[i]);
+				continue;
+			}
+
+			if (raw.size() <= ++i)
+			{
+				return none;
+			}
+
+			switch (raw[i])
+			{
+			case '"': out.push_back('"'); break;
+			case '\\': out.push_back('\\'); break;
+			case '/': out.push_back('/'); break;
+			case 'b': out.push_back('\b'); break;
+			case 'f': out.push_back('\f'); break;
+			case 'n': out.push_back('\n'); break;
+			case 'r': out.push_back('\r'); break;
+			case 't': out.push_back('\t'); break;
+			case 'u':
+				{
+					auto codePoint = ParseHex4(raw, (i + 1));
+
+					if (not codePoint)
+					{
+						return none;
+					}
+
+					i += 4;
+
+					// サロゲートペア
+					if ((0xD800 <= *codePoint) && (*codePoint <= 0xDBFF))
+					{
+						if ((raw.size() <= (i + 2)) || (raw[i + 1] != '\\') || (raw[i + 2] != 'u'))
+						{
+							return none;
+						}
+
+						const auto low = ParseHex4(raw, (i + 3));
+
+						if ((not low) || (*low < 0xDC00) || (0xDFFF < *low))
+						{
+							return none;
+						}
+
+						codePoint = (0x10000 + ((*codePoint - 0xD800) << 10) + (*low - 0xDC00));
+						i += 6;
+					}
+
+					AppendUTF8(out, *codePoint);
+					break;
+				}
+			default:
+				return none;
+			}
+		}
+
+		return out;
+	}
+
+	// raw（引用符の内側）が key と一致するか。エスケープを含むときだけ解除して比較する
+	bool KeyEquals(const std::string_view raw, const bool hasEscape, const std::string_view key)
+	{
+		if (not hasEscape)
+		{
+			return (raw == key);
+		}
+
+		const auto unescaped = Unescape(raw);
+		return (unescaped && (*unescaped == key));
+	}
+
+	Optional<String> ReadString(Scanner& scanner)
+	{
+		bool hasEscape;
+		const auto raw = scanner.readRawString(hasEscape);
+
+		if (not raw)
+		{
+			return none;
+		}
+
+		if (not hasEscape)
+		{
+			return Unicode::FromUTF8(*raw);
+		}
+
+		if (const auto unescaped = Unescape(*raw))
+		{
+			return Unicode::FromUTF8(*unescaped);
+		}
+
+		return none;
+	}
+}
+
+namespace JsonHeaderScanner
+{
+	Optional<ObjectMetadata> ScanObjectMetadata(const std::string_view utf8)
+	{
+		Scanner scanner{ utf8 };
+		scanner.skipBOM();
+
+		if (not scanner.consume('{'))
+		{
+			return none;
+		}
+
+		ObjectMetadata metadata;
+
+		if (scanner.consume('}'))
+		{
+			return metadata;
+		}
+
+		// JSON::Load と同じく、同じキーが複数あれば後のものを採るため、オブジェクトの終わりまで走査する
+		while (true)
+		{
+			bool hasEscape;
+			const auto key = scanner.readRawString(hasEscape);
+
+			if ((not key) || (not scanner.consume(':')))
+			{
+				return none;
+			}
+
+			if (KeyEquals(*key, hasEscape, "name"))
+			{
+				// 文字列でない値で上書きされたら、フィールドがないものとして扱う
+				metadata.name.clear();
+
+				if (scanner.peek() == '"')
+				{
+					const auto value = ReadString(scanner);
+
+					if (not value)
+					{
+						return none;
+					}
+
+					metadata.name = *value;
+				}
+				else if (not scanner.skipValue())
+				{
+					return none;
+				}
+			}
+			else if (KeyEquals(*key, hasEscape, "type"))
+			{
+				metadata.type = Atom{};
+
+				if (scanner.peek() == '"')
+				{
+					const auto value = ReadString(scanner);
+
+					if (not value)
+					{
+						return none;
+					}
+
+					metadata.type = Atom::Intern(*value);
+				}
+				else if (not scanner.skipValue())
+				{
+					return none;
+				}
+			}
+			else if (KeyEquals(*key, hasEscape, "hotspots"))
+			{
+				metadata.hotspotCount.reset();
+
+				if (scanner.peek() == '[')
+				{
+					metadata.hotspotCount = scanner.countArrayElements();
+
+					if (not metadata.hotspotCount)
+					{
+						return none;
+					}
+				}
+				else if (not scanner.skipValue())
+				{
+					return none;
+				}
+			}
+			else if (not scanner.skipValue())
+			{
+				return none;
+			}
+
+			if (scanner.consume(','))
+			{
+				continue;
+			}
+
+			if (scanner.consume('}'))
+			{
+				break;
+			}
+
+			return none;
+		}
+
+		return metadata;
+	}
+
+	Optional<ObjectMetadata> ScanFile(const FilePath& path)
+	{
+		MemoryMappedFileView file{ path };
+
+		if (not file)
+		{
+			return none;
+		}
+
+		const auto mapped = file.map();
+
+		if (not mapped.data)
+		{
+			return none;
+		}
+
+		return ScanObjectMetadata(std::string_view{ reinterpret_cast<const char*>(mapped.data), mapped.size });
+	}
+}
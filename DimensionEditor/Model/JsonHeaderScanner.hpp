@@ -0,0 +1,17 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include "DimensionModel.hpp"
+
+// JSON の先頭レベルのメンバーだけを走査し、必要なフィールドを取り出す
+// ・DOM を作らず、不要な値は括弧と文字列の対応だけを見て読み飛ばす
+// ・同じキーが複数あるときは JSON::Load と同じく後のものを採るため、先頭レベルのオブジェクトの終わりまで走査する
+namespace JsonHeaderScanner
+{
+	// UTF-8 の JSON から "name", "type", "hotspots" の要素数を取り出す（先頭レベルがオブジェクトでなければ none）
+	[[nodiscard]]
+	Optional<ObjectMetadata> ScanObjectMetadata(std::string_view utf8);
+
+	// ファイルをメモリマップして ScanObjectMetadata を行う
+	[[nodiscard]]
+	Optional<ObjectMetadata> ScanFile(const FilePath& path);
+}
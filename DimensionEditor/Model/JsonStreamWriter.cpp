@@ -0,0 +1,243 @@
+﻿#include "JsonStreamWriter.hpp"
+#include <charconv>
+#include <cmath>
+#include <ThirdParty/nlohmann/json.hpp>
+
+namespace
+{
+	constexpr size_t IndentWidth = 2;
+}
+
+JsonStreamWriter::JsonStreamWriter(Output output, const size_t bufferSize)
+	: m_output{ std::move(output) }
+	, m_bufferSize{ Max<size_t>(bufferSize, 1) }
+{
+	m_buffer.reserve(m_bufferSize);
+}
+
+bool JsonStreamWriter::write(const JSON& json)
+{
+	writeValue(json, 0);
+	flushBuffer();
+	return (not m_failed);
+}
+
+bool JsonStreamWriter::Save(const JSON& json, const FilePath& path)
+{
+	BinaryWriter writer{ path };
+
+	if (not writer)
+	{
+		return false;
+	}
+
+	JsonStreamWriter jsonWriter{ [&writer](std::string_view chunk)
+		{
+			return (writer.write(chunk.data(), static_cast<int64>(chunk.size())) == static_cast<int64>(chunk.size()));
+		} };
+
+	return jsonWriter.write(json);
+}
+
+void JsonStreamWriter::writeValue(const JSON& json, const size_t depth)
+{
+	switch (json.getType())
+	{
+	case JSONValueType::Object:
+		{
+			if (json.size() == 0)
+			{
+				put("{}");
+				return;
+			}
+
+			put("{\n");
+
+			bool first = true;
+
+			for (const auto& item : json)
+			{
+				if (not first)
+				{
+					put(",\n");
+				}
+				first = false;
+
+				writeIndent(depth + 1);
+				writeString(item.key);
+				put(": ");
+				writeValue(item.value, (depth + 1));
+			}
+
+			put('\n');
+			writeIndent(depth);
+			put('}');
+			return;
+		}
+	case JSONValueType::Array:
+		{
+			if (json.size() == 0)
+			{
+				put("[]");
+				return;
+			}
+
+			put("[\n");
+
+			bool first = true;
+
+			for (const auto& item : json.arrayView())
+			{
+				if (not first)
+				{
+					put(",\n");
+				}
+				first = false;
+
+				writeIndent(depth + 1);
+				writeValue(item, (depth + 1));
+			}
+
+			put('\n');
+			writeIndent(depth);
+			put(']');
+			return;
+		}
+	case JSONValueType::String:
+		writeString(json.getString());
+		return;
+	case JSONValueType::Number:
+		writeNumber(json);
+		return;
+	case JSONValueType::Bool:
+		put(json.get<bool>() ? "true" : "false");
+		return;
+	default:
+		put("null");
+		return;
+	}
+}
+
+void JsonStreamWriter::writeString(const StringView s)
+{
+	constexpr char HexDigits[] = "0123456789abcdef";
+
+	put('"');
+
+	for (const char32 ch : s)
+	{
+		switch (ch)
+		{
+		case U'"': put("\\\""); break;
+		case U'\\': put("\\\\"); break;
+		case U'\b': put("\\b"); break;
+		case U'\f': put("\\f"); break;
+		case U'\n': put("\\n"); break;
+		case U'\r': put("\\r"); break;
+		case U'\t': put("\\t"); break;
+		default:
+			if (ch < 0x20)
+			{
+				const char escaped[6] = { '\\', 'u', '0', '0', HexDigits[ch >> 4], HexDigits[ch & 0xF] };
+				put(std::string_view{ escaped, 6 });
+			}
+			else if (ch < 0x80)
+			{
+				put(static_cast<char>(ch));
+			}
+			else if (ch < 0x800)
+			{
+				put(static_cast<char>(0xC0 | (ch >> 6)));
+				put(static_cast<char>(0x80 | (ch & 0x3F)));
+			}
+			else if (ch < 0x10000)
+			{
+				put(static_cast<char>(0xE0 | (ch >> 12)));
+				put(static_cast<char>(0x80 | ((ch >> 6) & 0x3F)));
+				put(static_cast<char>(0x80 | (ch & 0x3F)));
+			}
+			else
+			{
+				put(static_cast<char>(0xF0 | (ch >> 18)));
+				put(static_cast<char>(0x80 | ((ch >> 12) & 0x3F)));
+				put(static_cast<char>(0x80 | ((ch >> 6) & 0x3F)));
+				put(static_cast<char>(0x80 | (ch & 0x3F)));
+			}
+			break;
+		}
+	}
+
+	put('"');
+}
+
+void JsonStreamWriter::writeNumber(const JSON& json)
+{
+	char buffer[64];
+
+	if (json.isUnsigned())
+	{
+		const auto [end, ec] = std::to_chars(std::begin(buffer), std::end(buffer), json.get<uint64>());
+		put(std::string_view{ buffer, static_cast<size_t>(end - buffer) });
+	}
+	else if (json.isInteger())
+	{
+		const auto [end, ec] = std::to_chars(std::begin(buffer), std::end(buffer), json.get<int64>());
+		put(std::string_view{ buffer, static_cast<size_t>(end - buffer) });
+	}
+	else
+	{
+		// 浮動小数点数は JSON::format() と同じ桁・表記になるよう、内部の nlohmann::json と同じ変換を使う
+		const double value = json.get<double>();
+
+		if (not std::isfinite(value))
+		{
+			put("null");
+			return;
+		}
+
+		const char* end = nlohmann::detail::to_chars(std::begin(buffer), std::end(buffer), value);
+		put(std::string_view{ buffer, static_cast<size_t>(end - buffer) });
+	}
+}
+
+void JsonStreamWriter::writeIndent(const size_t depth)
+{
+	for (size_t i = 0; i < (depth * IndentWidth); ++i)
+	{
+		put(' ');
+	}
+}
+
+void JsonStreamWriter::put(std::string_view s)
+{
+	while (not s.empty())
+	{
+		if (m_buffer.size() == m_bufferSize)
+		{
+			flushBuffer();
+		}
+
+		const size_t n = Min((m_bufferSize - m_buffer.size()), s.size());
+		m_buffer.append(s.data(), n);
+		s.remove_prefix(n);
+	}
+}
+
+void JsonStreamWriter::flushBuffer()
+{
+	if (m_buffer.empty())
+	{
+		return;
+	}
+
+	if ((not m_failed) && m_output && m_output(m_buffer))
+	{
+		m_writtenBytes += m_buffer.size();
+	}
+	else
+	{
+		m_failed = true;
+	}
+
+	m_buffer.clear();
+}
@@ -0,0 +1,59 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+
+// JSON を整形済み UTF-8 として逐次書き出す
+// ・出力は JSON::save / JSON::format() と同じ（インデント 2、キーは文字列順、非 ASCII はそのまま）
+// ・文書全体の文字列を作らず、一定サイズのバッファが埋まるたびに出力先へ渡すので、大きな文書でも使用メモリが増えない
+class JsonStreamWriter
+{
+public:
+	static constexpr size_t DefaultBufferSize = (64 * 1024);
+
+	// バッファの内容を受け取る出力先（失敗したら false を返す）
+	using Output = std::function<bool(std::string_view)>;
+
+	explicit JsonStreamWriter(Output output, size_t bufferSize = DefaultBufferSize);
+
+	// json を書き出し、残りのバッファも出力先へ渡す
+	bool write(const JSON& json);
+
+	// 書き出したバイト数
+	[[nodiscard]]
+	uint64 getWrittenBytes() const { return m_writtenBytes; }
+
+	// ファイルに書き出す（JSON::save の置き換え）
+	static bool Save(const JSON& json, const FilePath& path);
+
+private:
+	void writeValue(const JSON& json, size_t depth);
+
+	void writeString(StringView s);
+
+	void writeNumber(const JSON& json);
+
+	void writeIndent(size_t depth);
+
+	void put(char ch)
+	{
+		if (m_buffer.size() == m_bufferSize)
+		{
+			flushBuffer();
+		}
+
+		m_buffer.push_back(ch);
+	}
+
+	void put(std::string_view s);
+
+	void flushBuffer();
+
+	Output m_output;
+
+	size_t m_bufferSize;
+
+	std::string m_buffer;
+
+	uint64 m_writtenBytes = 0;
+
+	bool m_failed = false;
+};
@@ -0,0 +1,525 @@
+﻿#include "PersistentJson.hpp"
+#include "StringFootprint.hpp"
+
+namespace
+{
+	using PersistentJson::Node;
+	using PersistentJson::NodePtr;
+
+	// enumValue なら、インターン済みの文字列の値を Atom として持つ（表には加えない）
+	Node::Scalar ToScalar(const JSON& json, const bool enumValue)
+	{
+		switch (json.getType())
+		{
+		case JSONValueType::Bool:
+			return json.get<bool>();
+		case JSONValueType::Number:
+			if (json.isUnsigned())
+			{
+				return json.get<uint64>();
+			}
+			else if (json.isInteger())
+			{
+				return json.get<int64>();
+			}
+			return json.get<double>();
+		case JSONValueType::String:
+			if (enumValue)
+			{
+				if (const Optional<Atom> atom = Atom::Find(json.getString()))
+				{
+					return *atom;
+				}
+			}
+			return json.getString();
+		default:
+			return nullptr;
+		}
+	}
+
+	bool IsScalarType(const JSONValueType type)
+	{
+		return ((type != JSONValueType::Array) && (type != JSONValueType::Object));
+	}
+
+	Optional<size_t> FindMember(const Node& node, const Atom key)
+	{
+		for (size_t i = 0; i < node.members.size(); ++i)
+		{
+			if (node.members[i].first == key)
+			{
+				return i;
+			}
+		}
+
+		return none;
+	}
+
+	void MeasureFootprintImpl(const NodePtr& node, PersistentJson::Footprint& footprint)
+	{
+		if (not node)
+		{
+			return;
+		}
+
+		// make_shared は制御ブロック（仮想関数表と参照カウント 2 つ）とノードを1つの領域に確保する
+		++footprint.nodeCount;
+		footprint.bytes += (sizeof(Node) + sizeof(void*) + (2 * sizeof(long)));
+		footprint.bytes += (node->elements.capacity() * sizeof(NodePtr));
+		footprint.bytes += (node->members.capacity() * sizeof(std::pair<Atom, NodePtr>));
+
+		if (const String* value = std::get_if<String>(&node->scalar))
+		{
+			footprint.bytes += StringFootprint::HeapBytes(value->capacity());
+		}
+		else if (const Atom* atom = std::get_if<Atom>(&node->scalar))
+		{
+			footprint.stringKeyBytes += StringFootprint::HeapBytes(atom->str().size());
+		}
+
+		for (const auto& [key, child] : node->members)
+		{
+			++footprint.memberCount;
+			footprint.stringKeyBytes += ((sizeof(std::pair<String, NodePtr>) - sizeof(std::pair<Atom, NodePtr>)) + StringFootprint::HeapBytes(key.str().size()));
+			MeasureFootprintImpl(child, footprint);
+		}
+
+		for (const auto& element : node->elements)
+		{
+			MeasureFootprintImpl(element, footprint);
+		}
+	}
+
+	// path の末尾の値が置かれるキー（末尾が添字、または空の path なら空の Atom）
+	Atom LastKey(const PersistentJson::Path& path)
+	{
+		if (path.isEmpty())
+		{
+			return Atom{};
+		}
+
+		if (const String* key = std::get_if<String>(&path.back()))
+		{
+			// インターンされていないキーは、候補から選ぶ値のキーではない
+			return Atom::Find(*key).value_or(Atom{});
+		}
+
+		return Atom{};
+	}
+
+	NodePtr UpdateImpl(const NodePtr& base, const JSON& json, Atom key);
+
+	NodePtr AssignImpl(const NodePtr& current, const PersistentJson::Path& path, const size_t depth, const NodePtr& node)
+	{
+		if (depth == path.size())
+		{
+			return node;
+		}
+
+		// 経路上のノードは複製して作り直す（子ノードはポインタを共有する）
+		auto copied = (current ? std::make_shared<Node>(*current) : std::make_shared<Node>());
+
+		if (const String* key = std::get_if<String>(&path[depth]))
+		{
+			if (copied->type != JSONValueType::Object)
+			{
+				*copied = Node{ .type = JSONValueType::Object };
+			}
+
+			const Atom atom = Atom::Intern(*key);
+			const Optional<size_t> index = FindMember(*copied, atom);
+			const NodePtr child = AssignImpl((index ? copied->members[*index].second : nullptr), path, (depth + 1), node);
+
+			if (index)
+			{
+				if (child)
+				{
+					copied->members[*index].second = child;
+				}
+				else
+				{
+					copied->members.erase(copied->members.begin() + *index);
+				}
+			}
+			else if (child)
+			{
+				copied->members.emplace_back(atom, child);
+			}
+		}
+		else
+		{
+			const size_t index = std::get<size_t>(path[depth]);
+
+			if (copied->type != JSONValueType::Array)
+			{
+				*copied = Node{ .type = JSONValueType::Array };
+			}
+
+			const bool exists = (index < copied->elements.size());
+			const NodePtr child = AssignImpl((exists ? copied->elements[index] : nullptr), path, (depth + 1), node);
+
+			if (exists)
+			{
+				if (child)
+				{
+					copied->elements[index] = child;
+				}
+				else
+				{
+					copied->elements.erase(copied->elements.begin() + index);
+				}
+			}
+			else if (child)
+			{
+				copied->elements.push_back(child);
+			}
+		}
+
+		return copied;
+	}
+
+	NodePtr UpdateAtImpl(const NodePtr& base, JSON& current, const PersistentJson::Path& path, const size_t depth)
+	{
+		if (depth == path.size())
+		{
+			return UpdateImpl(base, current, LastKey(path));
+		}
+
+		if (const String* key = std::get_if<String>(&path[depth]))
+		{
+			if ((not current.isObject()) || (not current.hasElement(*key)))
+			{
+				return nullptr;
+			}
+
+			// operator[] は元の値を参照する JSON を返す（コピーしない）
+			JSON child = current[*key];
+			return UpdateAtImpl(base, child, path, (depth + 1));
+		}
+		else
+		{
+			const size_t index = std::get<size_t>(path[depth]);
+
+			if ((not current.isArray()) || (current.size() <= index))
+			{
+				return nullptr;
+			}
+
+			JSON child = current[index];
+			return UpdateAtImpl(base, child, path, (depth + 1));
+		}
+	}
+
+	void AssignJSONImpl(JSON& current, const PersistentJson::Path& path, const size_t depth, const Optional<JSON>& value)
+	{
+		const bool isLast = ((depth + 1) == path.size());
+
+		if (const String* key = std::get_if<String>(&path[depth]))
+		{
+			if (not current.isObject())
+			{
+				return;
+			}
+
+			if (isLast)
+			{
+				if (value)
+				{
+					current[*key] = *value;
+				}
+				else if (current.hasElement(*key))
+				{
+					current.erase(*key);
+				}
+				return;
+			}
+
+			if (current.hasElement(*key))
+			{
+				JSON child = current[*key];
+				AssignJSONImpl(child, path, (depth + 1), value);
+			}
+		}
+		else
+		{
+			const size_t index = std::get<size_t>(path[depth]);
+
+			if (not current.isArray())
+			{
+				return;
+			}
+
+			if (isLast)
+			{
+				if (value)
+				{
+					if (index < current.size())
+					{
+						current[index] = *value;
+					}
+					else
+					{
+						current.push_back(*value);
+					}
+				}
+				else if (index < current.size())
+				{
+					current.erase(index);
+				}
+				return;
+			}
+
+			if (index < current.size())
+			{
+				JSON child = current[index];
+				AssignJSONImpl(child, path, (depth + 1), value);
+			}
+		}
+	}
+
+	// key は json が置かれているメンバーのキー（配列の要素や根なら空の Atom）
+	NodePtr UpdateImpl(const NodePtr& base, const JSON& json, const Atom key)
+	{
+		const JSONValueType type = json.getType();
+
+		if (IsScalarType(type))
+		{
+			Node::Scalar scalar = ToScalar(json, Atoms::IsEnumKey(key));
+
+			if (base && (base->type == type) && (base->scalar == scalar))
+			{
+				return base;
+			}
+
+			return std::make_shared<Node>(Node{ .type = type, .scalar = std::move(scalar) });
+		}
+
+		auto node = std::make_shared<Node>(Node{ .type = type });
+		const bool sameType = (base && (base->type == type));
+		bool unchanged = sameType;
+
+		if (type == JSONValueType::Array)
+		{
+			node->elements.reserve(json.size());
+
+			size_t i = 0;
+			for (const auto& element : json.arrayView())
+			{
+				const NodePtr baseChild = ((sameType && (i < base->elements.size())) ? base->elements[i] : nullptr);
+				NodePtr child = UpdateImpl(baseChild, element, Atom{});
+				unchanged = (unchanged && (child == baseChild));
+				node->elements.push_back(std::move(child));
+				++i;
+			}
+
+			unchanged = (unchanged && (node->elements.size() == base->elements.size()));
+		}
+		else
+		{
+			node->members.reserve(json.size());
+
+			size_t i = 0;
+			for (const auto& member : json)
+			{
+				const Atom memberKey = Atom::Intern(member.key);
+
+				// メンバーの順序は変わらないことが多いので、まず同じ位置を調べる
+				NodePtr baseChild;
+
+				if (sameType)
+				{
+					if ((i < base->members.size()) && (base->members[i].first == memberKey))
+					{
+						baseChild = base->members[i].second;
+					}
+					else if (const auto index = FindMember(*base, memberKey))
+					{
+						baseChild = base->members[*index].second;
+						unchanged = false;
+					}
+				}
+
+				NodePtr child = UpdateImpl(baseChild, member.value, memberKey);
+				unchanged = (unchanged && (child == baseChild));
+				node->members.emplace_back(memberKey, std::move(child));
+				++i;
+			}
+
+			unchanged = (unchanged && (node->members.size() == base->members.size()));
+		}
+
+		return (unchanged ? base : node);
+	}
+}
+
+namespace PersistentJson
+{
+	NodePtr FromJSON(const JSON& json)
+	{
+		return Update(nullptr, json);
+	}
+
+	NodePtr Update(const NodePtr& base, const JSON& json)
+	{
+		return UpdateImpl(base, json, Atom{});
+	}
+
+	JSON ToJSON(const NodePtr& node)
+	{
+		if (not node)
+		{
+			return JSON(nullptr);
+		}
+
+		switch (node->type)
+		{
+		case JSONValueType::Array:
+			{
+				Array<JSON> elements;
+				elements.reserve(node->elements.size());
+
+				for (const auto& element : node->elements)
+				{
+					elements.push_back(ToJSON(element));
+				}
+
+				return JSON(elements);
+			}
+		case JSONValueType::Object:
+			{
+				JSON json;
+
+				for (const auto& [key, child] : node->members)
+				{
+					json[key.str()] = ToJSON(child);
+				}
+
+				return json;
+			}
+		default:
+			return std::visit([](const auto& value)
+				{
+					if constexpr (std::is_same_v<std::decay_t<decltype(value)>, Atom>)
+					{
+						return JSON(String{ value.str() });
+					}
+					else
+					{
+						return JSON(value);
+					}
+				}, node->scalar);
+		}
+	}
+
+	NodePtr Find(const NodePtr& root, const Path& path)
+	{
+		NodePtr node = root;
+
+		for (const auto& element : path)
+		{
+			if (not node)
+			{
+				return nullptr;
+			}
+
+			if (const String* key = std::get_if<String>(&element))
+			{
+				// インターンされていないキーは、どのノードのメンバーにもない
+				const Optional<Atom> atom = Atom::Find(*key);
+				const auto index = ((atom && (node->type == JSONValueType::Object)) ? FindMember(*node, *atom) : none);
+				node = (index ? node->members[*index].second : nullptr);
+			}
+			else
+			{
+				const size_t index = std::get<size_t>(element);
+				node = (((node->type == JSONValueType::Array) && (index < node->elements.size())) ? node->elements[index] : nullptr);
+			}
+		}
+
+		return node;
+	}
+
+	NodePtr GetMember(const NodePtr& node, const Atom key)
+	{
+		if ((not node) || (node->type != JSONValueType::Object))
+		{
+			return nullptr;
+		}
+
+		const Optional<size_t> index = FindMember(*node, key);
+		return (index ? node->members[*index].second : nullptr);
+	}
+
+	Optional<double> GetNumber(const Node& node)
+	{
+		if (node.type != JSONValueType::Number)
+		{
+			return none;
+		}
+
+		return std::visit([](const auto& value) -> Optional<double>
+			{
+				using Type = std::decay_t<decltype(value)>;
+
+				if constexpr (std::is_same_v<Type, int64> || std::is_same_v<Type, uint64> || std::is_same_v<Type, double>)
+				{
+					return static_cast<double>(value);
+				}
+				else
+				{
+					return none;
+				}
+			}, node.scalar);
+	}
+
+	StringView GetString(const Node& node)
+	{
+		if (const String* value = std::get_if<String>(&node.scalar))
+		{
+			return *value;
+		}
+
+		if (const Atom* atom = std::get_if<Atom>(&node.scalar))
+		{
+			return atom->str();
+		}
+
+		return{};
+	}
+
+	NodePtr Assign(const NodePtr& root, const Path& path, const NodePtr& node)
+	{
+		return AssignImpl(root, path, 0, node);
+	}
+
+	NodePtr UpdateAt(const NodePtr& root, JSON& json, const Path& path)
+	{
+		const NodePtr base = Find(root, path);
+		const NodePtr node = UpdateAtImpl(base, json, path, 0);
+
+		if (node == base)
+		{
+			return root;
+		}
+
+		return Assign(root, path, node);
+	}
+
+	void AssignJSON(JSON& root, const Path& path, const Optional<JSON>& value)
+	{
+		if (path.isEmpty())
+		{
+			root = (value ? *value : JSON(nullptr));
+			return;
+		}
+
+		AssignJSONImpl(root, path, 0, value);
+	}
+
+	Footprint MeasureFootprint(const NodePtr& root)
+	{
+		Footprint footprint;
+		MeasureFootprintImpl(root, footprint);
+		return footprint;
+	}
+}
@@ -0,0 +1,90 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include "Atom.hpp"
+
+// 変更できない（永続的な）JSON の木
+// ・ノードは一度作ったら書き換えず、変更は経路上のノードだけを作り直した新しい根として表す
+// ・変更されていない部分木は、古い根と新しい根で共有される（1回の変更のコストは 変更した経路 + 変更された部分木）
+// ・メンバーのキーと、候補から選ぶ値（Atoms::IsEnumKey）は Atom で持つ（文書や履歴の間で文字列を共有し、比較は整数で行う）
+namespace PersistentJson
+{
+	struct Node;
+
+	using NodePtr = std::shared_ptr<const Node>;
+
+	// JSON のパス上の1要素（オブジェクトのキー、または配列の添字）
+	using PathElement = std::variant<String, size_t>;
+
+	using Path = Array<PathElement>;
+
+	struct Node
+	{
+		// Null, Bool, 整数, 符号なし整数, 浮動小数点数, 文字列, 候補から選ぶ値の文字列
+		using Scalar = std::variant<std::nullptr_t, bool, int64, uint64, double, String, Atom>;
+
+		JSONValueType type = JSONValueType::Null;
+
+		Scalar scalar = nullptr;
+
+		// type が Array の場合の要素
+		Array<NodePtr> elements;
+
+		// type が Object の場合のメンバー（JSON の列挙順）
+		Array<std::pair<Atom, NodePtr>> members;
+	};
+
+	// 木が使っているメモリの見積もり
+	struct Footprint
+	{
+		size_t nodeCount = 0;
+
+		size_t memberCount = 0;
+
+		// ノードと配列、文字列の値が使うバイト数（ほかの根と共有しているノードも数える。Atom の表は含まない）
+		size_t bytes = 0;
+
+		// メンバーのキーと候補から選ぶ値を String で持った場合に増えるバイト数の見積もり
+		size_t stringKeyBytes = 0;
+	};
+
+	[[nodiscard]]
+	NodePtr FromJSON(const JSON& json);
+
+	// json と同じ内容のノードを作る。base と内容が同じ部分木は base のノードをそのまま使う
+	[[nodiscard]]
+	NodePtr Update(const NodePtr& base, const JSON& json);
+
+	[[nodiscard]]
+	JSON ToJSON(const NodePtr& node);
+
+	// path にあるノード（なければ nullptr）
+	[[nodiscard]]
+	NodePtr Find(const NodePtr& root, const Path& path);
+
+	// オブジェクトのメンバー key の値（node がオブジェクトでないか、メンバーがなければ nullptr）。Path を作らないので確保しない
+	[[nodiscard]]
+	NodePtr GetMember(const NodePtr& node, Atom key);
+
+	// 数値の値（数値でなければ none）
+	[[nodiscard]]
+	Optional<double> GetNumber(const Node& node);
+
+	// 文字列の値（文字列でなければ空）
+	[[nodiscard]]
+	StringView GetString(const Node& node);
+
+	// path にあるノードを node に置き換えた新しい根を返す（node が nullptr なら取り除く）
+	[[nodiscard]]
+	NodePtr Assign(const NodePtr& root, const Path& path, const NodePtr& node);
+
+	// 可変の JSON の path にある値で、root の path を更新した新しい根を返す（json の path に値がなければ取り除く）
+	// 内容が変わっていなければ root をそのまま返す
+	[[nodiscard]]
+	NodePtr UpdateAt(const NodePtr& root, JSON& json, const Path& path);
+
+	// 可変の JSON の path にある値を value に置き換える（value が none なら取り除く）
+	void AssignJSON(JSON& root, const Path& path, const Optional<JSON>& value);
+
+	[[nodiscard]]
+	Footprint MeasureFootprint(const NodePtr& root);
+}
@@ -0,0 +1,155 @@
+﻿#include "RoomEditSession.hpp"
+#include "EditorDocument.hpp"
+
+RoomEditSession::RoomEditSession(std::shared_ptr<EditorDocument> document, const String& roomName)
+	: m_document{ std::move(document) }
+	, m_roomName{ roomName }
+{
+}
+
+bool RoomEditSession::isModified() const
+{
+	return ((m_overlay.isObject() && (0 < m_overlay.size())) || (not m_erased.empty()));
+}
+
+bool RoomEditSession::hasElement(const String& field) const
+{
+	if (m_erased.contains(field))
+	{
+		return false;
+	}
+
+	if (m_overlay.hasElement(field))
+	{
+		return true;
+	}
+
+	if (const auto room = getBaseRoom())
+	{
+		return room->hasElement(field);
+	}
+
+	return false;
+}
+
+JSON RoomEditSession::get(const String& field) const
+{
+	if (m_erased.contains(field))
+	{
+		return JSON{};
+	}
+
+	if (m_overlay.hasElement(field))
+	{
+		return m_overlay[field];
+	}
+
+	if (auto room = getBaseRoom(); room && room->hasElement(field))
+	{
+		return (*room)[field];
+	}
+
+	return JSON{};
+}
+
+JSON RoomEditSession::edit(const String& field, const JSON& defaultValue)
+{
+	if (not m_overlay.hasElement(field))
+	{
+		auto room = getBaseRoom();
+
+		// 文書の値を複製するのは、このフィールドを初めて書き換えるときだけ
+		if ((not m_erased.contains(field)) && room && room->hasElement(field))
+		{
+			m_overlay[field] = (*room)[field];
+		}
+		else
+		{
+			m_overlay[field] = defaultValue;
+		}
+
+		m_erased.erase(field);
+	}
+
+	return m_overlay[field];
+}
+
+void RoomEditSession::erase(const String& field)
+{
+	if (m_overlay.hasElement(field))
+	{
+		m_overlay.erase(field);
+	}
+
+	m_erased.insert(field);
+}
+
+bool RoomEditSession::commit()
+{
+	if (not m_document)
+	{
+		return false;
+	}
+
+	if (not isModified())
+	{
+		discard();
+		return true;
+	}
+
+	auto room = getBaseRoom();
+
+	if (not room)
+	{
+		discard();
+		return false;
+	}
+
+	for (const auto& field : m_erased)
+	{
+		if (room->hasElement(field))
+		{
+			room->erase(field);
+		}
+	}
+
+	if (m_overlay.isObject())
+	{
+		for (const auto& item : m_overlay)
+		{
+			(*room)[item.key] = item.value;
+		}
+	}
+
+	// 変更したフィールドがいくつあっても、部屋1つ分の変更として履歴に残す（確定した編集ごとに別の変更とする）
+	m_document->markModified({ U"rooms", m_roomName }, false);
+
+	discard();
+	return true;
+}
+
+void RoomEditSession::discard()
+{
+	m_document.reset();
+	m_roomName.clear();
+	m_overlay = JSON{};
+	m_erased.clear();
+}
+
+Optional<JSON> RoomEditSession::getBaseRoom() const
+{
+	if (not m_document)
+	{
+		return none;
+	}
+
+	// const でない operator[] は無いキーを作ってしまうので、先に存在を確認する
+	JSON& json = m_document->getJson();
+
+	if ((not json.hasElement(U"rooms")) || (not json[U"rooms"].hasElement(m_roomName)))
+	{
+		return none;
+	}
+
+	return json[U"rooms"][m_roomName];
+}
@@ -0,0 +1,65 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+
+class EditorDocument;
+
+// room_connections.json の1つの部屋を編集するセッション
+// ・部屋の内容は複製せず、文書の値をそのまま参照する
+// ・書き換えたフィールドだけを、初めて書き換えたときに複製して上書き分として持つ
+// ・commit() で上書き分をまとめて文書へ反映する（取り消す場合は discard() で上書き分を捨てるだけ）
+class RoomEditSession
+{
+public:
+	RoomEditSession() = default;
+
+	RoomEditSession(std::shared_ptr<EditorDocument> document, const String& roomName);
+
+	[[nodiscard]]
+	bool isOpen() const { return static_cast<bool>(m_document); }
+
+	[[nodiscard]]
+	const String& getRoomName() const { return m_roomName; }
+
+	[[nodiscard]]
+	const std::shared_ptr<EditorDocument>& getDocument() const { return m_document; }
+
+	// 反映していない変更があれば true
+	[[nodiscard]]
+	bool isModified() const;
+
+	[[nodiscard]]
+	bool hasElement(const String& field) const;
+
+	// 読み取り用。書き換えていないフィールドは文書の値を参照する。無い場合は空の JSON
+	[[nodiscard]]
+	JSON get(const String& field) const;
+
+	// 書き込み用。初めて書き換えるときにそのフィールドだけを複製する（無い場合は defaultValue で作る）
+	// 返り値は上書き分の値を参照しているので、そのまま書き換えてよい
+	[[nodiscard]]
+	JSON edit(const String& field, const JSON& defaultValue = JSON{});
+
+	void erase(const String& field);
+
+	// 上書き分を文書へ反映して、セッションを閉じる
+	// 部屋が文書から消えていた場合は何もせず false を返す
+	bool commit();
+
+	// 上書き分を捨てて、セッションを閉じる
+	void discard();
+
+private:
+	// 文書の中の部屋（無ければ none）。返り値は文書の値を参照する
+	[[nodiscard]]
+	Optional<JSON> getBaseRoom() const;
+
+	std::shared_ptr<EditorDocument> m_document;
+
+	String m_roomName;
+
+	// 書き換えたフィールド（キーはフィールド名）
+	JSON m_overlay;
+
+	// 削除したフィールド
+	HashSet<String> m_erased;
+};
@@ -0,0 +1,165 @@
+﻿#include "SaveQueue.hpp"
+#include "JsonStreamWriter.hpp"
+#include "FileSync.hpp"
+#include <filesystem>
+
+SaveQueue::SaveQueue(WrittenCallback onWritten)
+	: m_onWritten{ std::move(onWritten) }
+	, m_thread{ [this]() { run(); } }
+{
+}
+
+SaveQueue::~SaveQueue()
+{
+	{
+		std::lock_guard lock{ m_mutex };
+		m_stopping = true;
+	}
+
+	m_condition.notify_all();
+	m_thread.join();
+}
+
+void SaveQueue::enqueue(const FilePath& path, const JSON& json)
+{
+	if (path.isEmpty())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard lock{ m_mutex };
+
+		if (auto it = m_pending.find(path); it != m_pending.end())
+		{
+			// まだ書き込んでいないので、内容だけ最新のものに差し替える
+			it->second.json = json;
+			++it->second.requestCount;
+			return;
+		}
+
+		m_pending.emplace(path, Job{ .json = json, .requestCount = 1 });
+		m_order.push_back(path);
+	}
+
+	m_condition.notify_one();
+}
+
+Array<SaveQueue::Result> SaveQueue::takeResults()
+{
+	std::lock_guard lock{ m_mutex };
+
+	return std::exchange(m_results, Array<Result>{});
+}
+
+bool SaveQueue::isPending(const FilePath& path) const
+{
+	std::lock_guard lock{ m_mutex };
+
+	return (m_pending.contains(path) || (m_writingPath == path));
+}
+
+void SaveQueue::flush()
+{
+	std::unique_lock lock{ m_mutex };
+
+	m_idle.wait(lock, [this]() { return (m_order.empty() && m_writingPath.isEmpty()); });
+}
+
+void SaveQueue::run()
+{
+	for (;;)
+	{
+		FilePath path;
+		Job job;
+		{
+			std::unique_lock lock{ m_mutex };
+
+			m_condition.wait(lock, [this]() { return (m_stopping || (not m_order.empty())); });
+
+			// 終了要求が来ても、待機中の保存はすべて書き込んでから抜ける
+			if (m_order.empty())
+			{
+				return;
+			}
+
+			path = std::move(m_order.front());
+			m_order.pop_front();
+
+			auto it = m_pending.find(path);
+			job = std::move(it->second);
+			m_pending.erase(it);
+
+			m_writingPath = path;
+		}
+
+		Result result = Write(path, job);
+
+		if (result.succeeded && m_onWritten)
+		{
+			m_onWritten(path, job.json);
+		}
+
+		{
+			std::lock_guard lock{ m_mutex };
+			m_results.push_back(std::move(result));
+			m_writingPath.clear();
+		}
+
+		m_idle.notify_all();
+	}
+}
+
+SaveQueue::Result SaveQueue::Write(const FilePath& path, const Job& job)
+{
+	Result result{ .path = path, .requestCount = job.requestCount };
+
+	const FilePath tempPath = path + U".saving";
+	{
+		BinaryWriter writer{ tempPath };
+
+		if (not writer)
+		{
+			result.error = U"Failed to open " + tempPath;
+			return result;
+		}
+
+		// 整形済みの文字列全体を作らず、UTF-8 で少しずつ書き込む
+		JsonStreamWriter jsonWriter{ [&writer](std::string_view chunk)
+			{
+				return (writer.write(chunk.data(), static_cast<int64>(chunk.size())) == static_cast<int64>(chunk.size()));
+			} };
+
+		if (not jsonWriter.write(job.json))
+		{
+			writer.close();
+			FileSystem::Remove(tempPath);
+			result.error = U"Failed to write " + tempPath;
+			return result;
+		}
+
+		writer.close();
+	}
+
+	// リネームする前に内容をディスクへ書き出す（置き換えた後に中身のないファイルが残らないようにする）
+	if (not SyncFile(tempPath))
+	{
+		FileSystem::Remove(tempPath);
+		result.error = U"Failed to flush " + tempPath;
+		return result;
+	}
+
+	// 既存のファイルを一時ファイルで置き換える（同じボリューム上なのでアトミック）
+	std::error_code ec;
+	std::filesystem::rename(std::filesystem::path{ tempPath.str() }, std::filesystem::path{ path.str() }, ec);
+
+	if (ec)
+	{
+		FileSystem::Remove(tempPath);
+		result.error = Unicode::FromUTF8(ec.message());
+		return result;
+	}
+
+	result.succeeded = true;
+	return result;
+}
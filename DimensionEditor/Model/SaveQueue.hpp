@@ -0,0 +1,84 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+// JSONの保存をバックグラウンドで行うキュー（write-behind）
+// ・同じパスへの保存が書き込み前に何度も要求された場合は、最新の内容で1回だけ書き込む
+// ・一時ファイルに書き込み、FlushFileBuffers（POSIX では fsync）でディスクまで書き出した後、リネームで置き換える（書き込み途中のファイルが残らない）
+class SaveQueue
+{
+public:
+	struct Result
+	{
+		FilePath path;
+
+		bool succeeded = false;
+
+		// 失敗時の理由
+		String error;
+
+		// この書き込みにまとめられた保存要求の数
+		size_t requestCount = 0;
+	};
+
+	// 書き込みに成功するたびにワーカースレッドから呼ばれる
+	using WrittenCallback = std::function<void(const FilePath& path, const JSON& json)>;
+
+	explicit SaveQueue(WrittenCallback onWritten = nullptr);
+
+	// 待機中の保存をすべて書き込んでから終了する
+	~SaveQueue();
+
+	SaveQueue(const SaveQueue&) = delete;
+
+	SaveQueue& operator =(const SaveQueue&) = delete;
+
+	void enqueue(const FilePath& path, const JSON& json);
+
+	// 完了した保存の結果を取り出す
+	[[nodiscard]]
+	Array<Result> takeResults();
+
+	// 指定したパスの保存が待機中または書き込み中なら true
+	[[nodiscard]]
+	bool isPending(const FilePath& path) const;
+
+	// 待機中の保存がすべて終わるまで待つ
+	void flush();
+
+private:
+	struct Job
+	{
+		JSON json;
+		size_t requestCount = 0;
+	};
+
+	void run();
+
+	[[nodiscard]]
+	static Result Write(const FilePath& path, const Job& job);
+
+	WrittenCallback m_onWritten;
+
+	mutable std::mutex m_mutex;
+
+	std::condition_variable m_condition;
+
+	std::condition_variable m_idle;
+
+	// 書き込み待ちの内容（パスごとに最新の1つだけ）と、その順番
+	HashTable<FilePath, Job> m_pending;
+
+	std::deque<FilePath> m_order;
+
+	FilePath m_writingPath;
+
+	Array<Result> m_results;
+
+	bool m_stopping = false;
+
+	std::thread m_thread;
+};
@@ -0,0 +1,44 @@
+﻿#include "SchemaRegistry.hpp"
+#include "../SchemaManager.hpp"
+
+namespace SchemaRegistry
+{
+	const CompiledSchema* Find(const StringView schemaName)
+	{
+		// 文書のスキーマは十数個なので、線形に探す
+		for (const auto& schema : DocumentSchemas())
+		{
+			if (schema.name.view() == schemaName.view())
+			{
+				return &schema;
+			}
+		}
+
+		return nullptr;
+	}
+
+	const CompiledSchema& Get(const SchemaHandle handle)
+	{
+		return g_SchemaTable[handle];
+	}
+
+	const CompiledSchema* Child(const SchemaField& field)
+	{
+		if (field.child == InvalidSchemaHandle)
+		{
+			return nullptr;
+		}
+
+		return &g_SchemaTable[field.child];
+	}
+
+	std::span<const CompiledSchema> DocumentSchemas()
+	{
+		return std::span<const CompiledSchema>{ g_SchemaTable }.first(g_DocumentSchemaCount);
+	}
+
+	std::span<const CompiledSchema> AllSchemas()
+	{
+		return g_SchemaTable;
+	}
+}
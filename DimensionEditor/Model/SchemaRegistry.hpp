@@ -0,0 +1,158 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include <array>
+#include <span>
+#include "Atom.hpp"
+
+// スキーマの番号（SchemaManager.hpp の SchemaId と同じ値）
+using SchemaHandle = uint16;
+
+inline constexpr SchemaHandle InvalidSchemaHandle = 0xFFFF;
+
+// ImGui に渡す UTF-8 の説明。コンパイル時に説明文から作り、プロパティの中に持つ
+struct SchemaLabel
+{
+	static constexpr size_t Capacity = 64;
+
+	std::array<char, Capacity> text{};
+
+	// UTF-32 の説明を UTF-8 に変換する。入りきらなければコンパイルエラーにする
+	static consteval SchemaLabel FromDescription(const std::u32string_view description)
+	{
+		SchemaLabel label;
+		size_t length = 0;
+
+		const auto put = [&](const char32_t byte)
+			{
+				if ((Capacity - 1) <= length)
+				{
+					throw "schema label is too long";
+				}
+
+				label.text[length++] = static_cast<char>(byte);
+			};
+
+		for (const char32_t ch : description)
+		{
+			if (ch < 0x80)
+			{
+				put(ch);
+			}
+			else if (ch < 0x800)
+			{
+				put(0xC0 | (ch >> 6));
+				put(0x80 | (ch & 0x3F));
+			}
+			else if (ch < 0x10000)
+			{
+				put(0xE0 | (ch >> 12));
+				put(0x80 | ((ch >> 6) & 0x3F));
+				put(0x80 | (ch & 0x3F));
+			}
+			else
+			{
+				put(0xF0 | (ch >> 18));
+				put(0x80 | ((ch >> 12) & 0x3F));
+				put(0x80 | ((ch >> 6) & 0x3F));
+				put(0x80 | (ch & 0x3F));
+			}
+		}
+
+		return label;
+	}
+
+	[[nodiscard]]
+	constexpr const char* c_str() const noexcept
+	{
+		return text.data();
+	}
+};
+
+// プロパティの定義（不変。SchemaManager.hpp でコンパイル時に作る）
+struct SchemaField
+{
+	StringView key;
+
+	// key の Atom（定義済みの Atom なので、コンパイル時に決まる）
+	Atom atom;
+
+	StringView description;
+
+	SchemaLabel label;
+
+	JSONValueType type = JSONValueType::Null;
+
+	bool isRequired = false;
+
+	// 子スキーマ。なければ InvalidSchemaHandle
+	SchemaHandle child = InvalidSchemaHandle;
+};
+
+// スキーマの定義（不変）。プロパティは SchemaManager.hpp の定数の配列を参照する
+struct CompiledSchema
+{
+	StringView name;
+
+	SchemaHandle handle = InvalidSchemaHandle;
+
+	std::span<const SchemaField> fields;
+
+	// ファイル名で引けるスキーマか（false なら、ほかのスキーマの子としてだけ使う）
+	bool isDocument = false;
+
+	// key のプロパティ。なければ nullptr
+	[[nodiscard]]
+	constexpr const SchemaField* findField(const StringView key) const noexcept
+	{
+		for (const auto& field : fields)
+		{
+			if (field.key.view() == key.view())
+			{
+				return &field;
+			}
+		}
+
+		return nullptr;
+	}
+
+	// key のプロパティ（整数の比較だけで探す）。なければ nullptr
+	[[nodiscard]]
+	constexpr const SchemaField* findField(const Atom key) const noexcept
+	{
+		for (const auto& field : fields)
+		{
+			if (field.atom == key)
+			{
+				return &field;
+			}
+		}
+
+		return nullptr;
+	}
+};
+
+// SchemaManager.hpp でコンパイル時に作ったスキーマの表を引く
+// 表は定数なので、初期化の順序や起動時の処理はなく、どのスレッドからでも引ける
+// 引き当てはポインタか番号を返すだけで、スキーマのコピーもログの出力もしない
+namespace SchemaRegistry
+{
+	// ファイル名（拡張子なし）に対応するスキーマ。なければ nullptr
+	// room_connections は文書全体ではなく、"rooms" の各部屋のスキーマを返す
+	[[nodiscard]]
+	const CompiledSchema* Find(StringView schemaName);
+
+	[[nodiscard]]
+	const CompiledSchema& Get(SchemaHandle handle);
+
+	// field の子スキーマ。なければ nullptr
+	[[nodiscard]]
+	const CompiledSchema* Child(const SchemaField& field);
+
+	// ファイル名で引けるスキーマ
+	[[nodiscard]]
+	std::span<const CompiledSchema> DocumentSchemas();
+
+	// 子スキーマを含む、すべてのスキーマ
+	[[nodiscard]]
+	std::span<const CompiledSchema> AllSchemas();
+}
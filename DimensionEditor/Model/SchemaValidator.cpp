@@ -0,0 +1,237 @@
+﻿#include "SchemaValidator.hpp"
+#include "TemplateService.hpp"
+
+namespace
+{
+	StringView TypeName(const JSONValueType type)
+	{
+		switch (type)
+		{
+		case JSONValueType::Null:
+			return U"null";
+		case JSONValueType::Object:
+			return U"object";
+		case JSONValueType::Array:
+			return U"array";
+		case JSONValueType::String:
+			return U"string";
+		case JSONValueType::Number:
+			return U"number";
+		case JSONValueType::Bool:
+			return U"bool";
+		default:
+			return U"empty";
+		}
+	}
+
+	String JoinPath(const String& path, const StringView key)
+	{
+		if (path.isEmpty())
+		{
+			return String{ key };
+		}
+
+		String joined;
+		joined.reserve(path.size() + 1 + key.size());
+		joined.append(path).push_back(U'/');
+		joined.append(key);
+		return joined;
+	}
+
+	void ValidateValue(const JSON& value, const SchemaField& prop, const String& path, Array<SchemaProblem>& problems)
+	{
+		if (value.getType() != prop.type)
+		{
+			problems.push_back({ .severity = SchemaProblem::Severity::Error, .path = path,
+				.message = U"expected {} but found {}"_fmt(TypeName(prop.type), TypeName(value.getType())) });
+			return;
+		}
+
+		const CompiledSchema* childSchema = SchemaRegistry::Child(prop);
+
+		if (not childSchema)
+		{
+			return;
+		}
+
+		if (prop.type == JSONValueType::Object)
+		{
+			problems.append(SchemaValidator::Validate(value, *childSchema, path));
+		}
+		else if (prop.type == JSONValueType::Array)
+		{
+			size_t index = 0;
+
+			for (const auto& element : value.arrayView())
+			{
+				problems.append(SchemaValidator::Validate(element, *childSchema, JoinPath(path, Format(index++))));
+			}
+		}
+	}
+}
+
+namespace SchemaValidator
+{
+	const CompiledSchema* FindSchema(const StringView schemaName)
+	{
+		return SchemaRegistry::Find(schemaName);
+	}
+
+	Array<SchemaProblem> Validate(const JSON& json, const CompiledSchema& schema, const String& path)
+	{
+		Array<SchemaProblem> problems;
+
+		if (not json.isObject())
+		{
+			problems.push_back({ .severity = SchemaProblem::Severity::Error, .path = path,
+				.message = U"expected object but found {}"_fmt(TypeName(json.getType())) });
+			return problems;
+		}
+
+		for (const auto& prop : schema.fields)
+		{
+			const StringView key = prop.key;
+			const String propertyPath = JoinPath(path, key);
+
+			if (not json.hasElement(key))
+			{
+				if (prop.isRequired)
+				{
+					problems.push_back({ .severity = SchemaProblem::Severity::Error, .path = propertyPath,
+						.message = U"missing required property ({})"_fmt(prop.description) });
+				}
+
+				continue;
+			}
+
+			ValidateValue(json[key], prop, propertyPath, problems);
+		}
+
+		return problems;
+	}
+
+	Array<SchemaProblem> ValidateDocument(const String& schemaName, const JSON& json)
+	{
+		const CompiledSchema* schema = FindSchema(schemaName);
+
+		if (not schema)
+		{
+			return{ { .severity = SchemaProblem::Severity::Warning, .path = U"", .message = U"no schema for '{}'"_fmt(schemaName) } };
+		}
+
+		Array<SchemaProblem> problems;
+
+		if (schemaName == U"room_connections")
+		{
+			if ((not json.hasElement(U"rooms")) || (not json[U"rooms"].isObject()))
+			{
+				problems.push_back({ .severity = SchemaProblem::Severity::Error, .path = U"rooms", .message = U"'rooms' object not found" });
+				return problems;
+			}
+
+			for (const auto& room : json[U"rooms"])
+			{
+				problems.append(Validate(room.value, *schema, JoinPath(U"rooms", room.key)));
+			}
+		}
+		else
+		{
+			problems = Validate(json, *schema);
+		}
+
+		// スキーマのプロパティの並びに依存しないよう、位置の順に並べる
+		problems.stable_sort_by([](const SchemaProblem& a, const SchemaProblem& b) { return (a.path < b.path); });
+
+		return problems;
+	}
+
+	size_t FillMissingRequired(JSON& json, const CompiledSchema& schema)
+	{
+		if (not json.isObject())
+		{
+			return 0;
+		}
+
+		size_t filledCount = 0;
+
+		for (const auto& prop : schema.fields)
+		{
+			const StringView key = prop.key;
+
+			if (not json.hasElement(key))
+			{
+				if (prop.isRequired)
+				{
+					json[key] = TemplateService::CreateRequired(prop);
+					++filledCount;
+				}
+
+				continue;
+			}
+
+			const CompiledSchema* childSchema = SchemaRegistry::Child(prop);
+
+			if (not childSchema)
+			{
+				continue;
+			}
+
+			// json[key] は文書の値を参照するので、子の書き換えはそのまま文書に反映される
+			JSON child = json[key];
+
+			if (child.isObject())
+			{
+				filledCount += FillMissingRequired(child, *childSchema);
+			}
+			else if (child.isArray())
+			{
+				for (size_t i = 0; i < child.size(); ++i)
+				{
+					JSON element = child[i];
+					filledCount += FillMissingRequired(element, *childSchema);
+				}
+			}
+		}
+
+		return filledCount;
+	}
+
+	size_t NormalizeDocument(const String& schemaName, JSON& json)
+	{
+		const CompiledSchema* schema = FindSchema(schemaName);
+
+		if (not schema)
+		{
+			return 0;
+		}
+
+		if (schemaName != U"room_connections")
+		{
+			return FillMissingRequired(json, *schema);
+		}
+
+		if ((not json.hasElement(U"rooms")) || (not json[U"rooms"].isObject()))
+		{
+			return 0;
+		}
+
+		JSON rooms = json[U"rooms"];
+
+		Array<String> roomNames;
+
+		for (const auto& room : rooms)
+		{
+			roomNames.push_back(room.key);
+		}
+
+		size_t filledCount = 0;
+
+		for (const auto& roomName : roomNames)
+		{
+			JSON room = rooms[roomName];
+			filledCount += FillMissingRequired(room, *schema);
+		}
+
+		return filledCount;
+	}
+}
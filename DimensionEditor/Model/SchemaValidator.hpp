@@ -0,0 +1,46 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include "SchemaRegistry.hpp"
+
+// スキーマと一致しない箇所
+struct SchemaProblem
+{
+	enum class Severity
+	{
+		Warning,
+
+		Error,
+	};
+
+	Severity severity = Severity::Error;
+
+	// 問題のある値の位置（例: "rooms/Hall/background"）
+	String path;
+
+	String message;
+};
+
+// SchemaRegistry のスキーマで JSON 文書を検証・正規化する（ImGui に依存しない）
+// スキーマは定数の表なので、検証はスレッドセーフ
+namespace SchemaValidator
+{
+	// ファイル名（拡張子なし）に対応するスキーマ。なければ nullptr
+	// room_connections は文書全体ではなく、"rooms" の各部屋のスキーマを返す
+	[[nodiscard]]
+	const CompiledSchema* FindSchema(StringView schemaName);
+
+	// json を schema で検証する（必須プロパティの欠落、型の不一致を報告する）
+	[[nodiscard]]
+	Array<SchemaProblem> Validate(const JSON& json, const CompiledSchema& schema, const String& path = U"");
+
+	// ファイル名（拡張子なし）に対応するスキーマで文書を検証する。問題は位置の順に並べて返す
+	[[nodiscard]]
+	Array<SchemaProblem> ValidateDocument(const String& schemaName, const JSON& json);
+
+	// 欠けている必須プロパティを、スキーマの型の既定値で補う（子スキーマも再帰的に補う）
+	// 補ったプロパティの数を返す
+	size_t FillMissingRequired(JSON& json, const CompiledSchema& schema);
+
+	// ファイル名（拡張子なし）に対応するスキーマで文書を正規化する。補ったプロパティの数を返す
+	size_t NormalizeDocument(const String& schemaName, JSON& json);
+}
@@ -0,0 +1,26 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+
+// 文字列が使うメモリの見積もり（メモリ使用量の計測で、データ構造の間で同じ数え方をする）
+namespace StringFootprint
+{
+	// String が文字列の本体を内部に持てる長さ（MSVC と libstdc++ の std::u32string は 16 バイトの内部バッファを持つ）
+	inline constexpr size_t InlineLength = ((16 / sizeof(char32)) - 1);
+
+	// 長さ length の String が、内部バッファとは別に確保するバイト数
+	[[nodiscard]]
+	constexpr size_t HeapBytes(const size_t length) noexcept
+	{
+		return ((length <= InlineLength) ? 0 : ((length + 1) * sizeof(char32)));
+	}
+
+	// std::string が文字列の本体を内部に持てる長さ（MSVC と libstdc++ は 15 バイト）
+	inline constexpr size_t StdInlineLength = 15;
+
+	// 長さ length の std::string が、内部バッファとは別に確保するバイト数
+	[[nodiscard]]
+	constexpr size_t StdHeapBytes(const size_t length) noexcept
+	{
+		return ((length <= StdInlineLength) ? 0 : (length + 1));
+	}
+}
@@ -0,0 +1,165 @@
+﻿#include "TemplateService.hpp"
+
+namespace
+{
+	// 生成中の親スキーマの連なり（呼び出し側のスタックに置くので、たどるのに確保は要らない）
+	struct TemplateFrame
+	{
+		SchemaHandle handle;
+
+		const TemplateFrame* parent;
+
+		[[nodiscard]]
+		bool contains(const SchemaHandle target) const noexcept
+		{
+			for (const TemplateFrame* frame = this; frame; frame = frame->parent)
+			{
+				if (frame->handle == target)
+				{
+					return true;
+				}
+			}
+
+			return false;
+		}
+	};
+
+	// 自身を子に持つスキーマで無限に再帰しないよう、生成中の親と同じスキーマには入らない
+	JSON BuildTemplate(const CompiledSchema& schema, const TemplateFrame* parent)
+	{
+		const TemplateFrame frame{ schema.handle, parent };
+
+		JSON newJson;
+		for (const auto& prop : schema.fields)
+		{
+			// 子スキーマが定義されていれば、再帰的にテンプレートを生成
+			if ((prop.type == JSONValueType::Object) && (prop.child != InvalidSchemaHandle) && (not frame.contains(prop.child)))
+			{
+				newJson[prop.key] = BuildTemplate(SchemaRegistry::Get(prop.child), &frame);
+			}
+			else
+			{
+				newJson[prop.key] = TemplateService::DefaultValue(prop.type);
+			}
+		}
+
+		return newJson;
+	}
+
+	JSON BuildRequiredTemplate(const CompiledSchema& schema)
+	{
+		JSON object;
+
+		for (const auto& prop : schema.fields)
+		{
+			if (not prop.isRequired)
+			{
+				continue;
+			}
+
+			if (const CompiledSchema* childSchema = SchemaRegistry::Child(prop);
+				childSchema && (prop.type == JSONValueType::Object))
+			{
+				object[prop.key] = BuildRequiredTemplate(*childSchema);
+			}
+			else
+			{
+				object[prop.key] = TemplateService::DefaultValue(prop.type);
+			}
+		}
+
+		return object;
+	}
+
+	// すべてのスキーマの雛形（SchemaHandle の順）
+	struct Prototypes
+	{
+		Array<JSON> full;
+
+		Array<JSON> required;
+
+		Array<PersistentJson::NodePtr> nodes;
+	};
+
+	const Prototypes& GetPrototypes()
+	{
+		// スキーマは数十個で、どれも小さいので、初めて引かれたときにまとめて作る（関数内の static の初期化はスレッドセーフ）
+		static const Prototypes prototypes = []()
+			{
+				Prototypes result;
+
+				for (const auto& schema : SchemaRegistry::AllSchemas())
+				{
+					result.full.push_back(BuildTemplate(schema, nullptr));
+					result.required.push_back(BuildRequiredTemplate(schema));
+					result.nodes.push_back(PersistentJson::FromJSON(result.full.back()));
+				}
+
+				return result;
+			}();
+
+		return prototypes;
+	}
+}
+
+namespace TemplateService
+{
+	JSON DefaultValue(const JSONValueType type)
+	{
+		switch (type)
+		{
+		case JSONValueType::String:
+			return JSON(U"");
+		case JSONValueType::Number:
+			return JSON(0);
+		case JSONValueType::Bool:
+			return JSON(false);
+		case JSONValueType::Array:
+			return JSON(Array<JSON>{});
+		case JSONValueType::Object:
+			return JSON();
+		default:
+			return JSON(nullptr);
+		}
+	}
+
+	JSON BuildPrototype(const CompiledSchema& schema)
+	{
+		return BuildTemplate(schema, nullptr);
+	}
+
+	const JSON& Prototype(const SchemaHandle handle)
+	{
+		return GetPrototypes().full[handle];
+	}
+
+	const JSON& RequiredPrototype(const SchemaHandle handle)
+	{
+		return GetPrototypes().required[handle];
+	}
+
+	const PersistentJson::NodePtr& PrototypeNode(const SchemaHandle handle)
+	{
+		return GetPrototypes().nodes[handle];
+	}
+
+	JSON Create(const SchemaHandle handle)
+	{
+		return Prototype(handle);
+	}
+
+	JSON CreateRequired(const SchemaHandle handle)
+	{
+		return RequiredPrototype(handle);
+	}
+
+	JSON CreateRequired(const SchemaField& field)
+	{
+		if ((field.type == JSONValueType::Object) && (field.child != InvalidSchemaHandle))
+		{
+			return CreateRequired(field.child);
+		}
+
+		return DefaultValue(field.type);
+	}
+}
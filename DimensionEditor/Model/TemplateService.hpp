@@ -0,0 +1,44 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include "SchemaRegistry.hpp"
+#include "PersistentJson.hpp"
+
+// スキーマから作る新しいオブジェクトの雛形
+// ・スキーマは定数なので、雛形はスキーマごとに初めて必要になったときに1回だけ作り、以後は同じものを返す
+// ・作った雛形は変更しないので、どのスレッドからでも引ける（大量に作るときも、スキーマを走査し直さない）
+// ・書き換える場合は Create のコピーを使う。コピーせずに共有したい場合は PrototypeNode（変更した経路だけが作り直される）
+namespace TemplateService
+{
+	// 型の既定値（"" / 0 / false / [] / 空のオブジェクト / null）
+	[[nodiscard]]
+	JSON DefaultValue(JSONValueType type);
+
+	// スキーマを走査して、すべてのプロパティを既定値で持つ JSON を作る（キャッシュしない。Prototype が使う）
+	// 自身を子に持つスキーマは、再び現れる位置を空の値にする
+	[[nodiscard]]
+	JSON BuildPrototype(const CompiledSchema& schema);
+
+	// すべてのプロパティを既定値で持つ雛形
+	[[nodiscard]]
+	const JSON& Prototype(SchemaHandle handle);
+
+	// 必須のプロパティだけを既定値で持つ雛形（必須のプロパティの経路は有限なので、自身を子に持つスキーマでも止まる）
+	[[nodiscard]]
+	const JSON& RequiredPrototype(SchemaHandle handle);
+
+	// Prototype と同じ内容の変更できない木。コピーはポインタのコピーだけで済む
+	[[nodiscard]]
+	const PersistentJson::NodePtr& PrototypeNode(SchemaHandle handle);
+
+	// Prototype のコピー
+	[[nodiscard]]
+	JSON Create(SchemaHandle handle);
+
+	// RequiredPrototype のコピー
+	[[nodiscard]]
+	JSON CreateRequired(SchemaHandle handle);
+
+	// field の必須の既定値（子スキーマがあれば、その RequiredPrototype のコピー）
+	[[nodiscard]]
+	JSON CreateRequired(const SchemaField& field);
+}
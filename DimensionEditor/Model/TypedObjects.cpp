@@ -0,0 +1,376 @@
+﻿#include "TypedObjects.hpp"
+
+using JsonBinding::Bind;
+
+template <>
+struct Binding<ConditionData>
+{
+	static constexpr SchemaId Schema = SchemaId::Condition;
+
+	static constexpr auto Fields = std::tuple{
+		Bind(U"type", &ConditionData::type),
+		Bind(U"item", &ConditionData::item),
+		Bind(U"flag", &ConditionData::flag),
+		Bind(U"scope", &ConditionData::scope),
+	};
+
+	static constexpr UnknownMembers ConditionData::* Unknown = &ConditionData::unknown;
+};
+
+template <>
+struct Binding<ActionData>
+{
+	static constexpr SchemaId Schema = SchemaId::Action;
+
+	static constexpr auto Fields = std::tuple{
+		Bind(U"type", &ActionData::type),
+		Bind(U"file", &ActionData::file),
+		Bind(U"item", &ActionData::item),
+		Bind(U"flag", &ActionData::flag),
+		Bind(U"value", &ActionData::value),
+		Bind(U"scope", &ActionData::scope),
+		Bind(U"id", &ActionData::id),
+		Bind(U"target", &ActionData::target),
+		Bind(U"condition", &ActionData::condition),
+		Bind(U"success", &ActionData::success),
+		Bind(U"failure", &ActionData::failure),
+		Bind(U"final_action", &ActionData::finalAction),
+		Bind(U"actions", &ActionData::actions),
+		Bind(U"steps", &ActionData::steps),
+	};
+
+	static constexpr UnknownMembers ActionData::* Unknown = &ActionData::unknown;
+};
+
+template <>
+struct Binding<ObjectStateData>
+{
+	static constexpr SchemaId Schema = SchemaId::ObjectState;
+
+	static constexpr auto Fields = std::tuple{
+		Bind(U"asset", &ObjectStateData::asset),
+		Bind(U"grid_pos", &ObjectStateData::gridPos),
+	};
+
+	static constexpr UnknownMembers ObjectStateData::* Unknown = &ObjectStateData::unknown;
+};
+
+template <>
+struct Binding<ConditionalStateData>
+{
+	static constexpr SchemaId Schema = SchemaId::ConditionalState;
+
+	static constexpr auto Fields = std::tuple{
+		Bind(U"condition_flag", &ConditionalStateData::conditionFlag),
+		Bind(U"asset", &ConditionalStateData::asset),
+		Bind(U"grid_pos", &ConditionalStateData::gridPos),
+	};
+
+	static constexpr UnknownMembers ConditionalStateData::* Unknown = &ConditionalStateData::unknown;
+};
+
+template <>
+struct Binding<HotspotData>
+{
+	static constexpr SchemaId Schema = SchemaId::Hotspot;
+
+	static constexpr auto Fields = std::tuple{
+		Bind(U"grid_pos", &HotspotData::gridPos),
+		Bind(U"action", &HotspotData::action),
+	};
+
+	static constexpr UnknownMembers HotspotData::* Unknown = &HotspotData::unknown;
+};
+
+template <>
+struct Binding<FocusableData>
+{
+	// 共通のプロパティだけを持つ文書
+	static constexpr SchemaId Schema = SchemaId::Whiteboard;
+
+	static constexpr auto Fields = std::tuple{
+		Bind(U"name", &FocusableData::name),
+		Bind(U"hotspot", &FocusableData::hotspot),
+		Bind(U"default_state", &FocusableData::defaultState),
+		Bind(U"states", &FocusableData::states),
+	};
+
+	static constexpr UnknownMembers FocusableData::* Unknown = &FocusableData::unknown;
+};
+
+template <>
+struct Binding<LockboxAnswerData>
+{
+	static constexpr SchemaId Schema = SchemaId::LockboxAnswer;
+
+	static constexpr auto Fields = std::tuple{
+		Bind(U"code", &LockboxAnswerData::code),
+		Bind(U"item", &LockboxAnswerData::item),
+	};
+
+	static constexpr UnknownMembers LockboxAnswerData::* Unknown = &LockboxAnswerData::unknown;
+};
+
+template <>
+struct Binding<MissingPieceData>
+{
+	static constexpr SchemaId Schema = SchemaId::MissingPiece;
+
+	static constexpr auto Fields = std::tuple{
+		Bind(U"position", &MissingPieceData::position),
+		Bind(U"item", &MissingPieceData::item),
+	};
+
+	static constexpr UnknownMembers MissingPieceData::* Unknown = &MissingPieceData::unknown;
+};
+
+template <>
+struct Binding<CardCaseAnswerData>
+{
+	static constexpr SchemaId Schema = SchemaId::CardCaseAnswer;
+
+	static constexpr auto Fields = std::tuple{
+		Bind(U"code", &CardCaseAnswerData::code),
+		Bind(U"flag", &CardCaseAnswerData::flag),
+	};
+
+	static constexpr UnknownMembers CardCaseAnswerData::* Unknown = &CardCaseAnswerData::unknown;
+};
+
+// 種類ごとの文書は、共通のプロパティの後ろに種類ごとのプロパティをつなげる（SchemaFields と同じ構成）
+template <>
+struct Binding<LockboxData>
+{
+	static constexpr SchemaId Schema = SchemaId::Lockbox;
+
+	static constexpr auto Fields = std::tuple_cat(Binding<FocusableData>::Fields, std::tuple{
+		Bind(U"answers", &LockboxData::answers),
+	});
+
+	static constexpr UnknownMembers FocusableData::* Unknown = &FocusableData::unknown;
+};
+
+template <>
+struct Binding<DiaryData>
+{
+	static constexpr SchemaId Schema = SchemaId::Diary;
+
+	static constexpr auto Fields = std::tuple_cat(Binding<FocusableData>::Fields, std::tuple{
+		Bind(U"pages", &DiaryData::pages),
+	});
+
+	static constexpr UnknownMembers FocusableData::* Unknown = &FocusableData::unknown;
+};
+
+template <>
+struct Binding<FamicomData>
+{
+	static constexpr SchemaId Schema = SchemaId::Famicom;
+
+	static constexpr auto Fields = std::tuple_cat(Binding<FocusableData>::Fields, std::tuple{
+		Bind(U"secret_code", &FamicomData::secretCode),
+		Bind(U"success_image", &FamicomData::successImage),
+	});
+
+	static constexpr UnknownMembers FocusableData::* Unknown = &FocusableData::unknown;
+};
+
+template <>
+struct Binding<GridPuzzleData>
+{
+	static constexpr SchemaId Schema = SchemaId::LightsOutPuzzle;
+
+	static constexpr auto Fields = std::tuple_cat(Binding<FocusableData>::Fields, std::tuple{
+		Bind(U"initial_grid", &GridPuzzleData::initialGrid),
+	});
+
+	static constexpr UnknownMembers FocusableData::* Unknown = &FocusableData::unknown;
+};
+
+template <>
+struct Binding<RotatingPuzzleData>
+{
+	static constexpr SchemaId Schema = SchemaId::RotatingPuzzle;
+
+	static constexpr auto Fields = std::tuple_cat(Binding<FocusableData>::Fields, std::tuple{
+		Bind(U"background_texture", &RotatingPuzzleData::backgroundTexture),
+		Bind(U"puzzle_texture", &RotatingPuzzleData::puzzleTexture),
+		Bind(U"puzzle_width", &RotatingPuzzleData::puzzleWidth),
+		Bind(U"missing_pieces", &RotatingPuzzleData::missingPieces),
+	});
+
+	static constexpr UnknownMembers FocusableData::* Unknown = &FocusableData::unknown;
+};
+
+template <>
+struct Binding<CardCaseData>
+{
+	static constexpr SchemaId Schema = SchemaId::CardCase;
+
+	static constexpr auto Fields = std::tuple_cat(Binding<FocusableData>::Fields, std::tuple{
+		Bind(U"texture", &CardCaseData::texture),
+		Bind(U"answers", &CardCaseData::answers),
+	});
+
+	static constexpr UnknownMembers FocusableData::* Unknown = &FocusableData::unknown;
+};
+
+template <>
+struct Binding<DrawerData>
+{
+	static constexpr SchemaId Schema = SchemaId::Drawer;
+
+	static constexpr auto Fields = std::tuple_cat(Binding<FocusableData>::Fields, std::tuple{
+		Bind(U"bg_open", &DrawerData::bgOpen),
+		Bind(U"bg_close", &DrawerData::bgClose),
+		Bind(U"item_open", &DrawerData::itemOpen),
+		Bind(U"item_close", &DrawerData::itemClose),
+	});
+
+	static constexpr UnknownMembers FocusableData::* Unknown = &FocusableData::unknown;
+};
+
+namespace
+{
+	// スキーマのプロパティがすべて構造体のメンバーに対応しているか（構造体はスキーマにないキーを持ってもよい）
+	template <class Type>
+	consteval bool CoversSchema(const SchemaId id = Binding<Type>::Schema)
+	{
+		for (const auto& field : SchemaOf(id).fields)
+		{
+			const bool bound = std::apply([&](const auto&... fields) { return ((fields.key == field.atom) || ...); }, Binding<Type>::Fields);
+
+			if (not bound)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	static_assert(CoversSchema<ConditionData>());
+	static_assert(CoversSchema<ActionData>());
+	static_assert(CoversSchema<ObjectStateData>());
+	static_assert(CoversSchema<ConditionalStateData>());
+	static_assert(CoversSchema<HotspotData>());
+	static_assert(CoversSchema<FocusableData>());
+	static_assert(CoversSchema<FocusableData>(SchemaId::Corpse));
+	static_assert(CoversSchema<LockboxAnswerData>());
+	static_assert(CoversSchema<MissingPieceData>());
+	static_assert(CoversSchema<CardCaseAnswerData>());
+	static_assert(CoversSchema<LockboxData>());
+	static_assert(CoversSchema<DiaryData>());
+	static_assert(CoversSchema<FamicomData>());
+	static_assert(CoversSchema<GridPuzzleData>());
+	static_assert(CoversSchema<GridPuzzleData>(SchemaId::Kurotto));
+	static_assert(CoversSchema<RotatingPuzzleData>());
+	static_assert(CoversSchema<CardCaseData>());
+	static_assert(CoversSchema<DrawerData>());
+
+	template <class Type>
+	Optional<Type> BindAs(const JSON& json)
+	{
+		Type value{};
+
+		if (not JsonBinding::ReadObject(json, value))
+		{
+			return none;
+		}
+
+		return value;
+	}
+
+	template <class Type>
+	Optional<TypedDocument> BindDocumentAs(const SchemaId schema, const JSON& json)
+	{
+		Optional<Type> value = BindAs<Type>(json);
+
+		if (not value)
+		{
+			return none;
+		}
+
+		return TypedDocument{ .schema = schema, .data = std::move(*value) };
+	}
+}
+
+namespace TypedObjects
+{
+	Optional<ActionData> BindAction(const JSON& json)
+	{
+		return BindAs<ActionData>(json);
+	}
+
+	JSON ToJSON(const ActionData& action)
+	{
+		return JsonBinding::WriteObject(action);
+	}
+
+	Optional<HotspotData> BindHotspot(const JSON& json)
+	{
+		return BindAs<HotspotData>(json);
+	}
+
+	JSON ToJSON(const HotspotData& hotspot)
+	{
+		return JsonBinding::WriteObject(hotspot);
+	}
+
+	Optional<FocusableData> BindFocusable(const JSON& json)
+	{
+		return BindAs<FocusableData>(json);
+	}
+
+	JSON ToJSON(const FocusableData& focusable)
+	{
+		return JsonBinding::WriteObject(focusable);
+	}
+
+	Optional<TypedDocument> BindDocument(const StringView schemaName, const JSON& json)
+	{
+		const CompiledSchema* schema = SchemaRegistry::Find(schemaName);
+
+		if (not schema)
+		{
+			return none;
+		}
+
+		const SchemaId id = static_cast<SchemaId>(schema->handle);
+
+		switch (id)
+		{
+		case SchemaId::Whiteboard:
+		case SchemaId::Corpse:
+			return BindDocumentAs<FocusableData>(id, json);
+		case SchemaId::Lockbox:
+			return BindDocumentAs<LockboxData>(id, json);
+		case SchemaId::Diary:
+			return BindDocumentAs<DiaryData>(id, json);
+		case SchemaId::Famicom:
+			return BindDocumentAs<FamicomData>(id, json);
+		case SchemaId::LightsOutPuzzle:
+		case SchemaId::Kurotto:
+			return BindDocumentAs<GridPuzzleData>(id, json);
+		case SchemaId::RotatingPuzzle:
+			return BindDocumentAs<RotatingPuzzleData>(id, json);
+		case SchemaId::CardCase:
+			return BindDocumentAs<CardCaseData>(id, json);
+		case SchemaId::Drawer:
+			return BindDocumentAs<DrawerData>(id, json);
+		default:
+			// room_connections は Focusable の文書ではない
+			return none;
+		}
+	}
+
+	JSON ToJSON(const TypedDocument& document)
+	{
+		return std::visit([](const auto& value) { return JsonBinding::WriteObject(value); }, document.data);
+	}
+
+	size_t EstimateBytes(const TypedDocument& document)
+	{
+		return std::visit([](const auto& value) { return (sizeof(TypedDocument) + JsonBinding::ObjectHeapBytes(value)); }, document.data);
+	}
+}
@@ -0,0 +1,232 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include "JsonBinding.hpp"
+#include "../SchemaManager.hpp"
+
+// スキーマの型ごとの構造体（SchemaManager.hpp のスキーマと同じキーを持つ）
+// ・候補から選ぶ値（アクションや条件の種類、フラグの範囲）だけを Atom で持つ
+// ・アイテム名、フラグ名、アセット名、座標などの自由に書ける値は String で持つ（Atom の表は解放されないので、入力された文字列をインターンしない）
+// ・スキーマにないキーと、型が合わない値は unknown にそのまま残す（ToJSON で元に戻る）
+// ・省略可能なプロパティは Optional で持つ。必須のプロパティは、文書になくても ToJSON で既定値を書き出す
+
+// 条件（"HasItem" / "IsFlagOn"）
+struct ConditionData
+{
+	Atom type;
+
+	Optional<String> item;
+
+	Optional<String> flag;
+
+	Optional<Atom> scope;
+
+	UnknownMembers unknown;
+};
+
+// アクション。種類によって使うプロパティが違うので、種類ごとのプロパティはすべて省略可能
+struct ActionData
+{
+	Atom type;
+
+	Optional<String> file;
+
+	Optional<String> item;
+
+	Optional<String> flag;
+
+	Optional<bool> value;
+
+	Optional<Atom> scope;
+
+	Optional<String> id;
+
+	// "ChangeDimension" の行き先（スキーマにはないが、エディタが書く）
+	Optional<String> target;
+
+	Optional<ConditionData> condition;
+
+	std::unique_ptr<ActionData> success;
+
+	std::unique_ptr<ActionData> failure;
+
+	std::unique_ptr<ActionData> finalAction;
+
+	// 要素は自身と同じ型なので、ActionDraft と同じくポインタで持つ
+	Optional<Array<std::unique_ptr<ActionData>>> actions;
+
+	Optional<Array<std::unique_ptr<ActionData>>> steps;
+
+	UnknownMembers unknown;
+};
+
+struct ObjectStateData
+{
+	String asset;
+
+	Optional<String> gridPos;
+
+	UnknownMembers unknown;
+};
+
+struct ConditionalStateData
+{
+	String conditionFlag;
+
+	String asset;
+
+	Optional<String> gridPos;
+
+	UnknownMembers unknown;
+};
+
+struct HotspotData
+{
+	String gridPos;
+
+	// スキーマでは必須だが、部屋の "forcusables" の要素の hotspot は座標だけを持つので省略可能にする
+	Optional<ActionData> action;
+
+	UnknownMembers unknown;
+};
+
+// Focusable オブジェクトに共通のプロパティ（部屋の "forcusables" と "interactables" の要素も同じ形）
+struct FocusableData
+{
+	String name;
+
+	HotspotData hotspot;
+
+	ObjectStateData defaultState;
+
+	Optional<Array<ConditionalStateData>> states;
+
+	UnknownMembers unknown;
+};
+
+struct LockboxAnswerData
+{
+	String code;
+
+	String item;
+
+	UnknownMembers unknown;
+};
+
+struct LockboxData : FocusableData
+{
+	Array<LockboxAnswerData> answers;
+};
+
+struct DiaryData : FocusableData
+{
+	Array<String> pages;
+};
+
+struct FamicomData : FocusableData
+{
+	String secretCode;
+
+	String successImage;
+};
+
+// LightsOutPuzzle と Kurotto
+struct GridPuzzleData : FocusableData
+{
+	Array<Array<int32>> initialGrid;
+};
+
+struct MissingPieceData
+{
+	Array<int32> position;
+
+	String item;
+
+	UnknownMembers unknown;
+};
+
+struct RotatingPuzzleData : FocusableData
+{
+	Optional<String> backgroundTexture;
+
+	String puzzleTexture;
+
+	int32 puzzleWidth = 0;
+
+	Array<MissingPieceData> missingPieces;
+};
+
+struct CardCaseAnswerData
+{
+	Array<int32> code;
+
+	String flag;
+
+	UnknownMembers unknown;
+};
+
+struct CardCaseData : FocusableData
+{
+	Array<String> texture;
+
+	Array<CardCaseAnswerData> answers;
+};
+
+struct DrawerData : FocusableData
+{
+	Optional<String> bgOpen;
+
+	Optional<String> bgClose;
+
+	Optional<String> itemOpen;
+
+	Optional<String> itemClose;
+};
+
+// Focusable オブジェクトの文書（Whiteboard と Corpse は共通のプロパティだけを持つ）
+struct TypedDocument
+{
+	SchemaId schema = SchemaId::None;
+
+	std::variant<FocusableData, LockboxData, DiaryData, FamicomData, GridPuzzleData, RotatingPuzzleData, CardCaseData, DrawerData> data;
+
+	// 種類によらない共通のプロパティ
+	[[nodiscard]]
+	const FocusableData& common() const
+	{
+		return std::visit([](const FocusableData& focusable) -> const FocusableData& { return focusable; }, data);
+	}
+};
+
+// 構造体と JSON の相互変換（JSON のメンバーを1回走査するだけで、キーの比較は整数で行う）
+namespace TypedObjects
+{
+	// 型が合わなければ none（オブジェクトでない場合だけ。プロパティの型の違いは unknown に残す）
+	[[nodiscard]]
+	Optional<ActionData> BindAction(const JSON& json);
+
+	[[nodiscard]]
+	JSON ToJSON(const ActionData& action);
+
+	[[nodiscard]]
+	Optional<HotspotData> BindHotspot(const JSON& json);
+
+	[[nodiscard]]
+	JSON ToJSON(const HotspotData& hotspot);
+
+	[[nodiscard]]
+	Optional<FocusableData> BindFocusable(const JSON& json);
+
+	[[nodiscard]]
+	JSON ToJSON(const FocusableData& focusable);
+
+	// ファイル名（拡張子なし）に対応する型で文書を読む。Focusable の文書でなければ none
+	[[nodiscard]]
+	Optional<TypedDocument> BindDocument(StringView schemaName, const JSON& json);
+
+	[[nodiscard]]
+	JSON ToJSON(const TypedDocument& document);
+
+	// 構造体とその中の配列・文字列・unknown が使うメモリの見積もり（Atom の表は含まない）
+	[[nodiscard]]
+	size_t EstimateBytes(const TypedDocument& document);
+}
@@ -1,265 +1,379 @@
 ﻿#pragma once
 #include <Siv3D.hpp>
+#include "Model/SchemaRegistry.hpp"
 
-struct Schema;
-
-// プロパティが持つべき情報の定義
-struct SchemaProperty
+// スキーマの番号。g_SchemaTable の並びと一致させる（ファイル名で引けるものを先に並べる）
+enum class SchemaId : SchemaHandle
 {
-	String description;       // プロパティの説明（例：「背景画像」）
-	JSONValueType type;       // 期待される型（文字列、数値、配列など）
-	bool isRequired;          // このプロパティが必須かどうか
+	Room,
+	Whiteboard,
+	Lockbox,
+	Corpse,
+	Diary,
+	Famicom,
+	LightsOutPuzzle,
+	Kurotto,
+	RotatingPuzzle,
+	CardCase,
+	Drawer,
+
+	Condition,
+	Action,
+	ObjectState,
+	ConditionalState,
+	Hotspot,
+	MissingPiece,
+	CardCaseAnswer,
+	LockboxAnswer,
+	Interactable,
+	ForcusableLayout,
+	InteractableLayout,
+	Layout,
+	ConditionalTransition,
 
-	std::shared_ptr<Schema> childSchema = nullptr;
+	Count,
+
+	None = InvalidSchemaHandle,
 };
 
-// スキーマ本体（プロパティ名の辞書）
-struct Schema : HashTable<String, SchemaProperty>
+// スキーマを定数として宣言するための関数（すべてコンパイル時に評価される）
+namespace SchemaDSL
 {
-	using HashTable<String, SchemaProperty>::HashTable;
-};
+	consteval SchemaField RequiredField(const StringView key, const StringView description, const JSONValueType type, const SchemaId child = SchemaId::None)
+	{
+		return{ .key = key, .atom = Atom::Static(key), .description = description, .label = SchemaLabel::FromDescription(description.view()),
+			.type = type, .isRequired = true, .child = static_cast<SchemaHandle>(child) };
+	}
 
+	consteval SchemaField OptionalField(const StringView key, const StringView description, const JSONValueType type, const SchemaId child = SchemaId::None)
+	{
+		return{ .key = key, .atom = Atom::Static(key), .description = description, .label = SchemaLabel::FromDescription(description.view()),
+			.type = type, .isRequired = false, .child = static_cast<SchemaHandle>(child) };
+	}
 
-inline const auto g_ConditionSchema = std::make_shared<Schema>(Schema{
-	{ U"type", { U"Type", JSONValueType::String, true, nullptr } },
-	// "HasItem" の場合
-	{ U"item", { U"Item ID", JSONValueType::String, false, nullptr } },
-	// "IsFlagOn" の場合
-	{ U"flag", { U"Flag Name", JSONValueType::String, false, nullptr } },
-	{ U"scope", { U"Scope (Global/Dimension)", JSONValueType::String, false, nullptr } },
-});
+	// 共通のプロパティの後ろに、種類ごとのプロパティをつなげる
+	template <size_t N, size_t M>
+	consteval std::array<SchemaField, (N + M)> Concat(const std::array<SchemaField, N>& base, const std::array<SchemaField, M>& extra)
+	{
+		std::array<SchemaField, (N + M)> result{};
 
-inline std::shared_ptr<Schema> g_ActionSchema = std::make_shared<Schema>();
+		for (size_t i = 0; i < N; ++i)
+		{
+			result[i] = base[i];
+		}
 
-inline void InitializeSchemas()
-{
-	*g_ActionSchema = {
-		{ U"type", { U"Type", JSONValueType::String, true, nullptr } },
-		{ U"file", { U"Text File Path", JSONValueType::String, false, nullptr } },
-		{ U"item", { U"Item ID", JSONValueType::String, false, nullptr } },
-		{ U"flag", { U"Flag Name", JSONValueType::String, false, nullptr } },
-		{ U"value", { U"Set Value", JSONValueType::Bool, false, nullptr } },
-		{ U"scope", { U"Scope", JSONValueType::String, false, nullptr } },
-		{ U"id", { U"MultiStep ID", JSONValueType::String, false, nullptr } },
-		{ U"condition", { U"Condition", JSONValueType::Object, false, g_ConditionSchema } },
-		{ U"success", { U"Success Action", JSONValueType::Object, false, g_ActionSchema } },
-		{ U"failure", { U"Failure Action", JSONValueType::Object, false, g_ActionSchema } },
-		{ U"final_action", { U"Final Action", JSONValueType::Object, false, g_ActionSchema } },
-		{ U"actions", { U"Action Sequence", JSONValueType::Array, false, g_ActionSchema } },
-		{ U"steps", { U"Multi-Step Actions", JSONValueType::Array, false, g_ActionSchema } },
-	};
+		for (size_t i = 0; i < M; ++i)
+		{
+			result[N + i] = extra[i];
+		}
+
+		return result;
+	}
+
+	// ファイル名（拡張子なし）で引けるスキーマ
+	consteval CompiledSchema Document(const SchemaId id, const StringView fileName, const std::span<const SchemaField> fields)
+	{
+		return{ .name = fileName, .handle = static_cast<SchemaHandle>(id), .fields = fields, .isDocument = true };
+	}
+
+	// ほかのスキーマの子としてだけ使うスキーマ
+	consteval CompiledSchema Nested(const SchemaId id, const StringView name, const std::span<const SchemaField> fields)
+	{
+		return{ .name = name, .handle = static_cast<SchemaHandle>(id), .fields = fields, .isDocument = false };
+	}
 }
 
-inline void InitializeRecursiveSchemas()
+// 各スキーマのプロパティ。子スキーマは SchemaId で指すので、自身を子に持つ Action も宣言だけで済む
+namespace SchemaFields
 {
-	auto& actionSchemaRef = const_cast<Schema&>(*g_ActionSchema);
-	actionSchemaRef[U"success"].childSchema = g_ActionSchema;
-	actionSchemaRef[U"failure"].childSchema = g_ActionSchema;
-	actionSchemaRef[U"actions"].childSchema = g_ActionSchema;
-	actionSchemaRef[U"steps"].childSchema = g_ActionSchema;
-	actionSchemaRef[U"final_action"].childSchema = g_ActionSchema;
-}
+	using namespace SchemaDSL;
 
-// "asset" と "grid_pos" を持つ、オブジェクトの基本的な状態スキーマ
-inline const auto g_ObjectStateSchema = std::make_shared<Schema>(Schema{
-	{ U"asset", { U"Asset Name", JSONValueType::String, true, nullptr } },
-	{ U"grid_pos", { U"Grid Position", JSONValueType::String, false, nullptr } },
-});
-
-// "condition_flag" を持つ、条件付きの状態スキーマ
-inline const auto g_ConditionalStateSchema = std::make_shared<Schema>(Schema{
-	{ U"condition_flag", { U"Condition Flag", JSONValueType::String, true, nullptr } },
-	{ U"asset", { U"Asset Name", JSONValueType::String, true, nullptr } },
-	{ U"grid_pos", { U"Grid Position", JSONValueType::String, false, nullptr } },
-});
-
-inline const auto g_HotspotSchema = std::make_shared<Schema>(Schema{
-	{ U"grid_pos", { U"Position (e.g., A1-B2)", JSONValueType::String, true, nullptr } },
-	{ U"action", { U"Action", JSONValueType::Object, true, g_ActionSchema } }
-});
-
-inline const auto g_MissingPieceSchema = std::make_shared<Schema>(Schema{
-		{ U"position", { U"Position [x, y]", JSONValueType::Array, true, nullptr } },
-		{ U"item", { U"Required Item ID", JSONValueType::String, true, nullptr } }
-	});
+	inline constexpr std::array Condition{
+		RequiredField(U"type", U"Type", JSONValueType::String),
+		// "HasItem" の場合
+		OptionalField(U"item", U"Item ID", JSONValueType::String),
+		// "IsFlagOn" の場合
+		OptionalField(U"flag", U"Flag Name", JSONValueType::String),
+		OptionalField(U"scope", U"Scope (Global/Dimension)", JSONValueType::String),
+	};
+
+	inline constexpr std::array Action{
+		RequiredField(U"type", U"Type", JSONValueType::String),
+		OptionalField(U"file", U"Text File Path", JSONValueType::String),
+		OptionalField(U"item", U"Item ID", JSONValueType::String),
+		OptionalField(U"flag", U"Flag Name", JSONValueType::String),
+		OptionalField(U"value", U"Set Value", JSONValueType::Bool),
+		OptionalField(U"scope", U"Scope", JSONValueType::String),
+		OptionalField(U"id", U"MultiStep ID", JSONValueType::String),
+		OptionalField(U"condition", U"Condition", JSONValueType::Object, SchemaId::Condition),
+		OptionalField(U"success", U"Success Action", JSONValueType::Object, SchemaId::Action),
+		OptionalField(U"failure", U"Failure Action", JSONValueType::Object, SchemaId::Action),
+		OptionalField(U"final_action", U"Final Action", JSONValueType::Object, SchemaId::Action),
+		OptionalField(U"actions", U"Action Sequence", JSONValueType::Array, SchemaId::Action),
+		OptionalField(U"steps", U"Multi-Step Actions", JSONValueType::Array, SchemaId::Action),
+	};
+
+	// "asset" と "grid_pos" を持つ、オブジェクトの基本的な状態スキーマ
+	inline constexpr std::array ObjectState{
+		RequiredField(U"asset", U"Asset Name", JSONValueType::String),
+		OptionalField(U"grid_pos", U"Grid Position", JSONValueType::String),
+	};
+
+	// "condition_flag" を持つ、条件付きの状態スキーマ
+	inline constexpr std::array ConditionalState{
+		RequiredField(U"condition_flag", U"Condition Flag", JSONValueType::String),
+		RequiredField(U"asset", U"Asset Name", JSONValueType::String),
+		OptionalField(U"grid_pos", U"Grid Position", JSONValueType::String),
+	};
+
+	inline constexpr std::array Hotspot{
+		RequiredField(U"grid_pos", U"Position (e.g., A1-B2)", JSONValueType::String),
+		RequiredField(U"action", U"Action", JSONValueType::Object, SchemaId::Action),
+	};
+
+	inline constexpr std::array MissingPiece{
+		RequiredField(U"position", U"Position [x, y]", JSONValueType::Array),
+		RequiredField(U"item", U"Required Item ID", JSONValueType::String),
+	};
+
+	inline constexpr std::array CardCaseAnswer{
+		RequiredField(U"code", U"Code (Array of numbers)", JSONValueType::Array),
+		RequiredField(U"flag", U"Flag to set on success", JSONValueType::String),
+	};
+
+	inline constexpr std::array LockboxAnswer{
+		RequiredField(U"code", U"Code", JSONValueType::String),
+		RequiredField(U"item", U"Reward Item", JSONValueType::String),
+	};
+
+	inline constexpr std::array Room{
+		RequiredField(U"background", U"Background Asset", JSONValueType::String),
+		OptionalField(U"transitions", U"Room Transitions", JSONValueType::Object),
+		// エディタが書く要素は asset を default_state の中に持ち、Interactable とは形が違うので子スキーマはつながない
+		OptionalField(U"interactables", U"Interactable Objects", JSONValueType::Array),
+	};
+
+	// Interactableオブジェクトのスキーマ
+	inline constexpr std::array Interactable{
+		RequiredField(U"name", U"Object Name (Unique)", JSONValueType::String),
+		RequiredField(U"asset", U"Texture Asset Name", JSONValueType::String),
+		RequiredField(U"hotspot", U"Hotspot", JSONValueType::Object, SchemaId::Hotspot),
+	};
 
-inline const auto g_CardCaseAnswerSchema = std::make_shared<Schema>(Schema{
-	{ U"code", { U"Code (Array of numbers)", JSONValueType::Array, true, nullptr } },
-	{ U"flag", { U"Flag to set on success", JSONValueType::String, true, nullptr } }
-});
-
-inline const auto g_LockboxAnswerSchema = std::make_shared<Schema>(Schema{
-	{ U"code", { U"Code", JSONValueType::String, true, nullptr } },
-	{ U"item", { U"Reward Item", JSONValueType::String, true, nullptr } }
-});
-
-inline const auto g_RoomSchema = std::make_shared<Schema>(Schema{
-	{ U"background", { U"Background Asset", JSONValueType::String, true, nullptr } },
-	{ U"transitions", { U"Room Transitions", JSONValueType::Object, false, nullptr } },
-	{ U"interactables", { U"Interactable Objects", JSONValueType::Array, false, nullptr /* g_InteractableSchema */ } }, // 再帰定義を避けるため、実際のchildSchemaはInitialize関数で設定
-});
-
-// Interactableオブジェクトのスキーマ
-inline const auto g_InteractableSchema = std::make_shared<Schema>(Schema{
-	{ U"name", { U"Object Name (Unique)", JSONValueType::String, true, nullptr } },
-	{ U"asset", { U"Texture Asset Name", JSONValueType::String, true, nullptr } },
-	{ U"hotspot", { U"Hotspot", JSONValueType::Object, true, g_HotspotSchema } },
-});
-
-// Forcusableオブジェクトのレイアウトスキーマ
-inline const auto g_ForcusableLayoutSchema = std::make_shared<Schema>(Schema{
+	// Forcusableオブジェクトのレイアウトスキーマ
 	// 例: { "Whiteboard": "D3" }
 	// キー: Forcusableのファイル名(拡張子なし), 値: グリッド座標
-});
+	inline constexpr std::array<SchemaField, 0> ForcusableLayout{};
 
-// Interactableオブジェクトのレイアウトスキーマ
-inline const auto g_InteractableLayoutSchema = std::make_shared<Schema>(Schema{
+	// Interactableオブジェクトのレイアウトスキーマ
 	// 例: { "Window": "D3-E3" }
 	// キー: Interactableのname, 値: グリッド座標
-});
-
-// レイアウト全体のスキーマ
-inline const auto g_LayoutSchema = std::make_shared<Schema>(Schema{
-	{ U"forcusable", { U"Focusable Objects", JSONValueType::Object, true, g_ForcusableLayoutSchema } },
-	{ U"interactable", { U"Interactable Objects", JSONValueType::Object, true, g_InteractableLayoutSchema } }
-});
-
-// 条件付きTransitionオブジェクトのスキーマ
-inline const auto g_ConditionalTransitionSchema = std::make_shared<Schema>(Schema{
-	{ U"to", { U"Destination Room", JSONValueType::String, true, nullptr } },
-	{ U"condition", { U"Required Flag", JSONValueType::String, true, nullptr } },
-	{ U"scope", { U"Flag Scope", JSONValueType::String, true, nullptr } }
-});
-
-inline const HashTable<String, Schema> g_Schemas = {
-		{
-			U"room_connections", *g_RoomSchema
-		},
-		{
-			U"Whiteboard", {
-				{ U"name", { U"Object Name", JSONValueType::String, true, nullptr } },
-				{ U"hotspot", { U"Hotspot", JSONValueType::Object, true, nullptr /* g_HotspotSchema */ } },
-				{ U"default_state", { U"Default State", JSONValueType::Object, true, g_ObjectStateSchema } },
-				{ U"states", { U"Conditional States", JSONValueType::Array, false, g_ConditionalStateSchema } },
-			}
-		},
-		{
-			U"Lockbox", {
-				{ U"name", { U"Object Name", JSONValueType::String, true, nullptr } },
-				{ U"hotspot", { U"Hotspot", JSONValueType::Object, true, nullptr /* g_HotspotSchema */ } },
-				{ U"default_state", { U"Default State", JSONValueType::Object, true, g_ObjectStateSchema } },
-				{ U"states", { U"Conditional States", JSONValueType::Array, false, g_ConditionalStateSchema } },
-				{ U"answers", { U"Answer List", JSONValueType::Array, true, g_LockboxAnswerSchema } }
-			}
-		},
-		{
-			U"Corpse", {
-				{ U"name", { U"Object Name", JSONValueType::String, true, nullptr } },
-				{ U"hotspot", { U"Hotspot", JSONValueType::Object, true, nullptr /* g_HotspotSchema */ } },
-				{ U"default_state", { U"Default State", JSONValueType::Object, true, g_ObjectStateSchema } },
-				{ U"states", { U"Conditional States", JSONValueType::Array, false, g_ConditionalStateSchema } },
-			}
-		},
-		{
-			U"Diary", {
-				{ U"name", { U"Object Name", JSONValueType::String, true, nullptr } },
-				{ U"hotspot", { U"Hotspot", JSONValueType::Object, true, nullptr /* g_HotspotSchema */ } },
-				{ U"default_state", { U"Default State", JSONValueType::Object, true, g_ObjectStateSchema } },
-				{ U"states", { U"Conditional States", JSONValueType::Array, false, g_ConditionalStateSchema } },
-				{ U"pages", { U"Diary Pages (Array of Strings)", JSONValueType::Array, true, nullptr } },
-			}
-		},
-		{
-			U"Famicom", {
-				{ U"name", { U"Object Name", JSONValueType::String, true, nullptr } },
-				{ U"hotspot", { U"Hotspot", JSONValueType::Object, true, nullptr /* g_HotspotSchema */ } },
-				{ U"default_state", { U"Default State", JSONValueType::Object, true, g_ObjectStateSchema } },
-				{ U"states", { U"Conditional States", JSONValueType::Array, false, g_ConditionalStateSchema } },
-				{ U"secret_code", { U"Secret Code", JSONValueType::String, true, nullptr } },
-				{ U"success_image", { U"Success Image Path", JSONValueType::String, true, nullptr } },
-			}
-		},
-		{
-			U"LightsOutPuzzle", {
-				{ U"name", { U"Object Name", JSONValueType::String, true, nullptr } },
-				{ U"hotspot", { U"Hotspot", JSONValueType::Object, true, nullptr /* g_HotspotSchema */ } },
-				{ U"default_state", { U"Default State", JSONValueType::Object, true, g_ObjectStateSchema } },
-				{ U"states", { U"Conditional States", JSONValueType::Array, false, g_ConditionalStateSchema } },
-				{ U"initial_grid", { U"Initial Grid (2D Array of 0s/1s)", JSONValueType::Array, true, nullptr } },
-			}
-		},
+	inline constexpr std::array<SchemaField, 0> InteractableLayout{};
+
+	// レイアウト全体のスキーマ
+	inline constexpr std::array Layout{
+		RequiredField(U"forcusable", U"Focusable Objects", JSONValueType::Object, SchemaId::ForcusableLayout),
+		RequiredField(U"interactable", U"Interactable Objects", JSONValueType::Object, SchemaId::InteractableLayout),
+	};
+
+	// 条件付きTransitionオブジェクトのスキーマ
+	inline constexpr std::array ConditionalTransition{
+		RequiredField(U"to", U"Destination Room", JSONValueType::String),
+		RequiredField(U"condition", U"Required Flag", JSONValueType::String),
+		RequiredField(U"scope", U"Flag Scope", JSONValueType::String),
+	};
+
+	// Focusableオブジェクトに共通のプロパティ
+	inline constexpr std::array Focusable{
+		RequiredField(U"name", U"Object Name", JSONValueType::String),
+		RequiredField(U"hotspot", U"Hotspot", JSONValueType::Object, SchemaId::Hotspot),
+		RequiredField(U"default_state", U"Default State", JSONValueType::Object, SchemaId::ObjectState),
+		OptionalField(U"states", U"Conditional States", JSONValueType::Array, SchemaId::ConditionalState),
+	};
+
+	inline constexpr auto Whiteboard = Focusable;
+
+	inline constexpr auto Lockbox = Concat(Focusable, std::array{
+		RequiredField(U"answers", U"Answer List", JSONValueType::Array, SchemaId::LockboxAnswer),
+	});
+
+	inline constexpr auto Corpse = Focusable;
+
+	inline constexpr auto Diary = Concat(Focusable, std::array{
+		RequiredField(U"pages", U"Diary Pages (Array of Strings)", JSONValueType::Array),
+	});
+
+	inline constexpr auto Famicom = Concat(Focusable, std::array{
+		RequiredField(U"secret_code", U"Secret Code", JSONValueType::String),
+		RequiredField(U"success_image", U"Success Image Path", JSONValueType::String),
+	});
+
+	inline constexpr auto LightsOutPuzzle = Concat(Focusable, std::array{
+		RequiredField(U"initial_grid", U"Initial Grid (2D Array of 0s/1s)", JSONValueType::Array),
+	});
+
+	inline constexpr auto Kurotto = Concat(Focusable, std::array{
+		RequiredField(U"initial_grid", U"Initial Grid (2D Array)", JSONValueType::Array),
+	});
+
+	inline constexpr auto RotatingPuzzle = Concat(Focusable, std::array{
+		OptionalField(U"background_texture", U"Background Texture", JSONValueType::String),
+		RequiredField(U"puzzle_texture", U"Puzzle Texture ID", JSONValueType::String),
+		RequiredField(U"puzzle_width", U"Puzzle Width (e.g., 3)", JSONValueType::Number),
+		RequiredField(U"missing_pieces", U"Missing Pieces Info", JSONValueType::Array, SchemaId::MissingPiece),
+	});
+
+	inline constexpr auto CardCase = Concat(Focusable, std::array{
+		RequiredField(U"texture", U"Card Textures (Array of strings)", JSONValueType::Array),
+		RequiredField(U"answers", U"Answer Patterns", JSONValueType::Array, SchemaId::CardCaseAnswer),
+	});
+
+	inline constexpr auto Drawer = Concat(Focusable, std::array{
+		OptionalField(U"bg_open", U"Background (Open)", JSONValueType::String),
+		OptionalField(U"bg_close", U"Background (Close)", JSONValueType::String),
+		OptionalField(U"item_open", U"Item (Open)", JSONValueType::String),
+		OptionalField(U"item_close", U"Item (Close)", JSONValueType::String),
+	});
+}
+
+// すべてのスキーマ（SchemaId の順）
+inline constexpr std::array g_SchemaTable{
+	SchemaDSL::Document(SchemaId::Room, U"room_connections", SchemaFields::Room),
+	SchemaDSL::Document(SchemaId::Whiteboard, U"Whiteboard", SchemaFields::Whiteboard),
+	SchemaDSL::Document(SchemaId::Lockbox, U"Lockbox", SchemaFields::Lockbox),
+	SchemaDSL::Document(SchemaId::Corpse, U"Corpse", SchemaFields::Corpse),
+	SchemaDSL::Document(SchemaId::Diary, U"Diary", SchemaFields::Diary),
+	SchemaDSL::Document(SchemaId::Famicom, U"Famicom", SchemaFields::Famicom),
+	SchemaDSL::Document(SchemaId::LightsOutPuzzle, U"LightsOutPuzzle", SchemaFields::LightsOutPuzzle),
+	SchemaDSL::Document(SchemaId::Kurotto, U"Kurotto", SchemaFields::Kurotto),
+	SchemaDSL::Document(SchemaId::RotatingPuzzle, U"RotatingPuzzle", SchemaFields::RotatingPuzzle),
+	SchemaDSL::Document(SchemaId::CardCase, U"CardCase", SchemaFields::CardCase),
+	SchemaDSL::Document(SchemaId::Drawer, U"Drawer", SchemaFields::Drawer),
+
+	SchemaDSL::Nested(SchemaId::Condition, U"Condition", SchemaFields::Condition),
+	SchemaDSL::Nested(SchemaId::Action, U"Action", SchemaFields::Action),
+	SchemaDSL::Nested(SchemaId::ObjectState, U"ObjectState", SchemaFields::ObjectState),
+	SchemaDSL::Nested(SchemaId::ConditionalState, U"ConditionalState", SchemaFields::ConditionalState),
+	SchemaDSL::Nested(SchemaId::Hotspot, U"Hotspot", SchemaFields::Hotspot),
+	SchemaDSL::Nested(SchemaId::MissingPiece, U"MissingPiece", SchemaFields::MissingPiece),
+	SchemaDSL::Nested(SchemaId::CardCaseAnswer, U"CardCaseAnswer", SchemaFields::CardCaseAnswer),
+	SchemaDSL::Nested(SchemaId::LockboxAnswer, U"LockboxAnswer", SchemaFields::LockboxAnswer),
+	SchemaDSL::Nested(SchemaId::Interactable, U"Interactable", SchemaFields::Interactable),
+	SchemaDSL::Nested(SchemaId::ForcusableLayout, U"ForcusableLayout", SchemaFields::ForcusableLayout),
+	SchemaDSL::Nested(SchemaId::InteractableLayout, U"InteractableLayout", SchemaFields::InteractableLayout),
+	SchemaDSL::Nested(SchemaId::Layout, U"Layout", SchemaFields::Layout),
+	SchemaDSL::Nested(SchemaId::ConditionalTransition, U"ConditionalTransition", SchemaFields::ConditionalTransition),
+};
+
+// 宣言の誤りはここでコンパイルエラーにする
+namespace SchemaDSL
+{
+	consteval bool HandlesMatchOrder()
+	{
+		for (size_t i = 0; i < g_SchemaTable.size(); ++i)
 		{
-			U"Kurotto", {
-				{ U"name", { U"Object Name", JSONValueType::String, true, nullptr } },
-				{ U"hotspot", { U"Hotspot", JSONValueType::Object, true, nullptr /* g_HotspotSchema */ } },
-				{ U"default_state", { U"Default State", JSONValueType::Object, true, g_ObjectStateSchema } },
-				{ U"states", { U"Conditional States", JSONValueType::Array, false, g_ConditionalStateSchema } },
-				{ U"initial_grid", { U"Initial Grid (2D Array)", JSONValueType::Array, true, nullptr } },
+			if (g_SchemaTable[i].handle != i)
+			{
+				return false;
 			}
-		},
+		}
+
+		return (g_SchemaTable.size() == static_cast<size_t>(SchemaId::Count));
+	}
+
+	consteval size_t CountDocuments()
+	{
+		size_t count = 0;
+
+		while ((count < g_SchemaTable.size()) && g_SchemaTable[count].isDocument)
 		{
-			U"RotatingPuzzle", {
-				{ U"name", { U"Object Name", JSONValueType::String, true, nullptr } },
-				{ U"hotspot", { U"Hotspot", JSONValueType::Object, true, nullptr /* g_HotspotSchema */ } },
-				{ U"default_state", { U"Default State", JSONValueType::Object, true, g_ObjectStateSchema } },
-				{ U"states", { U"Conditional States", JSONValueType::Array, false, g_ConditionalStateSchema } },
-				{ U"background_texture", { U"Background Texture", JSONValueType::String, false, nullptr } },
-				{ U"puzzle_texture", { U"Puzzle Texture ID", JSONValueType::String, true, nullptr } },
-				{ U"puzzle_width", { U"Puzzle Width (e.g., 3)", JSONValueType::Number, true, nullptr } },
-				{ U"missing_pieces", { U"Missing Pieces Info", JSONValueType::Array, true, g_MissingPieceSchema } }
-			}
-		},
+			++count;
+		}
+
+		return count;
+	}
+
+	consteval bool DocumentsComeFirst()
+	{
+		for (size_t i = CountDocuments(); i < g_SchemaTable.size(); ++i)
 		{
-			U"CardCase", {
-				{ U"name", { U"Object Name", JSONValueType::String, true, nullptr } },
-				{ U"hotspot", { U"Hotspot", JSONValueType::Object, true, nullptr /* g_HotspotSchema */ } },
-				{ U"default_state", { U"Default State", JSONValueType::Object, true, g_ObjectStateSchema } },
-				{ U"states", { U"Conditional States", JSONValueType::Array, false, g_ConditionalStateSchema } },
-				{ U"texture", { U"Card Textures (Array of strings)", JSONValueType::Array, true, nullptr } },
-				{ U"answers", { U"Answer Patterns", JSONValueType::Array, true, g_CardCaseAnswerSchema } }
+			if (g_SchemaTable[i].isDocument)
+			{
+				return false;
 			}
-		},
+		}
+
+		return true;
+	}
+
+	consteval bool KeysAreUnique()
 	{
-			U"Drawer", {
-				{ U"name", { U"Object Name", JSONValueType::String, true, nullptr } },
-				{ U"hotspot", { U"Hotspot", JSONValueType::Object, true, nullptr /* g_HotspotSchema */ } },
-				{ U"default_state", { U"Default State", JSONValueType::Object, true, g_ObjectStateSchema } },
-				{ U"states", { U"Conditional States", JSONValueType::Array, false, g_ConditionalStateSchema } },
-				{ U"bg_open", { U"Background (Open)", JSONValueType::String, false, nullptr } },
-				{ U"bg_close", { U"Background (Close)", JSONValueType::String, false, nullptr } },
-				{ U"item_open", { U"Item (Open)", JSONValueType::String, false, nullptr } },
-				{ U"item_close", { U"Item (Close)", JSONValueType::String, false, nullptr } },
+		for (const auto& schema : g_SchemaTable)
+		{
+			for (size_t i = 0; i < schema.fields.size(); ++i)
+			{
+				for (size_t k = 0; k < i; ++k)
+				{
+					if (schema.fields[i].key.view() == schema.fields[k].key.view())
+					{
+						return false;
+					}
+				}
 			}
-		},
-};
+		}
 
-inline void InitializeSchemaDependencies()
-{
-	// g_Schemasは定数なので、初期化時のみの特別な処理としてconst_castを使い、一時的に書き込みを許可します。
-	auto& schemasRef = const_cast<HashTable<String, Schema>&>(g_Schemas);
+		return true;
+	}
 
-	// g_Schemas内のすべてのスキーマをループ
-	for (auto& pair : schemasRef)
+	// 子スキーマは、表にあるスキーマを指し、オブジェクトか配列のプロパティだけが持つ
+	consteval bool ChildrenAreValid()
 	{
-		// もしスキーマに "hotspot" というキーがあれば
-		if (pair.second.contains(U"hotspot"))
+		for (const auto& schema : g_SchemaTable)
 		{
-			// その hotspot の childSchema に g_HotspotSchema を設定する
-			pair.second.at(U"hotspot").childSchema = g_HotspotSchema;
+			for (const auto& field : schema.fields)
+			{
+				if (field.child == InvalidSchemaHandle)
+				{
+					continue;
+				}
+
+				if ((g_SchemaTable.size() <= field.child)
+					|| ((field.type != JSONValueType::Object) && (field.type != JSONValueType::Array)))
+				{
+					return false;
+				}
+			}
 		}
+
+		return true;
 	}
+
+	static_assert(HandlesMatchOrder(), "g_SchemaTable must be ordered by SchemaId");
+	static_assert(DocumentsComeFirst(), "document schemas must precede nested schemas");
+	static_assert(KeysAreUnique(), "duplicate property key in a schema");
+	static_assert(ChildrenAreValid(), "child schema must be a valid SchemaId on an object or array property");
 }
 
+// ファイル名で引けるスキーマの数（g_SchemaTable の先頭から）
+inline constexpr size_t g_DocumentSchemaCount = SchemaDSL::CountDocuments();
 
-inline Optional<Schema> GetSchema(const String& fileName)
+[[nodiscard]]
+constexpr const CompiledSchema& SchemaOf(const SchemaId id)
 {
+	return g_SchemaTable[static_cast<size_t>(id)];
+}
 
-	if (g_Schemas.contains(fileName))
+// スキーマ id のプロパティ key。宣言にないキーはコンパイルエラーになる
+[[nodiscard]]
+consteval const SchemaField& SchemaFieldOf(const SchemaId id, const StringView key)
+{
+	if (const SchemaField* field = SchemaOf(id).findField(key))
 	{
-		Logger << U" -> Found schema!"; // 見つかった場合
-		return g_Schemas.at(fileName);
+		return *field;
 	}
 
-	Logger << U" -> Schema NOT found."; // 見つからなかった場合
-	return none;
+	throw "unknown schema property";
 }
+
+static_assert(SchemaFieldOf(SchemaId::Hotspot, U"action").child == static_cast<SchemaHandle>(SchemaId::Action));
+static_assert(SchemaFieldOf(SchemaId::Action, U"success").child == static_cast<SchemaHandle>(SchemaId::Action));
@@ -6,6 +6,7 @@
 
 #include "../Model/DimensionModel.hpp"
 #include "../Controller/EditorController.hpp"
+#include "../Benchmark/AllocationCounter.hpp"
 
 namespace s3d
 {
@@ -27,15 +28,6 @@ namespace
 		"ステップ実行 (MultiStep)",
 		"次元を移動 (ChangeDimension)"
 	};
-	enum ActionTypeIndex {
-		ActionType_ShowText = 0,
-		ActionType_GiveItem,
-		ActionType_SetFlag,
-		ActionType_Conditional,
-		ActionType_Sequence,
-		ActionType_MultiStep,
-		ActionType_ChangeDimension
-	};
 }
 
 int EditorView::s_selectedActionTypeIndex = 0;
@@ -193,6 +185,7 @@ void EditorView::draw(DimensionModel& model, EditorController& controller)
 	drawHierarchyPanel(model, controller);
 	drawCanvasPanel(controller);
 	drawInspectorPanel(controller);
+	drawProblemsPanel(controller);
 }
 
 void EditorView::openInteractableEditor(int index)
@@ -204,33 +197,28 @@ void EditorView::openInteractableEditor(int index)
 	else {
 		m_isEditingInteractable = true;
 		m_editingInteractableIndex = index;
-		const auto& item = m_editingRoomDataCopy[U"interactables"][index];
-		m_interactableDraftState.nameBuffer = item[U"name"].getOpt<String>().value_or(U"").toUTF8();
-		if (item.hasElement(U"default_state")) {
-			const auto& defaultState = item[U"default_state"];
-			m_interactableDraftState.defaultStateDraft.assetBuffer = defaultState[U"asset"].getOpt<String>().value_or(U"").toUTF8();
-			m_interactableDraftState.defaultStateDraft.gridPosBuffer = defaultState[U"grid_pos"].getOpt<String>().value_or(U"").toUTF8();
-		}
+		// 型付きのデータに1回で読み込み、フィールドごとの JSON の検索をしない
+		const FocusableData item = TypedObjects::BindFocusable(m_roomEditSession.get(U"interactables")[index]).value_or(FocusableData{});
+		m_interactableDraftState.nameBuffer = item.name.toUTF8();
+		m_interactableDraftState.defaultStateDraft.assetBuffer = item.defaultState.asset.toUTF8();
+		m_interactableDraftState.defaultStateDraft.gridPosBuffer = item.defaultState.gridPos.value_or(U"").toUTF8();
 
 		m_interactableDraftState.states.clear();
-		if (item.hasElement(U"states"))
+		if (item.states)
 		{
-			for (const auto& stateJson : item[U"states"].arrayView())
+			for (const auto& state : *item.states)
 			{
 				ConditionalStateDraft stateDraft;
-				stateDraft.conditionFlagBuffer = stateJson[U"condition_flag"].getOpt<String>().value_or(U"").toUTF8();
-				stateDraft.assetBuffer = stateJson[U"asset"].getOpt<String>().value_or(U"").toUTF8();
-				stateDraft.gridPosBuffer = stateJson[U"grid_pos"].getOpt<String>().value_or(U"").toUTF8();
+				stateDraft.conditionFlagBuffer = state.conditionFlag.toUTF8();
+				stateDraft.assetBuffer = state.asset.toUTF8();
+				stateDraft.gridPosBuffer = state.gridPos.value_or(U"").toUTF8();
 				m_interactableDraftState.states.push_back(stateDraft);
 			}
 		}
 
-		if (item.hasElement(U"hotspot")) {
-			const auto& hotspot = item[U"hotspot"];
-			m_interactableDraftState.hotspotDraft.gridPosBuffer = hotspot[U"grid_pos"].getOpt<String>().value_or(U"").toUTF8();
-			if (hotspot.hasElement(U"action")) {
-				buildDraftFromActionJson(m_interactableDraftState.hotspotDraft.rootAction, hotspot[U"action"]);
-			}
+		m_interactableDraftState.hotspotDraft.gridPosBuffer = item.hotspot.gridPos.toUTF8();
+		if (item.hotspot.action) {
+			EditorDrafts::BuildDraftFromAction(m_interactableDraftState.hotspotDraft.rootAction, *item.hotspot.action);
 		}
 	}
 	m_showAddInteractableWindow = (index == -1);
@@ -253,7 +241,7 @@ void EditorView::drawRoomEditorWindow(EditorController& controller)
 		return;
 	}
 
-	String modalTitle = U"Edit Room: {}"_fmt(m_editingRoomName);
+	String modalTitle = U"Edit Room: {}"_fmt(m_roomEditSession.getRoomName());
 	if (ImGui::Begin(modalTitle.toUTF8().c_str(), &m_showRoomEditor))
 	{
 		//==============================================================================
@@ -266,12 +254,12 @@ void EditorView::drawRoomEditorWindow(EditorController& controller)
 			//--------------------------------------------------------------------------
 			if (ImGui::BeginTabItem("General"))
 			{
-				if (m_editingRoomDataCopy.hasElement(U"background") && m_editingRoomDataCopy[U"background"].isString())
+				if (const JSON background = m_roomEditSession.get(U"background"); background.isString())
 				{
-					std::string bgBuffer = m_editingRoomDataCopy[U"background"].get<String>().toUTF8();
+					std::string bgBuffer = background.get<String>().toUTF8();
 					if (ImGui::InputText("Background Asset", &bgBuffer, ImGuiInputTextFlags_EnterReturnsTrue))
 					{
-						m_editingRoomDataCopy[U"background"] = Unicode::FromUTF8(bgBuffer);
+						m_roomEditSession.edit(U"background") = Unicode::FromUTF8(bgBuffer);
 					}
 				}
 				ImGui::EndTabItem();
@@ -282,9 +270,9 @@ void EditorView::drawRoomEditorWindow(EditorController& controller)
 			//--------------------------------------------------------------------------
 			if (ImGui::BeginTabItem("Transitions"))
 			{
-				if (not m_editingRoomDataCopy.hasElement(U"transitions")) { m_editingRoomDataCopy[U"transitions"] = JSON(); }
 				String transitionToDelete = U"";
-				for (const auto& transPair : m_editingRoomDataCopy[U"transitions"])
+				const JSON transitions = m_roomEditSession.get(U"transitions");
+				for (const auto& transPair : transitions)
 				{
 					const auto& key = transPair.key;
 					const auto& value = transPair.value;
@@ -320,7 +308,7 @@ void EditorView::drawRoomEditorWindow(EditorController& controller)
 
 				if (not transitionToDelete.isEmpty())
 				{
-					m_editingRoomDataCopy[U"transitions"].erase(transitionToDelete);
+					m_roomEditSession.edit(U"transitions").erase(transitionToDelete);
 				}
 				ImGui::Separator();
 				if (ImGui::Button("Add Transition..."))
@@ -340,12 +328,12 @@ void EditorView::drawRoomEditorWindow(EditorController& controller)
 				// --- Forcusable Objects ---
 				ImGui::Text("Forcusable Objects");
 				ImGui::Separator();
-				if (not m_editingRoomDataCopy.hasElement(U"forcusables")) { m_editingRoomDataCopy[U"forcusables"] = Array<JSON>(); }
+				const JSON forcusables = m_roomEditSession.get(U"forcusables");
 
 				int focusableIndexToDelete = -1;
-				for (size_t i = 0; i < m_editingRoomDataCopy[U"forcusables"].size(); ++i)
+				for (size_t i = 0; i < forcusables.size(); ++i)
 				{
-					const auto& item = m_editingRoomDataCopy[U"forcusables"][i];
+					const auto& item = forcusables[i];
 					const String name = item[U"name"].getOpt<String>().value_or(U"");
 					ImGui::PushID(static_cast<int>(i) + 1000); // InteractableとIDが衝突しないようにオフセット
 					ImGui::BulletText(name.toUTF8().c_str());
@@ -355,7 +343,7 @@ void EditorView::drawRoomEditorWindow(EditorController& controller)
 					if (ImGui::SmallButton("Delete")) { focusableIndexToDelete = static_cast<int>(i); }
 					ImGui::PopID();
 				}
-				if (focusableIndexToDelete != -1) { m_editingRoomDataCopy[U"forcusables"].erase(focusableIndexToDelete); }
+				if (focusableIndexToDelete != -1) { m_roomEditSession.edit(U"forcusables", Array<JSON>()).erase(focusableIndexToDelete); }
 				if (ImGui::Button("Add Forcusable...")) { openForcusableEditor(-1); }
 
 				ImGui::Dummy(ImVec2(0.0f, 20.0f));
@@ -363,12 +351,12 @@ void EditorView::drawRoomEditorWindow(EditorController& controller)
 				// --- Interactable Objects ---
 				ImGui::Text("Interactable Objects");
 				ImGui::Separator();
-				if (not m_editingRoomDataCopy.hasElement(U"interactables")) { m_editingRoomDataCopy[U"interactables"] = Array<JSON>(); }
+				const JSON interactables = m_roomEditSession.get(U"interactables");
 
 				int interactableIndexToDelete = -1;
-				for (size_t i = 0; i < m_editingRoomDataCopy[U"interactables"].size(); ++i)
+				for (size_t i = 0; i < interactables.size(); ++i)
 				{
-					const auto& item = m_editingRoomDataCopy[U"interactables"][i];
+					const auto& item = interactables[i];
 					const String name = item[U"name"].getOpt<String>().value_or(U"");
 					ImGui::PushID(static_cast<int>(i));
 					ImGui::BulletText(name.toUTF8().c_str());
@@ -378,7 +366,7 @@ void EditorView::drawRoomEditorWindow(EditorController& controller)
 					if (ImGui::SmallButton("Delete")) { interactableIndexToDelete = static_cast<int>(i); }
 					ImGui::PopID();
 				}
-				if (interactableIndexToDelete != -1) { m_editingRoomDataCopy[U"interactables"].erase(interactableIndexToDelete); }
+				if (interactableIndexToDelete != -1) { m_roomEditSession.edit(U"interactables", Array<JSON>()).erase(interactableIndexToDelete); }
 				if (ImGui::Button("Add Interactable...")) { openInteractableEditor(-1); }
 
 				ImGui::EndTabItem();
@@ -392,8 +380,7 @@ void EditorView::drawRoomEditorWindow(EditorController& controller)
 		ImGui::Separator();
 		if (ImGui::Button("Apply & Save", ImVec2(120, 0)))
 		{
-			controller.updateRoomData(m_editingRoomName, m_editingRoomDataCopy);
-			controller.saveSelectedJson();
+			controller.applyRoomEdit(m_roomEditSession);
 			m_showRoomEditor = false;
 		}
 		ImGui::SameLine();
@@ -404,6 +391,12 @@ void EditorView::drawRoomEditorWindow(EditorController& controller)
 
 	}
 	ImGui::End();
+
+	// Apply せずに閉じた場合は、変更を捨てるだけ（文書には触れない）
+	if ((not m_showRoomEditor) && m_roomEditSession.isOpen())
+	{
+		m_roomEditSession.discard();
+	}
 }
 
 
@@ -415,72 +408,90 @@ void EditorView::drawMenuBar(EditorController& controller)
 		{
 			if (ImGui::MenuItem("New Dimension...")) { m_shouldShowNewDimensionPopup = true; }
 			if (ImGui::MenuItem("Open Dimension...")) { controller.openDimension(); }
-			if (ImGui::MenuItem("Save")) { controller.saveSelectedJson(); }
+			if (ImGui::MenuItem("Save", nullptr, false, (not controller.getModel().isReadOnly()))) { controller.saveSelectedJson(); }
+			if (ImGui::MenuItem("Save All", nullptr, false, (not controller.getModel().isReadOnly()) && (not controller.getDirtyPaths().isEmpty())))
+			{
+				controller.saveAll();
+			}
+
+			ImGui::Separator();
+
+			if (ImGui::MenuItem("Open Dimension Pack...")) { controller.openDimensionPack(); }
+			if (ImGui::MenuItem("Export Dimension Pack...", nullptr, false,
+				(controller.getModel().isDimensionLoaded() && (not controller.getModel().isReadOnly()))))
+			{
+				controller.exportDimensionPack();
+			}
+			if (ImGui::MenuItem("Unpack Dimension Pack...")) { controller.unpackDimensionPack(); }
 
 			ImGui::EndMenu();
 		}
-		ImGui::EndMainMenuBar();
-	}
-}
+		if (ImGui::BeginMenu("Edit"))
+		{
+			if (ImGui::MenuItem("Undo", "Ctrl+Z", false, controller.canUndo())) { controller.undo(); }
+			if (ImGui::MenuItem("Redo", "Ctrl+Y", false, controller.canRedo())) { controller.redo(); }
 
-void EditorView::drawHierarchyPanel(DimensionModel& model, EditorController& controller)
-{
-	ImGui::Begin("Hierarchy");
-	if (model.isDimensionLoaded())
-	{
-		// 第1階層: Dimension
-		const String& dimensionName = model.getDimensionName();
-		if (not dimensionName.isEmpty() && ImGui::TreeNode(dimensionName.toUTF8().c_str()))
+			ImGui::EndMenu();
+		}
+		if (ImGui::BeginMenu("Tools"))
 		{
-			const FilePath connectionsPath = model.getCurrentDimensionPath() + U"room_connections.json";
-			ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
-			if (connectionsPath == controller.getSelectedPath())
+			if (ImGui::MenuItem("Benchmark: Load Scaling", nullptr, false,
+				(controller.getModel().isDimensionLoaded() && (not controller.getModel().isReadOnly()))))
 			{
-				flags |= ImGuiTreeNodeFlags_Selected;
+				controller.runLoadBenchmark();
 			}
-			ImGui::TreeNodeEx("room_connections.json", flags);
-			if (ImGui::IsItemClicked())
+			if (ImGui::MenuItem("Benchmark: Metadata Scan", nullptr, false,
+				(controller.getModel().isDimensionLoaded() && (not controller.getModel().isReadOnly()))))
 			{
-				controller.setSelectedPath(connectionsPath);
+				controller.runMetadataBenchmark();
 			}
-
-			// 第2階層: Room
-			for (const auto& room : model.getRooms())
+			if (ImGui::MenuItem("Benchmark: JSON Writer", nullptr, false,
+				(FileSystem::Extension(controller.getSelectedPath()) == U"json") && (not controller.isSelectionLoading())))
 			{
-				if (room.name.isEmpty()) continue;
-
-				ImGuiTreeNodeFlags roomNodeFlags = ImGuiTreeNodeFlags_OpenOnArrow;
-				if (room.objects.isEmpty())
-				{
-					roomNodeFlags |= ImGuiTreeNodeFlags_Leaf;
-				}
+				controller.runWriterBenchmark();
+			}
+			if (ImGui::MenuItem("Benchmark: Synthetic Suite"))
+			{
+				controller.runSuiteBenchmark();
+			}
 
-				if (ImGui::TreeNodeEx(room.name.toUTF8().c_str(), roomNodeFlags))
-				{
-					// 第3階層: Object
-					for (const auto& object : room.objects)
-					{
-						if (object.fileName.isEmpty()) continue;
+			ImGui::Separator();
 
-						ImGuiTreeNodeFlags objectNodeFlags = ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+			const auto cacheStats = controller.getModel().getDocumentCacheStats();
+			ImGui::TextDisabled("Document Cache: %llu hits / %llu misses",
+				static_cast<unsigned long long>(cacheStats.hits), static_cast<unsigned long long>(cacheStats.misses));
+			ImGui::TextDisabled("  %zu files, %.1f / %.1f MB", cacheStats.entryCount,
+				(cacheStats.usedBytes / (1024.0 * 1024.0)), (cacheStats.budgetBytes / (1024.0 * 1024.0)));
+			if constexpr (Benchmark::CountsAllocations)
+			{
+				ImGui::TextDisabled("Inspector: %llu allocations / frame", static_cast<unsigned long long>(m_inspectorAllocationCount));
+			}
 
-						const FilePath objectPath = model.getCurrentDimensionPath() + U"/" + room.name + U"/" + object.fileName;
-						if (objectPath == controller.getSelectedPath())
-						{
-							objectNodeFlags |= ImGuiTreeNodeFlags_Selected;
-						}
+			ImGui::EndMenu();
+		}
+		ImGui::EndMainMenuBar();
+	}
+}
 
-						ImGui::TreeNodeEx(object.fileName.toUTF8().c_str(), objectNodeFlags);
-						if (ImGui::IsItemClicked())
-						{
-							controller.setSelectedPath(objectPath);
-						}
-					}
-					ImGui::TreePop();
-				}
+void EditorView::drawHierarchyPanel(DimensionModel& model, EditorController& controller)
+{
+	ImGui::Begin("Hierarchy");
+	if (model.isDimensionLoaded())
+	{
+		// 保存していない変更があるファイル
+		const Array<FilePath>& dirtyPaths = controller.getDirtyPaths();
+		if (not dirtyPaths.isEmpty())
+		{
+			ImGui::TextDisabled("%zu unsaved file(s)", dirtyPaths.size());
+			ImGui::SameLine();
+			if (ImGui::SmallButton("Save All"))
+			{
+				controller.saveAll();
 			}
-			ImGui::TreePop();
 		}
+
+		// 行とラベルはモデルの構成が変わったときだけ作り直し、見えている行だけを描画する
+		m_hierarchyPanel.draw(model, controller);
 	}
 
 	if (ImGui::IsMouseClicked(ImGuiMouseButton_Left) && ImGui::IsWindowHovered() && !ImGui::IsAnyItemHovered())
@@ -495,13 +506,15 @@ void EditorView::drawCanvasPanel(EditorController& controller)
 	ImGui::Begin("Canvas");
 	const FilePath& selectedPath = controller.getSelectedPath();
 
-	if (FileSystem::Extension(selectedPath) == U"json")
+	if (controller.isSelectionLoading())
 	{
-		const JSON& jsonData = controller.getSelectedJsonData();
-		if (not jsonData.isEmpty())
-		{
-			ImGui::TextUnformatted(jsonData.format(2).toUTF8().c_str());
-		}
+		ImGui::TextDisabled("Loading %s ...", FileSystem::FileName(selectedPath).toUTF8().c_str());
+	}
+	else if (FileSystem::Extension(selectedPath) == U"json")
+	{
+		// 整形したテキストは文書が変わったときだけ作り直し、見えている行だけを描画する
+		const std::shared_ptr<const EditorDocument> document = controller.getSelectedDocument();
+		m_jsonTextViewer.draw((document && (not document->getJson().isEmpty())) ? document : nullptr);
 	}
 	else
 	{
@@ -519,15 +532,36 @@ void EditorView::drawInspectorPanel(EditorController& controller)
 
 	if (selectedPath != m_lastSelectedPath)
 	{
-		m_currentDrawer = InspectorDrawerFactory::Create(FileSystem::BaseName(selectedPath));
+		m_currentDrawer = &m_drawerPool.get(selectedPath);
 		m_lastSelectedPath = selectedPath;
 	}
 
 	JSON& jsonData = controller.getSelectedJsonData();
 
-	if (m_currentDrawer && (not jsonData.isEmpty()))
+	if (controller.isSelectionLoading())
+	{
+		// 読み込みが終わるまでは編集UIを出さない
+		ImGui::TextDisabled("Loading %s ...", FileSystem::FileName(selectedPath).toUTF8().c_str());
+	}
+	else if (m_currentDrawer && (not jsonData.isEmpty()))
 	{
-		m_currentDrawer->draw(jsonData, *this, controller, model);
+		// 次元の検証で見つかった、この文書の問題
+		if (const auto& problems = controller.getValidator().getProblems(selectedPath); not problems.isEmpty())
+		{
+			for (const auto& problem : problems)
+			{
+				const ImVec4 color = ((problem.severity == SchemaProblem::Severity::Error) ? ImVec4(1.0f, 0.0f, 0.0f, 1.0f) : ImVec4(0.9f, 0.6f, 0.0f, 1.0f));
+				ImGui::TextColored(color, "%s: %s", (problem.path.isEmpty() ? "(root)" : problem.path.toUTF8().c_str()), problem.message.toUTF8().c_str());
+			}
+			ImGui::Separator();
+		}
+
+		{
+			// 描画での確保の回数（Instrument 構成でだけ数える。値を変更しないフレームでは 0 になる）
+			const Benchmark::AllocationScope allocations;
+			m_currentDrawer->draw(jsonData, *this, controller, model);
+			m_inspectorAllocationCount = allocations.count();
+		}
 
 		ImGui::Separator();
 		// "hotspots" プロパティを持つスキーマの場合のみボタンを表示
@@ -541,10 +575,28 @@ void EditorView::drawInspectorPanel(EditorController& controller)
 		}
 
 		ImGui::Separator();
-		if (ImGui::Button("Save Changes"))
+		if (ImGui::Button(controller.isSelectedDirty() ? "Save Changes *###SaveChanges" : "Save Changes###SaveChanges"))
 		{
 			controller.saveSelectedJson();
 		}
+
+		// 保存の状態（保存はバックグラウンドで行われる）
+		ImGui::SameLine();
+		if (model.isSavePending(selectedPath))
+		{
+			ImGui::TextDisabled("Saving...");
+		}
+		else if (const auto* result = controller.findSaveResult(selectedPath))
+		{
+			if (result->succeeded)
+			{
+				ImGui::TextDisabled("Saved");
+			}
+			else
+			{
+				ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "Save failed: %s", result->error.toUTF8().c_str());
+			}
+		}
 	}
 	else
 	{
@@ -553,6 +605,113 @@ void EditorView::drawInspectorPanel(EditorController& controller)
 	ImGui::End();
 }
 
+void EditorView::drawProblemsPanel(EditorController& controller)
+{
+	ImGui::Begin("Problems");
+
+	const DimensionValidator& validator = controller.getValidator();
+	const Array<DimensionProblem>& problems = validator.getProblems();
+
+	ImGui::Text("%zu error(s), %zu warning(s) in %zu file(s)", validator.getErrorCount(), validator.getWarningCount(), validator.getDocumentCount());
+	ImGui::SameLine();
+	if (validator.isRunning())
+	{
+		ImGui::TextDisabled("Validating...");
+	}
+	else if (const auto& pass = validator.getLastPass(); (pass.validatedCount + pass.skippedCount) != 0)
+	{
+		ImGui::TextDisabled("(last pass: %zu validated, %zu unchanged, %.1f ms, %zu thread(s))",
+			pass.validatedCount, pass.skippedCount, pass.millisec, pass.jobCount);
+	}
+
+	m_visibleProblemsDirty |= ImGui::Checkbox("Errors", &m_showProblemErrors);
+	ImGui::SameLine();
+	m_visibleProblemsDirty |= ImGui::Checkbox("Warnings", &m_showProblemWarnings);
+	ImGui::SameLine();
+	if (ImGui::Button("Revalidate"))
+	{
+		controller.revalidateAll();
+	}
+
+	// 表示する問題の一覧は、検証結果か表示条件が変わったときだけ作り直す
+	if (m_visibleProblemsDirty || (m_visibleProblemsRevision != validator.getRevision()))
+	{
+		m_visibleProblemIndices.clear();
+
+		for (size_t i = 0; i < problems.size(); ++i)
+		{
+			const bool isError = (problems[i].problem.severity == SchemaProblem::Severity::Error);
+
+			if (isError ? m_showProblemErrors : m_showProblemWarnings)
+			{
+				m_visibleProblemIndices.push_back(i);
+			}
+		}
+
+		m_visibleProblemsRevision = validator.getRevision();
+		m_visibleProblemsDirty = false;
+		m_selectedProblemIndex.reset();
+	}
+
+	const FilePath& dimensionPath = controller.getModel().getCurrentDimensionPath();
+
+	if (ImGui::BeginTable("ProblemList", 3, (ImGuiTableFlags_Resizable | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)))
+	{
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("File");
+		ImGui::TableSetupColumn("Location");
+		ImGui::TableSetupColumn("Message");
+		ImGui::TableHeadersRow();
+
+		// 数万件でも見えている行だけを描画する
+		ImGuiListClipper clipper;
+		clipper.Begin(static_cast<int>(m_visibleProblemIndices.size()));
+
+		while (clipper.Step())
+		{
+			for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+			{
+				const size_t index = m_visibleProblemIndices[row];
+				const DimensionProblem& problem = problems[index];
+				const bool isError = (problem.problem.severity == SchemaProblem::Severity::Error);
+
+				// 次元フォルダからの相対パスで表示する
+				StringView fileName = problem.filePath;
+				if (fileName.starts_with(dimensionPath))
+				{
+					fileName = fileName.substr(dimensionPath.size());
+				}
+				while (fileName.starts_with(U'/'))
+				{
+					fileName = fileName.substr(1);
+				}
+
+				ImGui::PushID(static_cast<int>(index));
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+
+				// 行をクリックしたら、その文書をインスペクタで開く
+				if (ImGui::Selectable(fileName.toUTF8().c_str(), (m_selectedProblemIndex == index), ImGuiSelectableFlags_SpanAllColumns))
+				{
+					m_selectedProblemIndex = index;
+					controller.setSelectedPath(problem.filePath);
+				}
+
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(problem.problem.path.isEmpty() ? "(root)" : problem.problem.path.toUTF8().c_str());
+
+				ImGui::TableNextColumn();
+				ImGui::TextColored((isError ? ImVec4(1.0f, 0.0f, 0.0f, 1.0f) : ImVec4(0.9f, 0.6f, 0.0f, 1.0f)), "%s", problem.problem.message.toUTF8().c_str());
+				ImGui::PopID();
+			}
+		}
+
+		ImGui::EndTable();
+	}
+
+	ImGui::End();
+}
+
 void EditorView::drawAddHotspotModal(EditorController& controller)
 {
 	if (ImGui::BeginPopupModal("Add New Hotspot", NULL, ImGuiWindowFlags_AlwaysAutoResize))
@@ -727,88 +886,6 @@ void EditorView::drawCustomActionEditor(ActionDraft& draft)
 	}
 }
 
-void EditorView::buildDraftFromActionJson(ActionDraft& draft, const JSON& json)
-{
-	if (not json.isObject()) return;
-
-	const String type = json[U"type"].getOpt<String>().value_or(U"");
-
-	if (type == U"ShowText")
-	{
-		draft.typeIndex = ActionType_ShowText;
-		draft.fileBuffer = json[U"file"].getOpt<String>().value_or(U"").toUTF8();
-	}
-	else if (type == U"GiveItem")
-	{
-		draft.typeIndex = ActionType_GiveItem;
-		draft.itemBuffer = json[U"item"].getOpt<String>().value_or(U"").toUTF8();
-	}
-	else if (type == U"SetFlag")
-	{
-		draft.typeIndex = ActionType_SetFlag;
-		draft.flagBuffer = json[U"flag"].getOpt<String>().value_or(U"").toUTF8();
-		draft.flagValue = json[U"value"].getOpt<bool>().value_or(false);
-	}
-	else if (type == U"Conditional")
-	{
-		draft.typeIndex = ActionType_Conditional;
-		if (json.hasElement(U"condition"))
-		{
-			const auto& cond = json[U"condition"];
-			if (cond[U"type"].getOpt<String>().value_or(U"") == U"HasItem")
-			{
-				draft.conditionTypeIndex = 0;
-				draft.conditionItemBuffer = cond[U"item"].getOpt<String>().value_or(U"").toUTF8();
-			}
-			else
-			{
-				draft.conditionTypeIndex = 1;
-				draft.conditionFlagBuffer = cond[U"flag"].getOpt<String>().value_or(U"").toUTF8();
-			}
-		}
-
-		if (json.hasElement(U"success"))
-		{
-			draft.successAction = std::make_unique<ActionDraft>();
-			buildDraftFromActionJson(*draft.successAction, json[U"success"]);
-		}
-		if (json.hasElement(U"failure"))
-		{
-			draft.failureAction = std::make_unique<ActionDraft>();
-			buildDraftFromActionJson(*draft.failureAction, json[U"failure"]);
-		}
-	}
-	else if (type == U"Sequence" || type == U"MultiStep")
-	{
-		draft.typeIndex = (type == U"Sequence") ? ActionType_Sequence : ActionType_MultiStep;
-		const String listKey = (type == U"Sequence") ? U"actions" : U"steps";
-
-		if (type == U"MultiStep")
-		{
-			draft.idBuffer = json[U"id"].getOpt<String>().value_or(U"").toUTF8();
-			if (json.hasElement(U"final_action"))
-			{
-				draft.finalAction = std::make_unique<ActionDraft>();
-				buildDraftFromActionJson(*draft.finalAction, json[U"final_action"]);
-			}
-		}
-
-		if (json.hasElement(listKey))
-		{
-			for (const auto& action : json[listKey])
-			{
-				auto subDraft = std::make_unique<ActionDraft>();
-				buildDraftFromActionJson(*subDraft, action);
-				draft.actionList.push_back(std::move(subDraft));
-			}
-		}
-	}
-	else if (type == U"ChangeDimension")
-	{
-		draft.typeIndex = ActionType_ChangeDimension;
-		draft.targetDimensionBuffer = json[U"target"].getOpt<String>().value_or(U"").toUTF8();
-	}
-}
 
 void EditorView::drawGridSelectorWindow(EditorController& controller)
 {
@@ -971,12 +1048,12 @@ void EditorView::drawAddTransitionWindow(EditorController& controller)
 				if (isComplex)
 				{
 					// conditionやgrid_posが指定された場合は、オブジェクトとして保存
-					m_editingRoomDataCopy[U"transitions"][direction] = transitionObj;
+					m_roomEditSession.edit(U"transitions")[direction] = transitionObj;
 				}
 				else
 				{
 					// それ以外の場合は、単純な文字列として保存
-					m_editingRoomDataCopy[U"transitions"][direction] = to;
+					m_roomEditSession.edit(U"transitions")[direction] = to;
 				}
 			}
 			m_showAddTransitionWindow = false;
@@ -995,19 +1072,19 @@ void EditorView::openForcusableEditor(int index)
 	else {
 		m_isEditingForcusable = true;
 		m_editingForcusableIndex = index;
-		const auto& item = m_editingRoomDataCopy[U"forcusables"][index];
-		m_forcusableDraftState.nameBuffer = item[U"name"].getOpt<String>().value_or(U"").toUTF8();
-		m_forcusableDraftState.defaultStateDraft.assetBuffer = item[U"default_state"][U"asset"].getOpt<String>().value_or(U"").toUTF8();
-		m_forcusableDraftState.hotspotGridPosBuffer = item[U"hotspot"][U"grid_pos"].getOpt<String>().value_or(U"").toUTF8();
+		const FocusableData item = TypedObjects::BindFocusable(m_roomEditSession.get(U"forcusables")[index]).value_or(FocusableData{});
+		m_forcusableDraftState.nameBuffer = item.name.toUTF8();
+		m_forcusableDraftState.defaultStateDraft.assetBuffer = item.defaultState.asset.toUTF8();
+		m_forcusableDraftState.hotspotGridPosBuffer = item.hotspot.gridPos.toUTF8();
 
 		m_forcusableDraftState.states.clear();
-		if (item.hasElement(U"states"))
+		if (item.states)
 		{
-			for (const auto& stateJson : item[U"states"].arrayView())
+			for (const auto& state : *item.states)
 			{
 				ConditionalStateDraft stateDraft;
-				stateDraft.conditionFlagBuffer = stateJson[U"condition_flag"].getOpt<String>().value_or(U"").toUTF8();
-				stateDraft.assetBuffer = stateJson[U"asset"].getOpt<String>().value_or(U"").toUTF8();
+				stateDraft.conditionFlagBuffer = state.conditionFlag.toUTF8();
+				stateDraft.assetBuffer = state.asset.toUTF8();
 				m_forcusableDraftState.states.push_back(stateDraft);
 			}
 		}
@@ -1065,10 +1142,10 @@ void EditorView::drawForcusableEditorWindow(EditorController& controller)
 		ImGui::Separator();
 		if (ImGui::Button("OK")) {
 			if (m_isEditingForcusable) {
-				controller.updateFocusable(m_editingRoomDataCopy, m_editingForcusableIndex, m_forcusableDraftState);
+				controller.updateFocusable(m_roomEditSession, m_editingForcusableIndex, m_forcusableDraftState);
 			}
 			else {
-				controller.addNewFocusable(m_editingRoomName, m_editingRoomDataCopy, m_forcusableDraftState);
+				controller.addNewFocusable(m_roomEditSession, m_forcusableDraftState);
 			}
 			show_flag = false;
 		}
@@ -1144,10 +1221,10 @@ void EditorView::drawInteractableEditorWindow(EditorController& controller)
 		if (ImGui::Button("OK", ImVec2(120, 0))) {
 			if (not m_interactableDraftState.nameBuffer.empty()) {
 				if (m_isEditingInteractable) {
-					controller.updateInteractable(m_editingRoomDataCopy, m_editingInteractableIndex, m_interactableDraftState);
+					controller.updateInteractable(m_roomEditSession, m_editingInteractableIndex, m_interactableDraftState);
 				}
 				else {
-					controller.addNewInteractable(m_editingRoomDataCopy, m_interactableDraftState);
+					controller.addNewInteractable(m_roomEditSession, m_interactableDraftState);
 				}
 			}
 			show_flag = false;
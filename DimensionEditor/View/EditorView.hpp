@@ -1,8 +1,11 @@
 ﻿#pragma once
-#include "Inspector/InspectorDrawerFactory.hpp"
+#include "Inspector/InspectorDrawerPool.hpp"
+#include "JsonTextViewer.hpp"
+#include "HierarchyPanel.hpp"
 #include "../ImGuiHelpers.hpp"
 #include "../Controller/EditorDrafts.hpp"
 #include "../SchemaManager.hpp"
+#include "../Model/RoomEditSession.hpp"
 
 class DimensionModel;
 class EditorController;
@@ -13,9 +16,8 @@ public:
 	EditorView();
 	void draw(DimensionModel& model, EditorController& controller);
 
-	// 部屋編集モーダルの状態
-	JSON m_editingRoomDataCopy;
-	String m_editingRoomName;
+	// 部屋編集モーダルの状態（部屋の内容は複製せず、変更だけをセッションに持つ）
+	RoomEditSession m_roomEditSession;
 	bool m_showRoomEditor = false;
 
 private:
@@ -27,6 +29,8 @@ private:
 
 	void drawInspectorPanel(EditorController& controller);
 
+	void drawProblemsPanel(EditorController& controller);
+
 	void drawAddHotspotModal(EditorController& controller);
 
 	void openInteractableEditor(int index=-1);
@@ -37,8 +41,6 @@ private:
 
 	void drawCustomActionEditor(ActionDraft& draft);
 
-	void buildDraftFromActionJson(ActionDraft& draft, const JSON& json);
-
 	void drawGridSelectorWindow(EditorController& controller);
 
 	void drawAddTransitionWindow(EditorController& controller);
@@ -78,7 +80,20 @@ private:
 	std::string m_newDimensionNameBuffer = "dimension";
 	bool m_shouldOpenAddHotspotModal = false;
 	HotspotDraftState m_hotspotDraftState;
-	std::unique_ptr<IInspectorDrawer> m_currentDrawer;
+	// 文書の種類ごとの描画（選択が変わっても作り直さず、選択中の文書の描画を指す）
+	InspectorDrawerPool m_drawerPool;
+
+	// Canvas パネルの JSON の表示（整形したテキストと行の位置をキャッシュする）
+	JsonTextViewer m_jsonTextViewer;
+
+	// 階層パネルの木（行とラベルをキャッシュし、見えている行だけを描画する）
+	HierarchyPanel m_hierarchyPanel;
+
+	IInspectorDrawer* m_currentDrawer = nullptr;
+
+	// 直近のフレームでインスペクタの描画が行った確保の回数（Tools メニューに表示する）
+	uint64 m_inspectorAllocationCount = 0;
+
 	FilePath m_lastSelectedPath;
 
 	bool m_shouldShowInteractablePopup = false;
@@ -104,4 +119,12 @@ private:
 
 	bool m_showAddForcusableWindow = false;
 	bool m_showEditForcusableWindow = false;
+
+	// Problems パネルの表示条件と、条件に合う問題（検証結果のインデックス）
+	bool m_showProblemErrors = true;
+	bool m_showProblemWarnings = true;
+	Array<size_t> m_visibleProblemIndices;
+	uint64 m_visibleProblemsRevision = 0;
+	bool m_visibleProblemsDirty = true;
+	Optional<size_t> m_selectedProblemIndex;
 };
@@ -0,0 +1,315 @@
+﻿#include "HierarchyPanel.hpp"
+#include "../imgui-s3d-wrapper/imgui/DearImGuiAddon.hpp"
+#include "../Model/DimensionModel.hpp"
+#include "../Controller/EditorController.hpp"
+
+namespace
+{
+	// 番号を ImGui の ID にする（ラベルの文字列を ID に使わない）
+	const void* ToImGuiId(const uint32 id) noexcept
+	{
+		return reinterpret_cast<const void*>(static_cast<uintptr_t>(id));
+	}
+
+	std::string MakeSummary(const ObjectMetadata& metadata)
+	{
+		if (metadata.name.isEmpty() && metadata.type.isEmpty() && (not metadata.hotspotCount))
+		{
+			return{};
+		}
+
+		String summary = metadata.name;
+		if (not metadata.type.isEmpty())
+		{
+			summary += U" [{}]"_fmt(metadata.type.str());
+		}
+		if (metadata.hotspotCount)
+		{
+			summary += U" ({} hotspots)"_fmt(*metadata.hotspotCount);
+		}
+
+		return summary.toUTF8();
+	}
+}
+
+void HierarchyPanel::draw(DimensionModel& model, EditorController& controller)
+{
+	const bool rebuilt = (m_revision != model.getRevision());
+
+	if (rebuilt)
+	{
+		rebuild(model);
+	}
+
+	// 概要が破棄されたオブジェクトは、次に表示するときに作り直す
+	if (m_metadataRevision != model.getMetadataRevision())
+	{
+		for (auto& entry : m_entries)
+		{
+			entry.hasSummary = false;
+		}
+
+		m_metadataRevision = model.getMetadataRevision();
+	}
+
+	if (controller.getSelectedPath() != m_selectedPath)
+	{
+		m_selectedPath = controller.getSelectedPath();
+		m_selectedId = findId(model, m_selectedPath);
+	}
+
+	// 作り直した場合は行の番号が変わるので、一覧が同じでも引き直す
+	if (rebuilt || (controller.getDirtyPathsRevision() != m_dirtyPathsRevision))
+	{
+		m_dirtyPathsRevision = controller.getDirtyPathsRevision();
+		updateDirtyIds(model, controller.getDirtyPaths());
+	}
+
+	// 第1階層: Dimension
+	if (m_dimensionLabel.empty() || (not ImGui::TreeNode(m_dimensionLabel.c_str())))
+	{
+		return;
+	}
+
+	{
+		ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+		if (m_selectedId == ConnectionsId)
+		{
+			flags |= ImGuiTreeNodeFlags_Selected;
+		}
+		ImGui::TreeNodeEx(ToImGuiId(ConnectionsId), flags, (isDirty(ConnectionsId) ? "%s *" : "%s"), "room_connections.json");
+		if (ImGui::IsItemClicked())
+		{
+			controller.setSelectedPath(m_connectionsPath);
+		}
+	}
+
+	// 第2階層: Room, 第3階層: Object（1列に並べた行のうち、見えている行だけを描画する）
+	Optional<size_t> toggledEntryIndex;
+
+	ImGuiListClipper clipper;
+	clipper.Begin(static_cast<int>(m_rows.size()));
+
+	while (clipper.Step())
+	{
+		for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+		{
+			const size_t entryIndex = m_rows[row];
+			Entry& entry = m_entries[entryIndex];
+			const uint32 id = EntryId(entryIndex);
+
+			if (entry.isRoom())
+			{
+				const bool isEmpty = (((entryIndex + 1) == m_entries.size()) || m_entries[entryIndex + 1].isRoom());
+
+				// 子の行は自分で並べるので、木のインデントは積まない
+				ImGuiTreeNodeFlags roomNodeFlags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+				if (isEmpty)
+				{
+					roomNodeFlags |= ImGuiTreeNodeFlags_Leaf;
+				}
+
+				ImGui::SetNextItemOpen(entry.isOpen, ImGuiCond_Always);
+				const bool isOpen = ImGui::TreeNodeEx(ToImGuiId(id), roomNodeFlags, "%s", entry.label.c_str());
+
+				if ((not isEmpty) && (isOpen != entry.isOpen))
+				{
+					toggledEntryIndex = entryIndex;
+				}
+
+				continue;
+			}
+
+			ImGui::Indent();
+
+			ImGuiTreeNodeFlags objectNodeFlags = ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+			if (m_selectedId == id)
+			{
+				objectNodeFlags |= ImGuiTreeNodeFlags_Selected;
+			}
+
+			// 保存していない変更があれば "*" を付ける（ID は番号なので変わらない）
+			ImGui::TreeNodeEx(ToImGuiId(id), objectNodeFlags, (isDirty(id) ? "%s *" : "%s"), entry.label.c_str());
+			if (ImGui::IsItemClicked())
+			{
+				controller.setSelectedPath(getObjectPath(model, entry));
+			}
+
+			// 名前・種類・hotspot 数（表示した行のオブジェクトだけ、先頭レベルを読んで取得する）
+			if (not entry.hasSummary)
+			{
+				entry.summary = MakeSummary(model.getObjectMetadata(entry.roomIndex, entry.objectIndex));
+				entry.hasSummary = true;
+			}
+
+			if (not entry.summary.empty())
+			{
+				ImGui::SameLine();
+				ImGui::TextDisabled("%s", entry.summary.c_str());
+			}
+
+			ImGui::Unindent();
+		}
+	}
+
+	clipper.End();
+	ImGui::TreePop();
+
+	if (toggledEntryIndex)
+	{
+		Entry& room = m_entries[*toggledEntryIndex];
+		room.isOpen = (not room.isOpen);
+
+		const String& roomName = model.getRooms()[room.roomIndex].name;
+		if (room.isOpen)
+		{
+			m_openRooms.insert(roomName);
+		}
+		else
+		{
+			m_openRooms.erase(roomName);
+		}
+
+		updateRows();
+	}
+}
+
+void HierarchyPanel::rebuild(const DimensionModel& model)
+{
+	const Array<RoomModel>& rooms = model.getRooms();
+	const FilePath& dimensionPath = model.getCurrentDimensionPath();
+
+	m_dimensionLabel = model.getDimensionName().toUTF8();
+	m_connectionsPath = (dimensionPath + U"room_connections.json");
+
+	size_t entryCount = rooms.size();
+	for (const auto& room : rooms)
+	{
+		entryCount += room.objects.size();
+	}
+
+	m_entries.clear();
+	m_entries.reserve(entryCount);
+	m_rooms.clear();
+	m_rooms.reserve(rooms.size());
+
+	for (size_t roomIndex = 0; roomIndex < rooms.size(); ++roomIndex)
+	{
+		const RoomModel& room = rooms[roomIndex];
+
+		if (room.name.isEmpty())
+		{
+			m_rooms.emplace_back();
+			continue;
+		}
+
+		// 従来の階層パネルと同じ形式のパス（EditorController が文書を区別するキーになる）
+		m_rooms.push_back({ .pathPrefix = (dimensionPath + U"/" + room.name + U"/"), .entryIndex = m_entries.size() });
+		m_entries.push_back({ .roomIndex = static_cast<uint32>(roomIndex), .label = room.name.toUTF8(), .isOpen = m_openRooms.contains(room.name) });
+
+		for (size_t objectIndex = 0; objectIndex < room.objects.size(); ++objectIndex)
+		{
+			const FocusableObjectModel& object = room.objects[objectIndex];
+
+			if (object.fileName.isEmpty())
+			{
+				continue;
+			}
+
+			m_entries.push_back({ .roomIndex = static_cast<uint32>(roomIndex), .objectIndex = static_cast<uint32>(objectIndex), .label = object.fileName.toUTF8() });
+		}
+	}
+
+	m_revision = model.getRevision();
+	m_metadataRevision = model.getMetadataRevision();
+
+	// 行の番号が変わるので、選択を引き直す（未保存の印は draw() で引き直す）
+	m_selectedId = findId(model, m_selectedPath);
+	updateRows();
+}
+
+void HierarchyPanel::updateRows()
+{
+	m_rows.clear();
+
+	bool isRoomOpen = false;
+
+	for (size_t entryIndex = 0; entryIndex < m_entries.size(); ++entryIndex)
+	{
+		const Entry& entry = m_entries[entryIndex];
+
+		if (entry.isRoom())
+		{
+			isRoomOpen = entry.isOpen;
+		}
+		else if (not isRoomOpen)
+		{
+			continue;
+		}
+
+		m_rows.push_back(static_cast<uint32>(entryIndex));
+	}
+}
+
+Optional<uint32> HierarchyPanel::findId(const DimensionModel& model, const FilePath& path) const
+{
+	if (path.isEmpty())
+	{
+		return none;
+	}
+
+	if (path == m_connectionsPath)
+	{
+		return ConnectionsId;
+	}
+
+	// 部屋はパスの前半で、オブジェクトはその部屋の中のファイル名で探す（選択が変わったときだけ呼ぶ）
+	for (const auto& room : m_rooms)
+	{
+		if (room.pathPrefix.isEmpty() || (not path.starts_with(room.pathPrefix)))
+		{
+			continue;
+		}
+
+		const StringView fileName = StringView{ path }.substr(room.pathPrefix.size());
+
+		for (size_t entryIndex = (room.entryIndex + 1); (entryIndex < m_entries.size()) && (not m_entries[entryIndex].isRoom()); ++entryIndex)
+		{
+			const Entry& entry = m_entries[entryIndex];
+
+			if (StringView{ model.getRooms()[entry.roomIndex].objects[entry.objectIndex].fileName } == fileName)
+			{
+				return EntryId(entryIndex);
+			}
+		}
+
+		return none;
+	}
+
+	return none;
+}
+
+void HierarchyPanel::updateDirtyIds(const DimensionModel& model, const Array<FilePath>& dirtyPaths)
+{
+	m_dirtyIds.clear();
+
+	for (const auto& path : dirtyPaths)
+	{
+		if (const auto id = findId(model, path))
+		{
+			m_dirtyIds.push_back(*id);
+		}
+	}
+
+	m_dirtyIds.sort();
+}
+
+bool HierarchyPanel::isDirty(const uint32 id) const
+{
+	return std::binary_search(m_dirtyIds.begin(), m_dirtyIds.end(), id);
+}
+
+FilePath HierarchyPanel::getObjectPath(const DimensionModel& model, const Entry& entry) const
+{
+	return (m_rooms[entry.roomIndex].pathPrefix + model.getRooms()[entry.roomIndex].objects[entry.objectIndex].fileName);
+}
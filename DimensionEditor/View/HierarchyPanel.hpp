@@ -0,0 +1,102 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+
+class DimensionModel;
+class EditorController;
+
+// 階層パネルの木（次元 / room_connections.json / 部屋 / オブジェクト）
+// ・部屋とオブジェクトを1列に並べた行と、UTF-8 のラベルを、モデルの構成が変わったときだけ作り直す
+// ・行は番号（ImGui の ID を兼ねる）で区別し、選択や未保存の印は番号で比べる（フレームごとにパスを作らない）
+// ・ImGuiListClipper で見えている行だけを描画するので、オブジェクトが何万あっても描画のコストは変わらない
+class HierarchyPanel
+{
+public:
+	// 未保存の印は EditorController::getDirtyPaths() の一覧が変わったときだけ作り直す
+	void draw(DimensionModel& model, EditorController& controller);
+
+private:
+	// room_connections.json の番号（部屋とオブジェクトは 1 から）
+	static constexpr uint32 ConnectionsId = 0;
+
+	static constexpr uint32 NoObject = UINT32_MAX;
+
+	// 部屋かオブジェクト1つ
+	struct Entry
+	{
+		uint32 roomIndex = 0;
+
+		// 部屋なら NoObject
+		uint32 objectIndex = NoObject;
+
+		std::string label;
+
+		// オブジェクトの概要（名前・種類・hotspot 数）。初めて表示するときに作る
+		std::string summary;
+
+		bool hasSummary = false;
+
+		// 部屋を開いているか
+		bool isOpen = false;
+
+		[[nodiscard]]
+		bool isRoom() const noexcept { return (objectIndex == NoObject); }
+	};
+
+	// m_entries の位置の行の番号（選択と ImGui の ID に使う）
+	[[nodiscard]]
+	static uint32 EntryId(const size_t entryIndex) noexcept { return static_cast<uint32>(entryIndex + 1); }
+
+	// 部屋ごとの、オブジェクトのパスの前半（オブジェクトのパスはクリックしたときだけ作る）
+	struct RoomInfo
+	{
+		// 名前が空の部屋は表示しないので空
+		FilePath pathPrefix;
+
+		// m_entries での部屋の行の位置
+		size_t entryIndex = 0;
+	};
+
+	Optional<uint64> m_revision;
+
+	uint64 m_metadataRevision = 0;
+
+	std::string m_dimensionLabel;
+
+	FilePath m_connectionsPath;
+
+	Array<Entry> m_entries;
+
+	Array<RoomInfo> m_rooms;
+
+	// 表示する行（m_entries の位置。閉じた部屋のオブジェクトは含まない）
+	Array<uint32> m_rows;
+
+	// 開いている部屋の名前（構成が変わって作り直しても、開閉の状態を残す）
+	HashSet<String> m_openRooms;
+
+	// 選択中の文書のパスと、その番号
+	FilePath m_selectedPath;
+
+	Optional<uint32> m_selectedId;
+
+	// 保存していない変更がある文書の番号（昇順）と、作り直したときの EditorController::getDirtyPathsRevision()
+	Array<uint32> m_dirtyIds;
+
+	uint64 m_dirtyPathsRevision = 0;
+
+	void rebuild(const DimensionModel& model);
+
+	void updateRows();
+
+	// path の文書の番号（階層にない文書なら none）
+	[[nodiscard]]
+	Optional<uint32> findId(const DimensionModel& model, const FilePath& path) const;
+
+	void updateDirtyIds(const DimensionModel& model, const Array<FilePath>& dirtyPaths);
+
+	[[nodiscard]]
+	bool isDirty(uint32 id) const;
+
+	[[nodiscard]]
+	FilePath getObjectPath(const DimensionModel& model, const Entry& entry) const;
+};
@@ -1,25 +1,33 @@
 ﻿#include "GenericDrawer.hpp"
 #include "../../imgui-s3d-wrapper/imgui/DearImGuiAddon.hpp"
-#include "InspectorDrawerUtils.hpp"
 #include "../EditorView.hpp"
+#include "../../Controller/EditorController.hpp"
+#include "../../Model/EditorDocument.hpp"
 
-void GenericDrawer::draw(JSON& jsonData, EditorView&, EditorController&, DimensionModel&)
+void GenericDrawer::draw(JSON& jsonData, EditorView&, EditorController& controller, DimensionModel&)
 {
 	if (ImGui::CollapsingHeader("Generic Properties", ImGuiTreeNodeFlags_DefaultOpen))
 	{
-		if (jsonData.isObject())
+		const std::shared_ptr<const EditorDocument> document = controller.getSelectedDocument();
+
+		if (document && document->getRoot() && (document->getRoot()->type == JSONValueType::Object))
 		{
-			Array<String> keys;
-			for (const auto& pair : jsonData)
+			// 読むのは文書の変更できない木、書き込むのは文書の JSON（キーの一覧や値の複製は作らない）
+			const PersistentJson::NodePtr root = document->getRoot();
+			m_cache.begin(document, jsonData);
+
+			for (const auto& [key, child] : root->members)
 			{
-				keys.push_back(pair.key);
+				ImGui::PushID(static_cast<int>(key.id()));
+				m_cache.pushKey(key);
+				DrawJsonValueEditor(m_cache.getLabel(key), child, nullptr, m_cache);
+				m_cache.pop();
+				ImGui::PopID();
 			}
 
-			for (const auto& key : keys)
+			if (const auto path = m_cache.takeChangedPath())
 			{
-				JSON valueCopy = jsonData[key];
-				DrawJsonValueEditor(key, valueCopy, nullptr);
-				jsonData[key] = valueCopy;
+				controller.markSelectedDirty(*path);
 			}
 		}
 	}
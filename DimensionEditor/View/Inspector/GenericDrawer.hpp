@@ -1,8 +1,11 @@
 ﻿#pragma once
 #include "IInspectorDrawer.hpp"
+#include "InspectorDrawerUtils.hpp"
 
 class GenericDrawer : public IInspectorDrawer
 {
 public:
 	void draw(JSON& jsonData, EditorView&, EditorController&, DimensionModel&) override;
+private:
+	JsonEditorCache m_cache;
 };
@@ -0,0 +1,48 @@
+﻿#include "InspectorDrawerPool.hpp"
+
+namespace
+{
+	// FileSystem::BaseName と同じ部分（ディレクトリと拡張子を除いた名前）を、文字列を作らずに path の中から取り出す
+	StringView BaseNameView(const FilePathView path)
+	{
+		std::u32string_view name = path.view();
+
+		if (const size_t slash = name.find_last_of(U"/\\"); slash != std::u32string_view::npos)
+		{
+			name.remove_prefix(slash + 1);
+		}
+
+		if (const size_t dot = name.rfind(U'.'); dot != std::u32string_view::npos)
+		{
+			name = name.substr(0, dot);
+		}
+
+		return StringView{ name.data(), name.size() };
+	}
+}
+
+InspectorDrawerPool::InspectorDrawerPool()
+{
+	// 文書のスキーマは十数個なので、すべて最初に作る
+	for (const auto& schema : SchemaRegistry::DocumentSchemas())
+	{
+		m_schemaDrawers.push_back(std::make_unique<SchemaDrivenDrawer>(schema));
+	}
+}
+
+IInspectorDrawer& InspectorDrawerPool::get(const FilePathView path)
+{
+	const StringView baseName = BaseNameView(path);
+
+	if (baseName == U"room_connections")
+	{
+		return m_roomConnectionsDrawer;
+	}
+
+	if (const CompiledSchema* schema = SchemaRegistry::Find(baseName))
+	{
+		return *m_schemaDrawers[schema->handle];
+	}
+
+	return m_genericDrawer;
+}
@@ -0,0 +1,25 @@
+﻿#pragma once
+#include "IInspectorDrawer.hpp"
+#include "SchemaDrivenDrawer.hpp"
+#include "GenericDrawer.hpp"
+#include "RoomConnectionsDrawer.hpp"
+
+// 文書の種類ごとのインスペクタの描画を持つ
+// すべての描画を最初に作っておき、選択が変わっても作り直さない（選択を切り替えるたびの確保をなくす）
+class InspectorDrawerPool
+{
+public:
+	InspectorDrawerPool();
+
+	// ファイルのパスに対応する描画（スキーマのない文書は GenericDrawer）
+	[[nodiscard]]
+	IInspectorDrawer& get(FilePathView path);
+
+private:
+	// SchemaRegistry::DocumentSchemas() の順
+	Array<std::unique_ptr<SchemaDrivenDrawer>> m_schemaDrawers;
+
+	RoomConnectionsDrawer m_roomConnectionsDrawer;
+
+	GenericDrawer m_genericDrawer;
+};
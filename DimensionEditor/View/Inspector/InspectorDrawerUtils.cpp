@@ -1,115 +1,216 @@
 ﻿#include "InspectorDrawerUtils.hpp"
-#include "../../SchemaManager.hpp"
-#include "../../imgui-s3d-wrapper/imgui/DearImGuiAddon.hpp"
+#include "../../ImGuiHelpers.hpp"
+#include "../../Model/EditorDocument.hpp"
+#include "../../Model/SchemaRegistry.hpp"
+#include "../../Model/TemplateService.hpp"
+
+void JsonEditorCache::begin(const std::shared_ptr<const EditorDocument>& document, JSON& json)
+{
+	m_json = &json;
+	m_path.clear();
+
+	const bool isSameDocument = ((not m_document.owner_before(document)) && (not document.owner_before(m_document)));
+	const uint64 revision = (document ? document->getRevision() : 0);
+
+	if (isSameDocument && (revision == m_revision))
+	{
+		return;
+	}
+
+	m_document = document;
+	m_revision = revision;
+	m_texts.clear();
+}
+
+Optional<PersistentJson::Path> JsonEditorCache::takeChangedPath()
+{
+	return std::exchange(m_changedPath, none);
+}
+
+void JsonEditorCache::pushKey(const Atom key)
+{
+	m_path.emplace_back(key);
+}
+
+void JsonEditorCache::pushIndex(const size_t index)
+{
+	m_path.emplace_back(index);
+}
+
+void JsonEditorCache::pop()
+{
+	m_path.pop_back();
+}
+
+void JsonEditorCache::assign(const Optional<JSON>& value)
+{
+	// 変更したフレームだけ、文字列のキーを持つ Path を作る
+	PersistentJson::Path path;
+	path.reserve(m_path.size());
+
+	for (const auto& element : m_path)
+	{
+		if (const Atom* key = std::get_if<Atom>(&element))
+		{
+			path.emplace_back(String{ key->str() });
+		}
+		else
+		{
+			path.emplace_back(std::get<size_t>(element));
+		}
+	}
+
+	if (m_json)
+	{
+		PersistentJson::AssignJSON(*m_json, path, value);
+	}
+
+	if (not m_changedPath)
+	{
+		m_changedPath = std::move(path);
+		return;
+	}
+
+	// 2つ目の位置を変更したら、両方を含む位置にまとめる
+	size_t common = 0;
+
+	while ((common < m_changedPath->size()) && (common < path.size()) && ((*m_changedPath)[common] == path[common]))
+	{
+		++common;
+	}
+
+	m_changedPath->resize(common);
+}
+
+std::string& JsonEditorCache::getText(const uint32 id, const PersistentJson::Node& node)
+{
+	auto it = m_texts.find(id);
+
+	if (it == m_texts.end())
+	{
+		it = m_texts.emplace(id, PersistentJson::GetString(node).toUTF8()).first;
+	}
+
+	return it->second;
+}
+
+const char* JsonEditorCache::getLabel(const Atom key)
+{
+	auto it = m_labels.find(key);
+
+	if (it == m_labels.end())
+	{
+		it = m_labels.emplace(key, key.str().toUTF8()).first;
+	}
+
+	return it->second.c_str();
+}
 
 // JSONの値を編集するためのUIを描画する、再帰的なヘルパー関数
-void DrawJsonValueEditor(const String& label, JSON& jsonValue, const std::shared_ptr<Schema>& childSchemaHint)
+bool DrawJsonValueEditor(const char* label, const PersistentJson::NodePtr& node, const CompiledSchema* childSchemaHint, JsonEditorCache& cache)
 {
-	ImGui::PushID(label.narrow().c_str());
+	if (not node)
+	{
+		return false;
+	}
 
-	switch (jsonValue.getType())
+	bool changed = false;
+
+	switch (node->type)
 	{
 	case JSONValueType::String:
 	{
-		char buffer[1024];
-		strcpy_s(buffer, jsonValue.getOr<String>(U"").toUTF8().c_str());
-		if (ImGui::InputText(label.toUTF8().c_str(), buffer, std::size(buffer)))
+		// 長さの制限はない（入力欄が std::string を直接伸ばす）
+		std::string& text = cache.getText(ImGui::GetID(label), *node);
+		if (ImGui::InputText(label, &text))
 		{
-			jsonValue = Unicode::FromUTF8(buffer);
+			cache.assign(JSON(Unicode::FromUTF8(text)));
+			changed = true;
 		}
 		break;
 	}
 	case JSONValueType::Number:
 	{
-		double value = jsonValue.getOr<double>(0.0);
-		if (ImGui::InputDouble(label.toUTF8().c_str(), &value))
+		double value = PersistentJson::GetNumber(*node).value_or(0.0);
+		if (ImGui::InputDouble(label, &value))
 		{
-			jsonValue = value;
+			cache.assign(JSON(value));
+			changed = true;
 		}
 		break;
 	}
 	case JSONValueType::Bool:
 	{
-		bool value = jsonValue.getOr<bool>(false);
-		if (ImGui::Checkbox(label.toUTF8().c_str(), &value))
+		const bool* current = std::get_if<bool>(&node->scalar);
+		bool value = (current && *current);
+		if (ImGui::Checkbox(label, &value))
 		{
-			jsonValue = value;
+			cache.assign(JSON(value));
+			changed = true;
 		}
 		break;
 	}
 	case JSONValueType::Array:
 	{
-		if (ImGui::TreeNode(label.toUTF8().c_str()))
+		if (ImGui::TreeNode(label))
 		{
-			int32 removeIndex = -1;
+			Optional<size_t> removeIndex;
 
-			for (auto&& [i, element] : IndexedRef(jsonValue.arrayView()))
+			for (size_t i = 0; i < node->elements.size(); ++i)
 			{
-				String elementLabel = label + U"[" + ToString(i) + U"]";
+				const PersistentJson::NodePtr& element = node->elements[i];
 
 				ImGui::PushID(static_cast<int>(i));
+				cache.pushIndex(i);
 
-				if (ImGui::Button("-")) { removeIndex = static_cast<int32>(i); }
+				if (ImGui::Button("-")) { removeIndex = i; }
 				ImGui::SameLine();
 
-				if (ImGui::TreeNode(elementLabel.toUTF8().c_str()))
+				// 要素の見出しは書式で渡す（ID は PushID の添字で区別する）
+				if (ImGui::TreeNode("##element", "%s[%zu]", label, i))
 				{
-					if (childSchemaHint && element.isObject())
+					if (childSchemaHint && element && (element->type == JSONValueType::Object))
 					{
 						ImGui::Indent();
-						for (const auto& childPair : *childSchemaHint)
+						for (const auto& childProp : childSchemaHint->fields)
 						{
-							const String& childKey = childPair.first;
-							const SchemaProperty& childProp = childPair.second;
-							if (element.hasElement(childKey))
+							if (const PersistentJson::NodePtr child = PersistentJson::GetMember(element, childProp.atom))
 							{
-								JSON valueCopy = element[childKey];
-								DrawJsonValueEditor(childProp.description, valueCopy, childProp.childSchema);
-								element[childKey] = valueCopy;
+								ImGui::PushID(static_cast<int>(childProp.atom.id()));
+								cache.pushKey(childProp.atom);
+								changed |= DrawJsonValueEditor(childProp.label.c_str(), child, SchemaRegistry::Child(childProp), cache);
+								cache.pop();
+								ImGui::PopID();
 							}
 						}
 						ImGui::Unindent();
 					}
 					else
 					{
-						DrawJsonValueEditor(U"Value", element, nullptr);
+						changed |= DrawJsonValueEditor("Value", element, nullptr, cache);
 					}
 					ImGui::TreePop();
 				}
+
+				cache.pop();
 				ImGui::PopID();
 			}
 
-			if (removeIndex != -1)
+			if (removeIndex)
 			{
-				jsonValue.erase(removeIndex);
+				cache.pushIndex(*removeIndex);
+				cache.assign(none);
+				cache.pop();
+				changed = true;
 			}
 
 			if (ImGui::Button("+ Add"))
 			{
-				if (childSchemaHint)
-				{
-					JSON newObject;
-					// 子スキーマを元に、正しい型のプロパティを追加
-					for (const auto& childPair : *childSchemaHint)
-					{
-						const String& key = childPair.first;
-						const SchemaProperty& prop = childPair.second;
-						switch (prop.type)
-						{
-						case JSONValueType::String: newObject[key] = U""; break;
-						case JSONValueType::Number: newObject[key] = 0; break;
-						case JSONValueType::Bool:   newObject[key] = false; break;
-						case JSONValueType::Array:  newObject[key] = Array<JSON>{}; break;
-						case JSONValueType::Object: newObject[key] = JSON{}; break;
-						default: newObject[key] = JSON(); break;
-						}
-					}
-					jsonValue.push_back(newObject);
-				}
-				else
-				{
-					jsonValue.push_back(JSON());
-				}
+				// 子スキーマがあれば、その雛形（正しい型のプロパティを持つ）を末尾に加える
+				cache.pushIndex(node->elements.size());
+				cache.assign(childSchemaHint ? TemplateService::Create(childSchemaHint->handle) : JSON());
+				cache.pop();
+				changed = true;
 			}
 			ImGui::TreePop();
 		}
@@ -117,39 +218,35 @@ void DrawJsonValueEditor(const String& label, JSON& jsonValue, const std::shared
 	}
 	case JSONValueType::Object:
 	{
-		if (ImGui::TreeNode(label.toUTF8().c_str()))
+		if (ImGui::TreeNode(label))
 		{
-			Array<String> keys;
-			for (const auto& pair : jsonValue)
+			// メンバーのキーは Atom で持っているので、走査しても文字列を作らない
+			for (const auto& [key, child] : node->members)
 			{
-				keys.push_back(pair.key);
-			}
-
-			// 取得したキーのリストを使ってループ
-			for (const auto& key : keys)
-			{
-				JSON valueCopy = jsonValue[key];
+				// ID はキーの番号（メンバーが増減しても、ほかのメンバーの開閉の状態がずれない）
+				ImGui::PushID(static_cast<int>(key.id()));
+				cache.pushKey(key);
 
-				if (childSchemaHint && (childSchemaHint->find(key) != childSchemaHint->end()))
+				if (const SchemaField* prop = (childSchemaHint ? childSchemaHint->findField(key) : nullptr))
 				{
-					const auto& prop = childSchemaHint->at(key);
-					DrawJsonValueEditor(prop.description, valueCopy, prop.childSchema);
+					changed |= DrawJsonValueEditor(prop->label.c_str(), child, SchemaRegistry::Child(*prop), cache);
 				}
 				else
 				{
-					DrawJsonValueEditor(key, valueCopy, nullptr);
+					changed |= DrawJsonValueEditor(cache.getLabel(key), child, nullptr, cache);
 				}
 
-				jsonValue[key] = valueCopy;
+				cache.pop();
+				ImGui::PopID();
 			}
 			ImGui::TreePop();
 		}
 		break;
 	}
 	default:
-		ImGui::Text((label + U" (Unknown Type)").toUTF8().c_str());
+		ImGui::Text("%s (Unknown Type)", label);
 		break;
 	}
 
-	ImGui::PopID();
+	return changed;
 }
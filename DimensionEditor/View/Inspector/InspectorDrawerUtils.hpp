@@ -1,6 +1,66 @@
 ﻿#pragma once
 #include <Siv3D.hpp>
+#include "../../Model/Atom.hpp"
+#include "../../Model/PersistentJson.hpp"
 
-struct Schema;
+struct CompiledSchema;
+class EditorDocument;
 
-void DrawJsonValueEditor(const String& label, JSON& jsonValue, const std::shared_ptr<Schema>& childSchemaHint);
+// インスペクタの編集UIの状態（描画ごとに1つ持ち、フレームをまたいで使い回す）
+// ・値は EditorDocument::getRoot() の木から読む（Siv3D の JSON と違い、子の値を取り出しても確保しない）
+// ・値を変更したら、描画中の位置の値を文書の JSON に書き込み、その位置を記録する（呼び出し側が markSelectedDirty に渡す）
+// ・文字列の値の UTF-8 は入力欄の ID ごとに持ち、文書かその内容が変わったら捨てる
+// ・スキーマにないキーのラベルは Atom ごとに持つ（キーの文字列は変わらないので捨てない）
+class JsonEditorCache
+{
+public:
+	// 描画の前に毎フレーム呼ぶ。値の変更は json（document の内容）に書き込む
+	// 前回と違う文書か、EditorDocument::getRevision() が変わっていれば文字列の値を捨てる
+	void begin(const std::shared_ptr<const EditorDocument>& document, JSON& json);
+
+	// begin() 以降に変更した値の位置（変更がなければ none）。複数の位置を変更した場合は、それらを含む位置
+	[[nodiscard]]
+	Optional<PersistentJson::Path> takeChangedPath();
+
+	// 描画中の値の位置を子のメンバー・要素に進める（子の描画が終わったら pop() で戻す）
+	void pushKey(Atom key);
+
+	void pushIndex(size_t index);
+
+	void pop();
+
+	// 描画中の位置の値を value に置き換え（none なら取り除き）、変更した位置として記録する
+	// 配列の要素数と同じ添字の位置なら、末尾に加える
+	void assign(const Optional<JSON>& value);
+
+	// 入力欄 id に表示する node（文字列）の UTF-8。入力欄はこれを直接書き換えてよい
+	[[nodiscard]]
+	std::string& getText(uint32 id, const PersistentJson::Node& node);
+
+	// キーのラベル（UTF-8）
+	[[nodiscard]]
+	const char* getLabel(Atom key);
+
+private:
+	// 文書を生かしておかないよう弱参照で持つ（別の文書が同じアドレスに作られても区別できる）
+	std::weak_ptr<const EditorDocument> m_document;
+
+	uint64 m_revision = 0;
+
+	JSON* m_json = nullptr;
+
+	// 描画中の値の位置（キーか添字）。Path と違って文字列を持たないので、進めたり戻したりしても確保しない
+	Array<std::variant<Atom, size_t>> m_path;
+
+	Optional<PersistentJson::Path> m_changedPath;
+
+	HashTable<uint32, std::string> m_texts;
+
+	HashTable<Atom, std::string> m_labels;
+};
+
+// node の値をその場で編集するUIを描画する。ユーザーが値を変更した（要素の追加・削除を含む）フレームだけ true を返す
+// ・node は cache の描画中の位置にある値で、変更は cache.assign() で文書の JSON に書き込む
+// ・label は UTF-8 で、表示にだけ使う。呼び出し側は値ごとに整数の ID を PushID しておく（キーの Atom の番号か、配列の添字）
+// ・値の複製やキーの一覧は作らず、変換した文字列は cache から取るので、値を変更しないフレームでは確保をしない
+bool DrawJsonValueEditor(const char* label, const PersistentJson::NodePtr& node, const CompiledSchema* childSchemaHint, JsonEditorCache& cache);
@@ -1,5 +1,6 @@
 ﻿#include "RoomConnectionsDrawer.hpp"
 #include "../../SchemaManager.hpp"
+#include "../../Model/TemplateService.hpp"
 #include "../EditorView.hpp"
 #include "../../Controller/EditorController.hpp"
 
@@ -30,9 +31,9 @@ void RoomConnectionsDrawer::draw(JSON& jsonData, EditorView& editorView, EditorC
 			// 編集ボタン
 			if (ImGui::Button("Edit"))
 			{
-				editorView.m_editingRoomName = roomName;
-				editorView.m_editingRoomDataCopy = roomPair.value;
-				editorView.m_showRoomEditor = true;
+				// 部屋の内容は複製せず、変更だけを持つセッションを開く
+				editorView.m_roomEditSession = controller.beginRoomEdit(roomName);
+				editorView.m_showRoomEditor = editorView.m_roomEditSession.isOpen();
 			}
 			ImGui::SameLine();
 
@@ -50,6 +51,7 @@ void RoomConnectionsDrawer::draw(JSON& jsonData, EditorView& editorView, EditorC
 		if (not roomToDelete.isEmpty())
 		{
 			jsonData[U"rooms"].erase(roomToDelete);
+			controller.markSelectedDirty({ U"rooms", roomToDelete });
 		}
 
 		ImGui::Separator();
@@ -73,28 +75,14 @@ void RoomConnectionsDrawer::draw(JSON& jsonData, EditorView& editorView, EditorC
 			{
 				const String newRoomName = Unicode::FromUTF8(m_newRoomNameBuffer);
 
-				// 新しい部屋のデフォルトデータをスキーマから生成
-				JSON newRoomData;
-				for (const auto& propPair : *g_RoomSchema)
-				{
-					const auto& key = propPair.first;
-					const auto& prop = propPair.second;
-					if (prop.isRequired) // 必須プロパティのみ初期化
-					{
-						switch (prop.type)
-						{
-						case JSONValueType::String: newRoomData[key] = U""; break;
-						case JSONValueType::Object: newRoomData[key] = JSON(); break;
-						case JSONValueType::Array: newRoomData[key] = Array<JSON>(); break;
-						default: break;
-						}
-					}
-				}
+				// 新しい部屋のデフォルトデータをスキーマの雛形から生成（必須プロパティのみ）
+				JSON newRoomData = TemplateService::CreateRequired(SchemaOf(SchemaId::Room).handle);
 				// layoutオブジェクトの必須プロパティも初期化
 				newRoomData[U"layout"][U"forcusable"] = Array<JSON>();
 				newRoomData[U"layout"][U"interactable"] = Array<JSON>(); 
 
 				jsonData[U"rooms"][newRoomName] = newRoomData;
+				controller.markSelectedDirty({ U"rooms", newRoomName });
 				controller.addNewRoom(newRoomName);
 			}
 			ImGui::CloseCurrentPopup();
@@ -1,6 +1,5 @@
 ﻿#include "SchemaDrivenDrawer.hpp"
 #include "../../imgui-s3d-wrapper/imgui/DearImGuiAddon.hpp"
-#include "InspectorDrawerUtils.hpp"
 #include "../EditorView.hpp"
 #include "../../Controller/EditorController.hpp"
 
@@ -19,97 +18,195 @@ namespace
 		default:                    return U"Unknown";
 		}
 	}
+
+	// グリッドのセルの値（配列でない行や、範囲外のセルは 0 とみなす）
+	int GetGridCell(const PersistentJson::Node& grid, const size_t y, const size_t x)
+	{
+		if ((grid.type != JSONValueType::Array) || (grid.elements.size() <= y))
+		{
+			return 0;
+		}
+
+		const PersistentJson::NodePtr& row = grid.elements[y];
+
+		if ((not row) || (row->type != JSONValueType::Array) || (row->elements.size() <= x))
+		{
+			return 0;
+		}
+
+		const PersistentJson::NodePtr& cell = row->elements[x];
+		return (cell ? static_cast<int>(PersistentJson::GetNumber(*cell).value_or(0.0)) : 0);
+	}
+
+	// height 行の配列で、各行が width 個の要素を持つ配列か
+	bool IsRectangularGrid(const PersistentJson::Node& grid, const size_t width, const size_t height)
+	{
+		if ((grid.type != JSONValueType::Array) || (grid.elements.size() != height))
+		{
+			return false;
+		}
+
+		for (const auto& row : grid.elements)
+		{
+			if ((not row) || (row->type != JSONValueType::Array) || (row->elements.size() != width))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// 現在の値を保ったまま、width x height の整ったグリッドを作る
+	Array<Array<int>> ResizeGrid(const PersistentJson::Node& grid, const int width, const int height)
+	{
+		Array<Array<int>> newGrid(height, Array<int>(width, 0));
+
+		for (int y = 0; y < height; ++y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				newGrid[y][x] = GetGridCell(grid, y, x);
+			}
+		}
+
+		return newGrid;
+	}
 }
 
-SchemaDrivenDrawer::SchemaDrivenDrawer(const Schema& schema)
+SchemaDrivenDrawer::SchemaDrivenDrawer(const CompiledSchema& schema)
 	: m_schema(schema)
 {
+	constexpr Atom InitialGrid = Atom::Static(U"initial_grid");
+
+	m_properties.reserve(m_schema.fields.size());
+
+	for (const auto& prop : m_schema.fields)
+	{
+		m_properties.push_back({
+			.field = &prop,
+			.child = SchemaRegistry::Child(prop),
+			.isGrid = (prop.atom == InitialGrid),
+			.missingText = (prop.isRequired ? U"{} [必須プロパティがありません！]"_fmt(prop.description).toUTF8() : std::string{}),
+		});
+	}
 }
 
-void SchemaDrivenDrawer::draw(JSON& jsonData, EditorView& editorView, EditorController& controller, DimensionModel&)
+void SchemaDrivenDrawer::draw(JSON& jsonData, EditorView&, EditorController& controller, DimensionModel&)
 {
-	for (const auto& schemaPair : m_schema)
+	const std::shared_ptr<const EditorDocument> document = controller.getSelectedDocument();
+
+	if (not document)
 	{
-		const String& key = schemaPair.first;
-		const SchemaProperty& prop = schemaPair.second;
+		return;
+	}
 
-		if (jsonData.hasElement(key))
+	// 読むのは文書の変更できない木、書き込むのは文書の JSON（値の複製やキーの文字列は作らない）
+	const PersistentJson::NodePtr root = document->getRoot();
+	m_cache.begin(document, jsonData);
+
+	for (const auto& property : m_properties)
+	{
+		const SchemaField& prop = *property.field;
+
+		if (const PersistentJson::NodePtr value = PersistentJson::GetMember(root, prop.atom))
 		{
-			if (key == U"initial_grid")
+			// ID はキーの番号（ラベルの文字列を ID に使わない）
+			ImGui::PushID(static_cast<int>(prop.atom.id()));
+			m_cache.pushKey(prop.atom);
+
+			if (property.isGrid)
 			{
-				if (key == U"initial_grid")
-				{
-					if (ImGui::TreeNode(prop.description.toUTF8().c_str()))
-					{
-						if (not jsonData[key].isArray())
-						{
-							jsonData[key] = Array<JSON>();
-						}
-
-						int height = static_cast<int>(jsonData[key].size());
-						int width = (height > 0 && jsonData[key][0].isArray()) ? static_cast<int>(jsonData[key][0].size()) : 0;
-
-						int newWidth = width;
-						int newHeight = height;
-
-						ImGui::PushID("GridSize");
-						ImGui::Text("Size:");
-						ImGui::SameLine();
-						ImGui::SetNextItemWidth(80);
-						if (ImGui::InputInt("W", &newWidth)) { newWidth = Clamp(newWidth, 0, 50); }
-						ImGui::SameLine();
-						ImGui::SetNextItemWidth(80);
-						if (ImGui::InputInt("H", &newHeight)) { newHeight = Clamp(newHeight, 0, 50); }
-						ImGui::PopID();
-
-						if (newWidth != width || newHeight != height)
-						{
-							Array<Array<int>> newGrid(newHeight, Array<int>(newWidth, 0));
-							for (int y = 0; y < Min(height, newHeight); ++y)
-							{
-								for (int x = 0; x < Min(width, newWidth); ++x)
-								{
-									newGrid[y][x] = jsonData[key][y][x].getOpt<int>().value_or(0);
-								}
-							}
-							jsonData[key] = newGrid;
-						}
-
-						ImGui::Separator();
-						for (int y = 0; y < newHeight; ++y)
-						{
-							ImGui::PushID(y);
-							for (int x = 0; x < newWidth; ++x)
-							{
-								bool isChecked = (jsonData[key][y][x].getOpt<int>().value_or(0) == 1);
-								std::string cellLabel = "##cell" + ToString(x).narrow();
-								if (ImGui::Checkbox(cellLabel.c_str(), &isChecked))
-								{
-									jsonData[key][y][x] = isChecked ? 1 : 0;
-								}
-								if (x < newWidth - 1)
-								{
-									ImGui::SameLine();
-								}
-							}
-							ImGui::PopID();
-						}
-						ImGui::TreePop();
-					}
-				}
+				drawGrid(property, value);
 			}
 			else
 			{
-				// それ以外のプロパティは、従来通りの汎用エディタを呼び出す
-				JSON valueCopy = jsonData[key];
-				DrawJsonValueEditor(prop.description, valueCopy, prop.childSchema);
-				jsonData[key] = valueCopy;
+				DrawJsonValueEditor(prop.label.c_str(), value, property.child, m_cache);
 			}
+
+			m_cache.pop();
+			ImGui::PopID();
 		}
 		else if (prop.isRequired)
 		{
-			const String errorMsg = (prop.description + U" [必須プロパティがありません！]");
-			ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), errorMsg.toUTF8().c_str());
+			ImGui::TextColored(ImVec4(1.0f, 0.0f, 0.0f, 1.0f), "%s", property.missingText.c_str());
+		}
+	}
+
+	if (const auto path = m_cache.takeChangedPath())
+	{
+		controller.markSelectedDirty(*path);
+	}
+}
+
+void SchemaDrivenDrawer::drawGrid(const PropertyLayout& property, const PersistentJson::NodePtr& grid)
+{
+	const SchemaField& prop = *property.field;
+
+	if (ImGui::TreeNode(prop.label.c_str()))
+	{
+		// 配列でない・行の長さが揃っていないグリッドも、開いただけでは書き換えない（整えるのは編集したときだけ）
+		const int height = ((grid->type == JSONValueType::Array) ? static_cast<int>(grid->elements.size()) : 0);
+		const PersistentJson::NodePtr* firstRow = ((height > 0) ? &grid->elements[0] : nullptr);
+		const int width = ((firstRow && *firstRow && ((*firstRow)->type == JSONValueType::Array)) ? static_cast<int>((*firstRow)->elements.size()) : 0);
+
+		int newWidth = width;
+		int newHeight = height;
+
+		ImGui::PushID("GridSize");
+		ImGui::Text("Size:");
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(80);
+		if (ImGui::InputInt("W", &newWidth)) { newWidth = Clamp(newWidth, 0, 50); }
+		ImGui::SameLine();
+		ImGui::SetNextItemWidth(80);
+		if (ImGui::InputInt("H", &newHeight)) { newHeight = Clamp(newHeight, 0, 50); }
+		ImGui::PopID();
+
+		const bool resized = ((newWidth != width) || (newHeight != height));
+
+		if (resized)
+		{
+			m_cache.assign(JSON(ResizeGrid(*grid, newWidth, newHeight)));
+		}
+
+		ImGui::Separator();
+		for (int y = 0; y < newHeight; ++y)
+		{
+			ImGui::PushID(y);
+			for (int x = 0; x < newWidth; ++x)
+			{
+				bool isChecked = (GetGridCell(*grid, y, x) == 1);
+
+				// セルは添字で区別する（セルごとのラベルの文字列を作らない）
+				ImGui::PushID(x);
+				if (ImGui::Checkbox("##cell", &isChecked))
+				{
+					if (resized || (not IsRectangularGrid(*grid, newWidth, newHeight)))
+					{
+						// 整っていないグリッドは、編集したときに初めて整える
+						Array<Array<int>> newGrid = ResizeGrid(*grid, newWidth, newHeight);
+						newGrid[y][x] = (isChecked ? 1 : 0);
+						m_cache.assign(JSON(newGrid));
+					}
+					else
+					{
+						m_cache.pushIndex(y);
+						m_cache.pushIndex(x);
+						m_cache.assign(JSON(isChecked ? 1 : 0));
+						m_cache.pop();
+						m_cache.pop();
+					}
+				}
+				ImGui::PopID();
+
+				if (x < newWidth - 1)
+				{
+					ImGui::SameLine();
+				}
+			}
+			ImGui::PopID();
 		}
+		ImGui::TreePop();
 	}
 }
@@ -1,12 +1,38 @@
 ﻿#pragma once
 #include "IInspectorDrawer.hpp"
-#include "../../SchemaManager.hpp"
+#include "InspectorDrawerUtils.hpp"
+#include "../../Model/SchemaRegistry.hpp"
 
+// スキーマのプロパティを順に描画する。InspectorDrawerPool がスキーマごとに1つ持ち、選択が変わっても使い回す
 class SchemaDrivenDrawer : public IInspectorDrawer
 {
 public:
-	explicit SchemaDrivenDrawer(const Schema& schema);
+	explicit SchemaDrivenDrawer(const CompiledSchema& schema);
 	void draw(JSON& jsonData, EditorView&, EditorController&, DimensionModel&) override;
 private:
-	const Schema m_schema;
+	// プロパティ1つの描画に必要なもの（構築時に作り、描画ではフレームごとに変換や確保をしない）
+	struct PropertyLayout
+	{
+		// SchemaRegistry の不変の表を参照する（ラベルは SchemaField::label の UTF-8 をそのまま ImGui のラベルと ID に使う）
+		const SchemaField* field = nullptr;
+
+		const CompiledSchema* child = nullptr;
+
+		// 2次元のグリッド（"initial_grid"）として描画するか
+		bool isGrid = false;
+
+		// 必須のプロパティがない場合の表示（UTF-8）
+		std::string missingText;
+	};
+
+	// SchemaRegistry の不変の表を参照する（コピーしない）
+	const CompiledSchema& m_schema;
+
+	// 描画する順のプロパティ
+	Array<PropertyLayout> m_properties;
+
+	JsonEditorCache m_cache;
+
+	// grid は m_cache の描画中の位置にある値
+	void drawGrid(const PropertyLayout& property, const PersistentJson::NodePtr& grid);
 };
@@ -0,0 +1,234 @@
+﻿#include "JsonTextViewer.hpp"
+#include "../imgui-s3d-wrapper/imgui/DearImGuiAddon.hpp"
+#include "../Model/EditorDocument.hpp"
+#include "../Model/JsonStreamWriter.hpp"
+
+namespace
+{
+	size_t GetIndent(const std::string_view line) noexcept
+	{
+		const size_t indent = line.find_first_not_of(' ');
+		return ((indent == std::string_view::npos) ? line.size() : indent);
+	}
+}
+
+void JsonTextViewer::draw(const std::shared_ptr<const EditorDocument>& document)
+{
+	if (not document)
+	{
+		clear();
+		return;
+	}
+
+	if ((document != m_document) || (document->getRevision() != m_revision))
+	{
+		// 同じ文書の編集なら、折りたたみの状態を残す
+		const bool keepFolds = (document == m_document);
+		m_document = document;
+		m_revision = document->getRevision();
+		rebuild(document->getJson(), keepFolds);
+	}
+
+	Optional<uint32> toggledLine;
+
+	if (ImGui::BeginChild("##JsonText", ImVec2(0, 0), false, ImGuiWindowFlags_HorizontalScrollbar))
+	{
+		const bool hasFolds = (not m_folds.isEmpty());
+		const size_t rowCount = (hasFolds ? m_visibleLines.size() : getLineCount());
+
+		// 数十万行でも見えている行だけを描画する
+		ImGuiListClipper clipper;
+		clipper.Begin(static_cast<int>(rowCount));
+
+		while (clipper.Step())
+		{
+			for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; ++row)
+			{
+				const uint32 line = (hasFolds ? m_visibleLines[row] : static_cast<uint32>(row));
+				const std::string_view text = getLine(line);
+				const Fold* fold = (hasFolds ? findFold(line) : nullptr);
+
+				// 折りたたみの印（行の高さが変わらないよう、ボタンではなくテキストにする）
+				if (isOpeningLine(line))
+				{
+					ImGui::TextDisabled(fold ? "+" : "-");
+
+					if (ImGui::IsItemClicked())
+					{
+						toggledLine = line;
+					}
+				}
+				else
+				{
+					ImGui::TextDisabled(" ");
+				}
+
+				ImGui::SameLine();
+				ImGui::TextUnformatted(text.data(), (text.data() + text.size()));
+
+				if (fold)
+				{
+					const std::string_view closing = getLine(fold->end);
+					const std::string_view bracket = closing.substr(GetIndent(closing));
+
+					ImGui::SameLine(0.0f, 0.0f);
+					ImGui::TextDisabled(" ... ");
+					ImGui::SameLine(0.0f, 0.0f);
+					ImGui::TextUnformatted(bracket.data(), (bracket.data() + bracket.size()));
+				}
+			}
+		}
+
+		clipper.End();
+	}
+	ImGui::EndChild();
+
+	if (toggledLine)
+	{
+		toggleFold(*toggledLine);
+	}
+}
+
+void JsonTextViewer::clear()
+{
+	m_document.reset();
+	m_revision = 0;
+	m_text = std::string{};
+	m_lineOffsets = Array<uint32>{};
+	m_folds.clear();
+	m_visibleLines = Array<uint32>{};
+}
+
+void JsonTextViewer::rebuild(const JSON& json, const bool keepFolds)
+{
+	// 前回のバッファを使い回す（同じ文書の編集なら、テキストの大きさはほとんど変わらない）
+	m_text.clear();
+
+	JsonStreamWriter writer{ [this](const std::string_view chunk)
+		{
+			m_text.append(chunk);
+			return true;
+		} };
+
+	writer.write(json);
+
+	m_lineOffsets.clear();
+	m_lineOffsets.push_back(0);
+
+	for (size_t pos = m_text.find('\n'); pos != std::string::npos; pos = m_text.find('\n', (pos + 1)))
+	{
+		m_lineOffsets.push_back(static_cast<uint32>(pos + 1));
+	}
+
+	// 末尾の改行の後ろは行として数えない
+	if ((1 < m_lineOffsets.size()) && (m_lineOffsets.back() == m_text.size()))
+	{
+		m_lineOffsets.pop_back();
+	}
+
+	if (keepFolds)
+	{
+		// 変更で行がずれた折りたたみは、開き括弧の行でなくなったものを捨て、閉じ括弧の行を探し直す
+		m_folds.remove_if([this](const Fold& fold) { return ((getLineCount() <= fold.begin) || (not isOpeningLine(fold.begin))); });
+
+		for (auto& fold : m_folds)
+		{
+			fold.end = findClosingLine(fold.begin);
+		}
+	}
+	else
+	{
+		m_folds.clear();
+	}
+
+	updateVisibleLines();
+}
+
+void JsonTextViewer::updateVisibleLines()
+{
+	m_visibleLines.clear();
+
+	if (m_folds.isEmpty())
+	{
+		return;
+	}
+
+	const uint32 lineCount = static_cast<uint32>(getLineCount());
+	size_t foldIndex = 0;
+
+	for (uint32 line = 0; line < lineCount;)
+	{
+		m_visibleLines.push_back(line);
+
+		// 隠れた行の中の折りたたみは飛ばす
+		while ((foldIndex < m_folds.size()) && (m_folds[foldIndex].begin < line))
+		{
+			++foldIndex;
+		}
+
+		if ((foldIndex < m_folds.size()) && (m_folds[foldIndex].begin == line))
+		{
+			line = (m_folds[foldIndex].end + 1);
+		}
+		else
+		{
+			++line;
+		}
+	}
+}
+
+void JsonTextViewer::toggleFold(const uint32 line)
+{
+	const auto it = std::lower_bound(m_folds.begin(), m_folds.end(), line,
+		[](const Fold& fold, const uint32 value) { return (fold.begin < value); });
+
+	if ((it != m_folds.end()) && (it->begin == line))
+	{
+		m_folds.erase(it);
+	}
+	else
+	{
+		m_folds.insert(it, Fold{ .begin = line, .end = findClosingLine(line) });
+	}
+
+	updateVisibleLines();
+}
+
+std::string_view JsonTextViewer::getLine(const uint32 line) const noexcept
+{
+	const size_t begin = m_lineOffsets[line];
+	const size_t end = (((line + 1) < m_lineOffsets.size()) ? (m_lineOffsets[line + 1] - 1) : m_text.size());
+	return std::string_view{ m_text }.substr(begin, (end - begin));
+}
+
+bool JsonTextViewer::isOpeningLine(const uint32 line) const noexcept
+{
+	const std::string_view text = getLine(line);
+	return ((not text.empty()) && ((text.back() == '{') || (text.back() == '[')));
+}
+
+uint32 JsonTextViewer::findClosingLine(const uint32 line) const noexcept
+{
+	const size_t indent = GetIndent(getLine(line));
+	const uint32 lineCount = static_cast<uint32>(getLineCount());
+
+	for (uint32 i = (line + 1); i < lineCount; ++i)
+	{
+		const std::string_view text = getLine(i);
+
+		if ((GetIndent(text) == indent) && (indent < text.size()) && ((text[indent] == '}') || (text[indent] == ']')))
+		{
+			return i;
+		}
+	}
+
+	return (lineCount - 1);
+}
+
+const JsonTextViewer::Fold* JsonTextViewer::findFold(const uint32 line) const noexcept
+{
+	const auto it = std::lower_bound(m_folds.begin(), m_folds.end(), line,
+		[](const Fold& fold, const uint32 value) { return (fold.begin < value); });
+
+	return (((it != m_folds.end()) && (it->begin == line)) ? &*it : nullptr);
+}
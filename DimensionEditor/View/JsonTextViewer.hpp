@@ -0,0 +1,67 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+
+class EditorDocument;
+
+// 整形した JSON を行ごとに表示する（Canvas パネル）
+// ・整形したテキストと行の位置は、表示する文書かその内容が変わったときだけ作り直す
+// ・ImGuiListClipper で見えている行だけを描画するので、フレームごとのコストは文書の大きさによらない
+// ・オブジェクトと配列は折りたためる。対応する閉じ括弧の行は、折りたたむときに初めて探す
+class JsonTextViewer
+{
+public:
+	// document の内容を描画する（nullptr なら何も描画せず、キャッシュを捨てる）
+	void draw(const std::shared_ptr<const EditorDocument>& document);
+
+	// キャッシュした文書とテキストを捨てる
+	void clear();
+
+private:
+	// 折りたたんでいる範囲（開き括弧の行と、対応する閉じ括弧の行）
+	struct Fold
+	{
+		uint32 begin = 0;
+
+		uint32 end = 0;
+	};
+
+	// キャッシュしている文書（参照を持つので、同じアドレスに別の文書が作られることはない）
+	std::shared_ptr<const EditorDocument> m_document;
+
+	uint64 m_revision = 0;
+
+	// JsonStreamWriter で整形した UTF-8 のテキスト
+	std::string m_text;
+
+	// 各行の先頭の位置
+	Array<uint32> m_lineOffsets;
+
+	// begin の順
+	Array<Fold> m_folds;
+
+	// 折りたたみがあるときに表示する行（折りたたみがなければ使わず、すべての行を表示する）
+	Array<uint32> m_visibleLines;
+
+	void rebuild(const JSON& json, bool keepFolds);
+
+	void updateVisibleLines();
+
+	void toggleFold(uint32 line);
+
+	[[nodiscard]]
+	size_t getLineCount() const noexcept { return m_lineOffsets.size(); }
+
+	[[nodiscard]]
+	std::string_view getLine(uint32 line) const noexcept;
+
+	// オブジェクトか配列を開く行か（整形したテキストでは、行末が '{' か '['）
+	[[nodiscard]]
+	bool isOpeningLine(uint32 line) const noexcept;
+
+	// 開き括弧の行に対応する閉じ括弧の行（インデントが同じ次の '}' か ']' の行）
+	[[nodiscard]]
+	uint32 findClosingLine(uint32 line) const noexcept;
+
+	[[nodiscard]]
+	const Fold* findFold(uint32 line) const noexcept;
+};
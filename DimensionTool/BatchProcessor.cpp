@@ -0,0 +1,278 @@
+﻿#include <cstring>
+#include <filesystem>
+#include "BatchProcessor.hpp"
+#include "../DimensionEditor/Model/DimensionLoader.hpp"
+#include "../DimensionEditor/Model/FileSync.hpp"
+#include "../DimensionEditor/Model/JsonStreamWriter.hpp"
+#include "../DimensionEditor/Controller/EditorDrafts.hpp"
+
+namespace
+{
+	// エディタのアクション編集で、内容を失わずに読み書きできないアクションを報告する
+	// （下書きに変換して組み立て直し、元と一致するかを見る）
+	void CheckActions(const JSON& json, const String& path, Array<SchemaProblem>& problems)
+	{
+		if (json.isObject())
+		{
+			for (const auto& item : json)
+			{
+				const String childPath = (path.isEmpty() ? item.key : (path + U'/' + item.key));
+
+				if ((item.key == U"action") && item.value.isObject())
+				{
+					ActionDraft draft;
+					EditorDrafts::BuildDraftFromActionJson(draft, item.value);
+
+					if (EditorDrafts::BuildActionJson(draft) != item.value)
+					{
+						problems.push_back({ .severity = SchemaProblem::Severity::Warning, .path = childPath,
+							.message = U"action cannot be edited in the editor without losing data" });
+					}
+
+					continue;
+				}
+
+				CheckActions(item.value, childPath, problems);
+			}
+		}
+		else if (json.isArray())
+		{
+			size_t index = 0;
+
+			for (const auto& element : json.arrayView())
+			{
+				CheckActions(element, (path + U'/' + Format(index++)), problems);
+			}
+		}
+	}
+
+	// 一時ファイルに書き、ディスクへ書き出してから置き換える（SaveQueue と同じ手順）
+	String WriteFile(const FilePath& path, const std::string& bytes)
+	{
+		const FilePath tempPath = path + U".saving";
+		{
+			BinaryWriter writer{ tempPath };
+
+			if (not writer)
+			{
+				return (U"Failed to open " + tempPath);
+			}
+
+			if (writer.write(bytes.data(), static_cast<int64>(bytes.size())) != static_cast<int64>(bytes.size()))
+			{
+				writer.close();
+				FileSystem::Remove(tempPath);
+				return (U"Failed to write " + tempPath);
+			}
+
+			writer.flush();
+		}
+
+		// リネームする前に内容をディスクへ書き出す（途中で落ちても中身のないファイルが残らないようにする）
+		if (not SyncFile(tempPath))
+		{
+			FileSystem::Remove(tempPath);
+			return (U"Failed to flush " + tempPath);
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(std::filesystem::path{ tempPath.str() }, std::filesystem::path{ path.str() }, ec);
+
+		if (ec)
+		{
+			FileSystem::Remove(tempPath);
+			return Unicode::FromUTF8(ec.message());
+		}
+
+		return{};
+	}
+
+	BatchProcessor::FileReport ProcessFile(const FilePath& path, const BatchProcessor::Options& options)
+	{
+		using BatchProcessor::Command;
+
+		BatchProcessor::FileReport report{ .path = path };
+		const Stopwatch total{ StartImmediately::Yes };
+
+		const Blob blob{ path };
+		report.bytes = blob.size();
+
+		const Stopwatch parse{ StartImmediately::Yes };
+		JSON json = JSON::Load(MemoryViewReader{ blob.data(), blob.size() });
+		report.parseMillisec = parse.msF();
+
+		if (not json)
+		{
+			report.error = (blob.isEmpty() ? U"Failed to read the file" : U"Failed to parse JSON");
+			report.totalMillisec = total.msF();
+			return report;
+		}
+
+		// スキーマはファイル名（拡張子なし）で決まる（エディタのインスペクタと同じ）
+		const String schemaName = FileSystem::BaseName(path);
+
+		const Stopwatch validate{ StartImmediately::Yes };
+		if (options.command == Command::Normalize)
+		{
+			report.filledCount = SchemaValidator::NormalizeDocument(schemaName, json);
+		}
+		report.problems = SchemaValidator::ValidateDocument(schemaName, json);
+		CheckActions(json, U"", report.problems);
+		report.validateMillisec = validate.msF();
+
+		if (options.command == Command::Validate)
+		{
+			report.totalMillisec = total.msF();
+			return report;
+		}
+
+		const Stopwatch write{ StartImmediately::Yes };
+		{
+			std::string bytes;
+			bytes.reserve(blob.size());
+
+			JsonStreamWriter writer{ [&bytes](std::string_view chunk)
+				{
+					bytes.append(chunk);
+					return true;
+				} };
+			writer.write(json);
+
+			// 保存される形式と同じなら書き込まない（更新日時も変えない）
+			report.changed = ((bytes.size() != blob.size())
+				|| (std::memcmp(bytes.data(), blob.data(), bytes.size()) != 0));
+
+			if (report.changed && (not options.dryRun))
+			{
+				report.error = WriteFile(path, bytes);
+				report.written = report.error.isEmpty();
+			}
+		}
+		report.writeMillisec = write.msF();
+
+		report.totalMillisec = total.msF();
+		return report;
+	}
+}
+
+namespace BatchProcessor
+{
+	size_t FileReport::countProblems(const SchemaProblem::Severity severity) const
+	{
+		return problems.count_if([severity](const SchemaProblem& problem) { return (problem.severity == severity); });
+	}
+
+	Array<FilePath> FindDimensions(const Array<FilePath>& roots)
+	{
+		Array<FilePath> dimensions;
+
+		for (const auto& root : roots)
+		{
+			if (FileSystem::IsFile(FileSystem::PathAppend(root, U"room_connections.json")))
+			{
+				dimensions.push_back(FileSystem::FullPath(root));
+				continue;
+			}
+
+			for (const auto& path : FileSystem::DirectoryContents(root, Recursive::Yes))
+			{
+				if (FileSystem::FileName(path) == U"room_connections.json")
+				{
+					dimensions.push_back(FileSystem::ParentPath(path));
+				}
+			}
+		}
+
+		for (auto& dimension : dimensions)
+		{
+			if (dimension.ends_with(U'/'))
+			{
+				dimension.pop_back();
+			}
+		}
+
+		return dimensions.sort().unique_consecutive();
+	}
+
+	Array<FilePath> CollectFiles(const FilePath& dimensionPath)
+	{
+		Array<FilePath> files;
+
+		const FilePath connectionsPath = FileSystem::PathAppend(dimensionPath, U"room_connections.json");
+
+		if (FileSystem::IsFile(connectionsPath))
+		{
+			files.push_back(connectionsPath);
+		}
+
+		for (const auto& room : DimensionLoader::LoadRooms(dimensionPath))
+		{
+			const FilePath roomPath = FileSystem::PathAppend(dimensionPath, room.name);
+
+			for (const auto& object : room.objects)
+			{
+				files.push_back(FileSystem::PathAppend(roomPath, object.fileName));
+			}
+		}
+
+		return files;
+	}
+
+	Array<FileReport> Run(const Array<FilePath>& files, const Options& options, Summary& summary)
+	{
+		size_t workerCount = options.jobCount;
+
+		if (workerCount == 0)
+		{
+			workerCount = Max<size_t>(Threading::GetConcurrency(), 1);
+		}
+		workerCount = Max<size_t>(Min(workerCount, files.size()), 1);
+
+		const Stopwatch wall{ StartImmediately::Yes };
+
+		// 結果はファイルのインデックスに直接書き込むので、スレッドの実行順に関係なく順序が決まる
+		Array<FileReport> reports(files.size());
+		std::atomic<size_t> nextIndex{ 0 };
+
+		const auto worker = [&]()
+			{
+				for (size_t i = nextIndex++; i < files.size(); i = nextIndex++)
+				{
+					reports[i] = ProcessFile(files[i], options);
+				}
+			};
+
+		if (workerCount <= 1)
+		{
+			worker();
+		}
+		else
+		{
+			Array<AsyncTask<void>> tasks;
+			for (size_t i = 0; i < workerCount; ++i)
+			{
+				tasks.push_back(Async(worker));
+			}
+
+			for (auto& task : tasks)
+			{
+				task.get();
+			}
+		}
+
+		summary = Summary{ .fileCount = files.size(), .jobCount = workerCount, .wallMillisec = wall.msF() };
+
+		for (const auto& report : reports)
+		{
+			summary.failedFileCount += (report.hasFailed() ? 1 : 0);
+			summary.changedFileCount += (report.changed ? 1 : 0);
+			summary.writtenFileCount += (report.written ? 1 : 0);
+			summary.errorCount += report.countProblems(SchemaProblem::Severity::Error);
+			summary.warningCount += report.countProblems(SchemaProblem::Severity::Warning);
+			summary.totalBytes += report.bytes;
+			summary.busyMillisec += report.totalMillisec;
+		}
+
+		return reports;
+	}
+}
@@ -0,0 +1,106 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+#include "../DimensionEditor/Model/SchemaValidator.hpp"
+
+// 次元フォルダ内の JSON ファイルを、ワーカースレッドで並列に検証・正規化・整形する
+namespace BatchProcessor
+{
+	enum class Command
+	{
+		// スキーマで検証する（ファイルは書き換えない）
+		Validate,
+
+		// 検証し、欠けている必須プロパティを補って整形し直す
+		Normalize,
+
+		// 検証し、内容はそのままで整形し直す（エディタが保存するのと同じ形式）
+		Reformat,
+	};
+
+	struct Options
+	{
+		Command command = Command::Validate;
+
+		// ワーカースレッドの数（0 の場合は論理コア数）
+		size_t jobCount = 0;
+
+		// 書き換えが必要なファイルを報告するだけで、書き込まない
+		bool dryRun = false;
+	};
+
+	// 1ファイルの処理結果
+	struct FileReport
+	{
+		FilePath path;
+
+		// 元のファイルのサイズ
+		uint64 bytes = 0;
+
+		// 読み込み・パース・書き込みの失敗（成功した場合は空）
+		String error;
+
+		Array<SchemaProblem> problems;
+
+		// 補った必須プロパティの数
+		size_t filledCount = 0;
+
+		// 内容または書式が保存される形式と異なっていた
+		bool changed = false;
+
+		// 書き直した
+		bool written = false;
+
+		// 各段階の所要時間（ミリ秒）
+		double parseMillisec = 0.0;
+
+		double validateMillisec = 0.0;
+
+		double writeMillisec = 0.0;
+
+		double totalMillisec = 0.0;
+
+		[[nodiscard]]
+		size_t countProblems(SchemaProblem::Severity severity) const;
+
+		// 失敗（エラーのある）ファイルなら true
+		[[nodiscard]]
+		bool hasFailed() const { return ((not error.isEmpty()) || (0 < countProblems(SchemaProblem::Severity::Error))); }
+	};
+
+	struct Summary
+	{
+		size_t fileCount = 0;
+
+		size_t failedFileCount = 0;
+
+		size_t changedFileCount = 0;
+
+		size_t writtenFileCount = 0;
+
+		size_t errorCount = 0;
+
+		size_t warningCount = 0;
+
+		uint64 totalBytes = 0;
+
+		size_t jobCount = 0;
+
+		// 全体の経過時間
+		double wallMillisec = 0.0;
+
+		// ファイルごとの所要時間の合計（wallMillisec との比が、並列化による短縮の目安）
+		double busyMillisec = 0.0;
+	};
+
+	// roots の下にある次元フォルダ（room_connections.json を持つフォルダ）を、パスの順に列挙する
+	[[nodiscard]]
+	Array<FilePath> FindDimensions(const Array<FilePath>& roots);
+
+	// 次元フォルダ内の処理対象のファイル（room_connections.json と各部屋のオブジェクト）
+	[[nodiscard]]
+	Array<FilePath> CollectFiles(const FilePath& dimensionPath);
+
+	// files を並列に処理する。結果は files と同じ順序で返す
+	[[nodiscard]]
+	Array<FileReport> Run(const Array<FilePath>& files, const Options& options, Summary& summary);
+}
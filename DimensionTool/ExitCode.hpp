@@ -0,0 +1,23 @@
+﻿#pragma once
+#include <Siv3D.hpp>
+
+// プロセスの終了コード
+// Main() は値を返せないので、Main() から戻ってエンジンの終了処理がすべて終わった後（静的オブジェクトの破棄）で終了コードを返す
+// 使う翻訳単位で静的に1つだけ持つ
+class ExitCode
+{
+public:
+	void set(const int32 code) noexcept { m_code = code; }
+
+	~ExitCode()
+	{
+		if (m_code != 0)
+		{
+			std::fflush(stdout);
+			std::_Exit(m_code);
+		}
+	}
+
+private:
+	int32 m_code = 0;
+};
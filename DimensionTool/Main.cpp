@@ -0,0 +1,297 @@
+﻿#include <Siv3D.hpp>
+#include "BatchProcessor.hpp"
+#include "ExitCode.hpp"
+#include "../DimensionEditor/Benchmark/Benchmark.hpp"
+#include "../DimensionEditor/Model/JsonStreamWriter.hpp"
+
+// ウィンドウを作らずに動かす（ディスプレイのないビルドサーバーで使う）
+SIV3D_SET(EngineOption::Renderer::Headless)
+
+namespace
+{
+	ExitCode g_exitCode;
+
+	void PrintUsage()
+	{
+		Console << U"Usage: DimensionTool <validate|normalize|reformat> [--jobs N] [--dry-run] [--quiet] <path>...";
+		Console << U"  <path>     a dimension folder, or a folder searched recursively for dimensions";
+		Console << U"  --jobs N   number of worker threads (default: logical core count)";
+		Console << U"  --dry-run  report files that would be rewritten without writing them";
+		Console << U"  --quiet    print only files with problems or changes, and the summary";
+		Console << U"";
+		Console << U"       DimensionTool bench [--rooms N] [--focusables N] [--hotspots N] [--action-depth N] [--action-width N]";
+		Console << U"                           [--iterations N] [--work-dir DIR] [--output FILE]";
+		Console << U"  generates a synthetic dimension in DIR and writes the timings to FILE as JSON";
+		Console << U"  (defaults: 16 rooms, 8 focusables, 4 hotspots, depth 3, width 3, 5 iterations, benchmark.json)";
+	}
+
+	Optional<BatchProcessor::Command> ParseCommand(const String& name)
+	{
+		if (name == U"validate")
+		{
+			return BatchProcessor::Command::Validate;
+		}
+		else if (name == U"normalize")
+		{
+			return BatchProcessor::Command::Normalize;
+		}
+		else if (name == U"reformat")
+		{
+			return BatchProcessor::Command::Reformat;
+		}
+
+		return none;
+	}
+
+	StringView SeverityName(const SchemaProblem::Severity severity)
+	{
+		return ((severity == SchemaProblem::Severity::Error) ? U"error" : U"warning");
+	}
+
+	void PrintReport(const BatchProcessor::FileReport& report, const BatchProcessor::Options& options)
+	{
+		StringView status = U"ok";
+
+		if (report.hasFailed())
+		{
+			status = U"FAILED";
+		}
+		else if (report.written)
+		{
+			status = U"written";
+		}
+		else if (report.changed)
+		{
+			status = (options.dryRun ? U"would write" : U"changed");
+		}
+
+		Console << U"[{}] {:.2f} ms (parse {:.2f}, validate {:.2f}, write {:.2f}) {} bytes  {}"_fmt(
+			status, report.totalMillisec, report.parseMillisec, report.validateMillisec, report.writeMillisec, report.bytes, report.path);
+
+		if (not report.error.isEmpty())
+		{
+			Console << U"    error: " << report.error;
+		}
+
+		if (0 < report.filledCount)
+		{
+			Console << U"    filled {} missing required propert{}"_fmt(report.filledCount, ((report.filledCount == 1) ? U"y" : U"ies"));
+		}
+
+		for (const auto& problem : report.problems)
+		{
+			Console << U"    {}: {}: {}"_fmt(SeverityName(problem.severity), (problem.path.isEmpty() ? U"(root)" : problem.path), problem.message);
+		}
+	}
+
+	// "--name N" 形式の数値の引数を読む（値がなければ none）
+	Optional<size_t> ParseCount(const Array<String>& args, size_t& i)
+	{
+		if ((i + 1) < args.size())
+		{
+			if (const auto value = ParseIntOpt<uint32>(args[++i]))
+			{
+				return *value;
+			}
+		}
+
+		return none;
+	}
+
+	// validate / normalize / reformat を実行し、終了コードを返す
+	int32 RunBatch(const BatchProcessor::Command command, const Array<String>& args)
+	{
+		BatchProcessor::Options options{ .command = command };
+		bool quiet = false;
+		Array<FilePath> roots;
+
+		for (size_t i = 1; i < args.size(); ++i)
+		{
+			if (args[i] == U"--jobs")
+			{
+				const auto jobCount = ParseCount(args, i);
+
+				if (not jobCount)
+				{
+					PrintUsage();
+					return 2;
+				}
+
+				options.jobCount = *jobCount;
+			}
+			else if (args[i] == U"--dry-run")
+			{
+				options.dryRun = true;
+			}
+			else if (args[i] == U"--quiet")
+			{
+				quiet = true;
+			}
+			else
+			{
+				roots.push_back(args[i]);
+			}
+		}
+
+		if (roots.isEmpty())
+		{
+			PrintUsage();
+			return 2;
+		}
+
+		const Array<FilePath> dimensions = BatchProcessor::FindDimensions(roots);
+
+		Array<FilePath> files;
+
+		for (const auto& dimension : dimensions)
+		{
+			files.append(BatchProcessor::CollectFiles(dimension));
+		}
+
+		BatchProcessor::Summary summary;
+		const Array<BatchProcessor::FileReport> reports = BatchProcessor::Run(files, options, summary);
+
+		for (const auto& report : reports)
+		{
+			if ((not quiet) || report.hasFailed() || report.changed || (not report.problems.isEmpty()))
+			{
+				PrintReport(report, options);
+			}
+		}
+
+		const double seconds = Max(summary.wallMillisec / 1000.0, 1e-9);
+
+		Console << U"----";
+		Console << U"{} dimensions, {} files, {} bytes"_fmt(dimensions.size(), summary.fileCount, summary.totalBytes);
+		Console << U"{} failed, {} errors, {} warnings, {} changed, {} written"_fmt(
+			summary.failedFileCount, summary.errorCount, summary.warningCount, summary.changedFileCount, summary.writtenFileCount);
+		Console << U"{:.1f} ms with {} jobs: {:.1f} files/s, {:.2f} MB/s (busy {:.1f} ms, x{:.2f} parallel speedup)"_fmt(
+			summary.wallMillisec, summary.jobCount, (summary.fileCount / seconds), (summary.totalBytes / seconds / (1024.0 * 1024.0)),
+			summary.busyMillisec, (summary.busyMillisec / Max(summary.wallMillisec, 1e-9)));
+
+		return ((0 < summary.failedFileCount) ? 1 : 0);
+	}
+
+	// 合成した次元でベンチマークを実行し、終了コードを返す
+	int32 RunBench(const Array<String>& args)
+	{
+		SyntheticDimension::Options options;
+		size_t iterations = 5;
+		FilePath workDirectory = FileSystem::PathAppend(FileSystem::TemporaryDirectoryPath(), U"DimensionToolBench");
+		FilePath outputPath = U"benchmark.json";
+
+		for (size_t i = 1; i < args.size(); ++i)
+		{
+			const String& name = args[i];
+
+			if ((name == U"--work-dir") || (name == U"--output"))
+			{
+				if ((i + 1) >= args.size())
+				{
+					PrintUsage();
+					return 2;
+				}
+
+				if (name == U"--work-dir")
+				{
+					workDirectory = args[++i];
+				}
+				else
+				{
+					outputPath = args[++i];
+				}
+
+				continue;
+			}
+
+			const Optional<size_t> count = ParseCount(args, i);
+
+			if (not count)
+			{
+				PrintUsage();
+				return 2;
+			}
+
+			if (name == U"--rooms")
+			{
+				options.roomCount = Max<size_t>(*count, 1);
+			}
+			else if (name == U"--focusables")
+			{
+				options.focusablesPerRoom = *count;
+			}
+			else if (name == U"--hotspots")
+			{
+				options.hotspotsPerObject = *count;
+			}
+			else if (name == U"--action-depth")
+			{
+				options.actionDepth = *count;
+			}
+			else if (name == U"--action-width")
+			{
+				options.actionWidth = *count;
+			}
+			else if (name == U"--iterations")
+			{
+				iterations = Max<size_t>(*count, 1);
+			}
+			else
+			{
+				PrintUsage();
+				return 2;
+			}
+		}
+
+		const Array<Benchmark::BenchmarkResult> results = Benchmark::RunSuite(workDirectory, options, iterations);
+
+		if (results.isEmpty())
+		{
+			Console << U"error: failed to generate a synthetic dimension in " << workDirectory;
+			return 1;
+		}
+
+		for (const auto& result : results)
+		{
+			Console << U"{:<34} median {:>10.3f} ms  min {:>10.3f} ms  max {:>10.3f} ms  ({} ops, {:.3f} us/op)"_fmt(
+				result.name, result.medianMs, result.minMs, result.maxMs, result.operationCount,
+				(result.medianMs * 1000.0 / Max<size_t>(result.operationCount, 1)));
+		}
+
+		if (not JsonStreamWriter::Save(Benchmark::ToJSON(results, options, iterations), outputPath))
+		{
+			Console << U"error: failed to write " << outputPath;
+			return 1;
+		}
+
+		Console << U"results written to " << FileSystem::FullPath(outputPath);
+		return 0;
+	}
+}
+
+void Main()
+{
+	const Array<String> args = System::GetCommandLineArgs().slice(1);
+
+	int32 exitCode = 2;
+
+	if (args.isEmpty())
+	{
+		PrintUsage();
+	}
+	else if (args[0] == U"bench")
+	{
+		exitCode = RunBench(args);
+	}
+	else if (const auto command = ParseCommand(args[0]))
+	{
+		exitCode = RunBatch(*command, args);
+	}
+	else
+	{
+		PrintUsage();
+	}
+
+	// ビルドパイプラインで失敗を検出できるよう、エラーがあれば 0 以外で終了する
+	g_exitCode.set(exitCode);
+}
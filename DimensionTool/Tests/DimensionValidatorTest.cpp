@@ -0,0 +1,97 @@
+﻿#include <Siv3D.hpp>
+#include "../ExitCode.hpp"
+#include "../../DimensionEditor/Model/DimensionValidator.hpp"
+#include "../../DimensionEditor/Model/EditorDocument.hpp"
+
+// DimensionValidator と EditorDocument を組み合わせた検証の流れのテスト（ctest から実行する）
+SIV3D_SET(EngineOption::Renderer::Headless)
+
+namespace
+{
+	ExitCode g_exitCode;
+
+	size_t g_failureCount = 0;
+
+	void Check(const bool condition, const StringView description)
+	{
+		Console << (condition ? U"[ OK ] " : U"[FAIL] ") << description;
+
+		if (not condition)
+		{
+			++g_failureCount;
+		}
+	}
+
+	// 実行中の検証が終わり、取り込むまで待つ
+	void WaitForValidation(DimensionValidator& validator)
+	{
+		do
+		{
+			validator.update();
+			System::Sleep(1);
+		} while (validator.isRunning());
+	}
+
+	bool WriteText(const FilePath& path, const StringView text)
+	{
+		TextWriter writer{ path, TextEncoding::UTF8_NoBOM };
+
+		if (not writer)
+		{
+			return false;
+		}
+
+		writer.write(text);
+		return true;
+	}
+
+	// 編集して元に戻した文書は、保存しても書き込まれない（保存の結果も届かない）
+	// その後にディスク上で変更されたら、問題の一覧はディスク上の内容を反映する
+	void TestSkippedSaveReleasesDocument(const FilePath& directory)
+	{
+		const FilePath path = FileSystem::PathAppend(directory, U"room_connections.json");
+		Check(WriteText(path, UR"({ "rooms": {} })"), U"write the initial document");
+
+		DimensionValidator validator;
+		validator.open([](const FilePath& documentPath) { return JSON::Load(documentPath); }, { path });
+		WaitForValidation(validator);
+		Check(validator.getErrorCount() == 0, U"the initial document has no errors");
+
+		EditorDocument document{ path, JSON::Load(path) };
+
+		// 編集中は、メモリ上の内容で検証する
+		document.getJson().erase(U"rooms");
+		document.markModified({ U"rooms" });
+		validator.validateDocument(path, document.getJson(), document.getRevision());
+		WaitForValidation(validator);
+		Check(validator.getErrorCount() == 1, U"the edited document reports the missing rooms");
+
+		Check(document.undo(), U"undo the edit");
+		validator.validateDocument(path, document.getJson(), document.getRevision());
+		WaitForValidation(validator);
+		Check(validator.getErrorCount() == 0, U"the reverted document has no errors");
+
+		// EditorController::saveDocument と同じく、書き込みを省いたら検証をディスク上の内容に戻す
+		Check((not document.commitForSave()), U"the reverted document is not written");
+		validator.releaseDocument(path);
+		WaitForValidation(validator);
+
+		Check(WriteText(path, U"{}"), U"change the document on disk");
+		validator.invalidate(path);
+		WaitForValidation(validator);
+		Check(validator.getErrorCount() == 1, U"the change on disk is reported");
+	}
+}
+
+void Main()
+{
+	const FilePath directory = FileSystem::PathAppend(FileSystem::TemporaryDirectoryPath(), U"DimensionValidatorTest_{}"_fmt(Time::GetMillisecSinceEpoch()));
+	FileSystem::CreateDirectories(directory);
+
+	TestSkippedSaveReleasesDocument(directory);
+
+	FileSystem::Remove(directory);
+
+	Console << U"{} failure(s)"_fmt(g_failureCount);
+	g_exitCode.set((0 < g_failureCount) ? 1 : 0);
+}
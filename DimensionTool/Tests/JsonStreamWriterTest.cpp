@@ -0,0 +1,77 @@
+﻿#include <Siv3D.hpp>
+#include "../ExitCode.hpp"
+#include "../../DimensionEditor/Model/JsonStreamWriter.hpp"
+
+// JsonStreamWriter の出力が JSON::save と1バイトも違わないことのテスト（ctest から実行する）
+// エスケープ、非 ASCII の文字列、浮動小数点数、空のコンテナ、入れ子を、ファイルへの保存と小さなバッファでの書き出しの両方で比べる
+SIV3D_SET(EngineOption::Renderer::Headless)
+
+namespace
+{
+	ExitCode g_exitCode;
+
+	size_t g_failureCount = 0;
+
+	void Check(const bool condition, const StringView description)
+	{
+		Console << (condition ? U"[ OK ] " : U"[FAIL] ") << description;
+
+		if (not condition)
+		{
+			++g_failureCount;
+		}
+	}
+
+	std::string ReadAll(const FilePath& path)
+	{
+		BinaryReader reader{ path };
+		std::string bytes(static_cast<size_t>(reader.size()), '\0');
+		reader.read(bytes.data(), static_cast<int64>(bytes.size()));
+		return bytes;
+	}
+
+	// 小さなバッファでも、途中で出力先に渡しながら同じ内容を書き出す
+	std::string WriteToString(const JSON& json, const size_t bufferSize)
+	{
+		std::string output;
+		JsonStreamWriter writer{ [&output](const std::string_view s) { output.append(s); return true; }, bufferSize };
+		writer.write(json);
+		return output;
+	}
+
+	void CheckSameAsSave(const FilePath& directory, const JSON& json, const StringView description)
+	{
+		const FilePath savePath = FileSystem::PathAppend(directory, U"JSON_save.json");
+		const FilePath streamPath = FileSystem::PathAppend(directory, U"JsonStreamWriter.json");
+
+		json.save(savePath);
+		const std::string expected = ReadAll(savePath);
+
+		Check(JsonStreamWriter::Save(json, streamPath) && (ReadAll(streamPath) == expected), (U"Save: " + description));
+		Check((WriteToString(json, JsonStreamWriter::DefaultBufferSize) == expected), (U"write: " + description));
+		Check((WriteToString(json, 7) == expected), (U"write with a 7-byte buffer: " + description));
+
+		FileSystem::Remove(savePath);
+		FileSystem::Remove(streamPath);
+	}
+}
+
+void Main()
+{
+	const FilePath directory = FileSystem::PathAppend(FileSystem::TemporaryDirectoryPath(), U"JsonStreamWriterTest_{}"_fmt(Time::GetMillisecSinceEpoch()));
+	FileSystem::CreateDirectories(directory);
+
+	CheckSameAsSave(directory, JSON::Parse(UR"({ "text": "quote \" backslash \\ slash / newline \n tab \t return \r backspace \b formfeed \f control \u0001 \u001f del \u007f" })"), U"escapes");
+	CheckSameAsSave(directory, JSON::Parse(UR"({ "日本語のキー": "ひらがな、漢字、絵文字 😀", "mixed": "aé中😀z" })"), U"non-ASCII text");
+	CheckSameAsSave(directory, JSON::Parse(UR"({ "values": [0.1, 1.5, 3.0, -2.25, 1e300, 1.5e-7, -0.0, 123456789.125, 2.220446049250313e-16] })"), U"doubles");
+	CheckSameAsSave(directory, JSON::Parse(UR"({ "values": [0, -1, 2147483648, -9223372036854775808, 9223372036854775807, 18446744073709551615] })"), U"integers");
+	CheckSameAsSave(directory, JSON::Parse(UR"({ "object": {}, "array": [], "nested": [[], {}, [[]]], "null": null, "true": true, "false": false })"), U"empty containers and literals");
+	CheckSameAsSave(directory, JSON::Parse(UR"({ "b": { "z": [1, { "y": [2, [3, { "x": "deep" }]] }], "a": {} }, "a": [{ "k": [] }, "v"] })"), U"nesting and key order");
+	CheckSameAsSave(directory, JSON::Parse(UR"([])"), U"empty root array");
+	CheckSameAsSave(directory, JSON::Parse(UR"({})"), U"empty root object");
+
+	FileSystem::Remove(directory);
+
+	Console << U"{} failure(s)"_fmt(g_failureCount);
+	g_exitCode.set((0 < g_failureCount) ? 1 : 0);
+}